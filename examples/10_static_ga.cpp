@@ -0,0 +1,79 @@
+/* Example showing the usage of the StaticGA, where the genetic operators are specified as template parameters. */
+
+#include "../src/static_ga.h"           /* For the statically configured genetic algorithm class. */
+#include "../src/real_ga.h"             /* For the genetic operators of the RCGA. */
+#include "../test/fitness_functions.h"  /* For the fitness function that will be used. */
+
+#include <cstdio>
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace genetic_algorithm;
+
+int main()
+{
+    /*
+    * The StaticGA takes the encoding, selection, crossover, mutation and fitness functions as template parameters,
+    * instead of selecting them at runtime. This allows the compiler to inline them into the main loop of the algorithm.
+    * In this example, the problem is the same as in the rcga example (the Rastrigin function in 10 dimensions).
+    */
+    size_t num_vars = 10;
+    Rastrigin rastriginFunction(num_vars);
+
+    vector<pair<double, double>> limits(num_vars, { rastriginFunction.lbound(), rastriginFunction.ubound() });
+
+    /*
+    * The operators of the runtime GAs can be used as the policies of the StaticGA, but any other
+    * callable with the right signature can be used too (the crossover and mutation operators also receive the
+    * crossover and mutation rates set for the GA).
+    */
+    using Candidate = RCGA::Candidate;
+
+    auto crossover = [limits](const Candidate& parent1, const Candidate& parent2, double pc)
+    {
+        return RCGA::simulatedBinaryCrossover(parent1, parent2, pc, 4.0, limits);
+    };
+
+    auto mutation = [limits](Candidate& child, double pm)
+    {
+        RCGA::gaussMutate(child, pm, 2.0, limits);
+    };
+
+    /* Create the GA. The template parameters are deduced from the arguments of the constructor. */
+    StaticGA GA(num_vars, policy::RealEncoding{ limits }, policy::TournamentSelection{ 2 }, crossover, mutation, rastriginFunction);
+
+    /* The rest of the parameters are set the same way as for the other GAs. */
+    GA.population_size(100);
+    GA.crossover_rate(0.6);
+    GA.mutation_rate(0.05);
+    GA.max_gen(1000);
+
+    GA.stop_condition(RCGA::StopCondition::fitness_value);
+    GA.fitness_threshold({ -0.005 });
+
+
+    /* Run the GA. */
+    auto sols = GA.run();
+
+
+    /* Print the results. */
+    cout << "The results of the algorithm:\n";
+    cout << " The number of fitness function evals: " << GA.num_fitness_evals() << "\n";
+    cout << " The best solutions found:\n" << scientific << setprecision(2);
+    for (const auto& sol : sols)
+    {
+        cout << "  f(x) = " << -sol.fitness[0] << " at x = (";
+        for (const auto& gene : sol.chromosome)
+        {
+            cout << gene << ", ";
+        }
+        cout << ")\n";
+    }
+
+    getchar();
+    return 0;
+}
@@ -0,0 +1,83 @@
+/* Example showing how to evaluate a fitness function that isn't thread-safe, and might crash, in separate worker processes. */
+
+#include "../src/real_ga.h"             /* For the real-coded genetic algorithm class. */
+#include "../src/process_pool.h"        /* For the process pool evaluation backend. */
+#include "../test/fitness_functions.h"  /* For the fitness function that will be used. */
+
+#include <cstdio>
+#include <cstddef>
+#include <csignal>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace genetic_algorithm;
+
+/* Some global state used by the fitness function, which makes it unsafe to call from multiple threads at the same time. */
+size_t num_calls = 0;
+
+int main()
+{
+    /*
+    * The problem is the same as in the rcga example (the Rastrigin function in 10 dimensions),
+    * but the fitness function is a stand-in for a legacy simulator: it uses global state, and it crashes
+    * for some of the inputs.
+    */
+    size_t num_vars = 10;
+    Rastrigin rastriginFunction(num_vars);
+
+    auto simulator = [&rastriginFunction](const vector<double>& x) -> vector<double>
+    {
+        num_calls++;
+        if (x[0] > 5.0) raise(SIGSEGV);
+
+        return rastriginFunction(x);
+    };
+
+    vector<pair<double, double>> limits(num_vars, { rastriginFunction.lbound(), rastriginFunction.ubound() });
+
+    /*
+    * Create the process pool. The workers are forked when it is created, and each of them calls the
+    * fitness function on one chromosome at a time. Crashed or timed out workers are restarted automatically.
+    */
+    ProcessPoolEvaluator<double> pool(simulator, num_vars, /* num_workers */ 4);
+    pool.timeout(1.0);                  /* Kill the evaluations taking more than 1 second. */
+    pool.max_retries(0);                /* The simulator is deterministic, there is no point in retrying the failed evaluations. */
+    pool.failure_fitness({ -1000.0 });  /* The fitness assigned to the solutions that crashed the simulator. */
+
+    /* Create the GA, and use the process pool to evaluate the candidates instead of the fitness function. */
+    RCGA GA(num_vars, rastriginFunction, limits);
+    GA.batchFitnessFunction = ref(pool);
+
+    GA.population_size(200);
+    GA.max_gen(500);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.mutation_method(RCGA::MutationMethod::polynomial);
+
+
+    /* Run the GA. */
+    auto sols = GA.run();
+
+
+    /* Print the results. */
+    cout << "The results of the algorithm:\n";
+    cout << " The number of fitness function evals: " << GA.num_fitness_evals() << "\n";
+    cout << " The number of crashed evaluations: " << pool.num_failures() << "\n";
+    cout << " The number of fitness function calls in this process: " << num_calls << "\n";
+    cout << " The best solutions found:\n" << scientific << setprecision(2);
+    for (const auto& sol : sols)
+    {
+        cout << "  f(x) = " << -sol.fitness[0] << " at x = (";
+        for (const auto& gene : sol.chromosome)
+        {
+            cout << gene << ", ";
+        }
+        cout << ")\n";
+    }
+
+    getchar();
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+* Example showing how to distribute the fitness evaluations to worker processes over sockets.
+*
+* Usage:
+*   socket_evaluator                     Runs the master and 4 local worker processes (over a Unix domain socket).
+*   socket_evaluator master <address>    Runs only the master, listening on the address (e.g. "*:5555").
+*   socket_evaluator worker <address>    Runs only a worker, connecting to the master at the address (e.g. "localhost:5555").
+*/
+
+#include "../src/real_ga.h"             /* For the real-coded genetic algorithm class. */
+#include "../src/socket_evaluator.h"    /* For the socket evaluation backend. */
+#include "../test/fitness_functions.h"  /* For the fitness function that will be used. */
+
+#include <cstdio>
+#include <cstddef>
+#include <string>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace std;
+using namespace genetic_algorithm;
+
+/* The problem is the same as in the rcga example (the Rastrigin function in 10 dimensions). */
+const size_t num_vars = 10;
+const Rastrigin rastriginFunction(num_vars);
+
+void runMaster(const string& address)
+{
+    /*
+    * Start listening for the workers. The chromosomes are sent to the workers in batches of 16,
+    * with up to 2 batches in flight for each worker.
+    */
+    SocketEvaluator<double> master(address, /* batch_size */ 16, /* batches_per_worker */ 2);
+    if (master.port() != 0) cout << "Listening on port " << master.port() << "\n";
+
+    /* Disconnect the workers that don't return the results of a batch in 10 seconds, and send their batches to the other workers. */
+    master.batch_timeout(10.0);
+
+    /* The workers can connect at any time, but wait for the first one before starting. */
+    master.wait_for_workers(1, 60.0);
+
+    /* Create the GA, and use the workers to evaluate the candidates instead of the fitness function. */
+    vector<pair<double, double>> limits(num_vars, { rastriginFunction.lbound(), rastriginFunction.ubound() });
+
+    RCGA GA(num_vars, rastriginFunction, limits);
+    GA.batchFitnessFunction = ref(master);
+
+    GA.population_size(200);
+    GA.max_gen(500);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.mutation_method(RCGA::MutationMethod::polynomial);
+
+
+    /* Run the GA. */
+    auto sols = GA.run();
+
+
+    /* Print the results. */
+    cout << "The results of the algorithm:\n";
+    cout << " The number of fitness function evals: " << GA.num_fitness_evals() << "\n";
+    cout << " The number of connected workers: " << master.num_workers() << "\n";
+    cout << " The best solutions found:\n" << scientific << setprecision(2);
+    for (const auto& sol : sols)
+    {
+        cout << "  f(x) = " << -sol.fitness[0] << " at x = (";
+        for (const auto& gene : sol.chromosome)
+        {
+            cout << gene << ", ";
+        }
+        cout << ")\n";
+    }
+}
+
+void runWorker(const string& address)
+{
+    /* Evaluate the chromosomes sent by the master until it closes the connection. */
+    runSocketWorker<double>(address, rastriginFunction);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc == 3 && string(argv[1]) == "master") runMaster(argv[2]);
+    else if (argc == 3 && string(argv[1]) == "worker") runWorker(argv[2]);
+    else
+    {
+        string address = "unix:/tmp/ga_socket_evaluator_example";
+
+        /* Start the local workers. They keep trying to connect until the master starts listening. */
+        vector<pid_t> workers;
+        for (size_t i = 0; i < 4; i++)
+        {
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                runWorker(address);
+                _exit(0);
+            }
+            workers.push_back(pid);
+        }
+
+        runMaster(address);
+
+        for (pid_t pid : workers) waitpid(pid, nullptr, 0);
+        getchar();
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+/* Example showing how to use an asynchronous (coroutine based) fitness function for I/O bound fitness evaluations. */
+
+#include "../src/real_ga.h"             /* For the real-coded genetic algorithm class. */
+#include "../src/async_evaluator.h"     /* For the asynchronous evaluation backend. */
+#include "../test/fitness_functions.h"  /* For the fitness function that will be used. */
+
+#include <cstdio>
+#include <cstddef>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace genetic_algorithm;
+
+/* The problem is the same as in the rcga example (the Rastrigin function in 10 dimensions). */
+const size_t num_vars = 10;
+const Rastrigin rastriginFunction(num_vars);
+
+/*
+* The fitness function is a coroutine returning a FitnessTask. It stands in for an objective that mostly
+* waits on I/O, like a query to a database or a simulator running in a subprocess: every evaluation waits 50 ms.
+* While a coroutine waits, it doesn't use any threads, so many of them can wait at the same time.
+*/
+FitnessTask slowFitness(const vector<double>& x)
+{
+    co_await async_sleep(chrono::milliseconds(50));     /* A real fitness function could use async_readable() or async_callback() here. */
+
+    co_return rastriginFunction(x);
+}
+
+int main()
+{
+    vector<pair<double, double>> limits(num_vars, { rastriginFunction.lbound(), rastriginFunction.ubound() });
+
+    /*
+    * Create the evaluator. The coroutines are run on 2 threads, and all of the
+    * children of a generation can be evaluated at the same time (up to 1000 evaluations in progress).
+    */
+    AsyncEvaluator<double> evaluator(slowFitness, /* num_threads */ 2, /* max_in_flight */ 1000);
+
+    /* Create the GA, and use the evaluator to evaluate the candidates instead of the fitness function. */
+    RCGA GA(num_vars, rastriginFunction, limits);
+    GA.batchFitnessFunction = ref(evaluator);
+
+    GA.population_size(200);
+    GA.max_gen(100);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.mutation_method(RCGA::MutationMethod::polynomial);
+
+
+    /* Run the GA. */
+    auto start = chrono::steady_clock::now();
+    auto sols = GA.run();
+    chrono::duration<double> runtime = chrono::steady_clock::now() - start;
+
+
+    /* Print the results. */
+    cout << "The results of the algorithm:\n";
+    cout << " The number of fitness function evals: " << GA.num_fitness_evals() << "\n";
+    cout << " The time taken: " << fixed << setprecision(1) << runtime.count() << " s\n";
+    cout << " The best solutions found:\n" << scientific << setprecision(2);
+    for (const auto& sol : sols)
+    {
+        cout << "  f(x) = " << -sol.fitness[0] << " at x = (";
+        for (const auto& gene : sol.chromosome)
+        {
+            cout << gene << ", ";
+        }
+        cout << ")\n";
+    }
+
+    getchar();
+    return 0;
+}
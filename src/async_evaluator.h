@@ -0,0 +1,660 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/**
+* This file contains the asynchronous evaluation backend, which evaluates fitness functions written
+* as C++20 coroutines, so that many I/O bound fitness evaluations can be in progress at the same time
+* using only a few threads.
+*
+* @file async_evaluator.h
+*/
+
+#ifndef GA_ASYNC_EVALUATOR_H
+#define GA_ASYNC_EVALUATOR_H
+
+#include <coroutine>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+namespace genetic_algorithm::detail
+{
+    class AsyncExecutor;
+    class AsyncBatchBase;
+
+} // namespace genetic_algorithm::detail
+
+namespace genetic_algorithm
+{
+    /**
+    * The return type of the asynchronous fitness functions used by the AsyncEvaluator. \n
+    * An asynchronous fitness function is a coroutine that returns a FitnessTask, and uses co_return to return the fitness vector:
+    * @code
+    * FitnessTask fitness(const std::vector<double>& x)
+    * {
+    *     co_await async_sleep(std::chrono::milliseconds(10));   // Wait without blocking a thread.
+    *     co_return std::vector{ -x[0] * x[0] };
+    * }
+    * @endcode
+    * The awaitables of this file (async_sleep, async_yield, async_callback, async_readable, async_writable)
+    * can only be awaited directly in the body of the fitness function coroutine.
+    */
+    class [[nodiscard]] FitnessTask
+    {
+    public:
+
+        struct promise_type
+        {
+            std::vector<double> fitness;
+            std::exception_ptr exception;
+
+            detail::AsyncExecutor* executor = nullptr;  /* The executor the coroutine is running on. */
+            detail::AsyncBatchBase* batch = nullptr;    /* Notified when the coroutine finishes. */
+            size_t index = 0;                           /* The index of the evaluated chromosome in the batch. */
+
+            FitnessTask get_return_object() noexcept { return FitnessTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            auto final_suspend() noexcept;
+            void return_value(std::vector<double> fx) noexcept { fitness = std::move(fx); }
+            void unhandled_exception() noexcept { exception = std::current_exception(); }
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        FitnessTask(FitnessTask&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        FitnessTask& operator=(FitnessTask&& other) noexcept;
+        FitnessTask(const FitnessTask&) = delete;
+        FitnessTask& operator=(const FitnessTask&) = delete;
+        ~FitnessTask() { if (handle_) handle_.destroy(); }
+
+        /** @returns The handle of the coroutine, which is no longer owned by the task. */
+        Handle release() noexcept { return std::exchange(handle_, nullptr); }
+
+    private:
+        explicit FitnessTask(Handle handle) noexcept : handle_(handle) {}
+
+        Handle handle_;
+    };
+
+    /**
+    * Evaluation backend that evaluates asynchronous fitness functions (coroutines returning a FitnessTask). \n
+    * The fitness function coroutines are run on a small thread pool, and a thread is only used by an evaluation while the
+    * coroutine is actually running, not while it is suspended waiting for something (a timer, a file descriptor, or a callback).
+    * This allows running many more I/O bound evaluations at the same time than the number of threads. \n
+    * Use it as the batch fitness function of a GA:
+    * @code
+    * AsyncEvaluator<double> evaluator(fitness_coroutine, 4, 1000);
+    * GA.batchFitnessFunction = std::ref(evaluator);
+    * @endcode
+    * The chromosomes passed to the fitness function stay valid until its coroutine finishes.
+    */
+    template<typename geneType>
+    class AsyncEvaluator
+    {
+    public:
+
+        using Chromosome = std::vector<geneType>;
+        using AsyncFitnessFunction = std::function<FitnessTask(const Chromosome&)>;
+
+        /**
+        * Creates the evaluator and starts its threads.
+        *
+        * @param fitness_function The asynchronous fitness function.
+        * @param num_threads The number of threads used to run the fitness function coroutines. Uses the number of hardware threads if 0.
+        * @param max_in_flight The maximum number of fitness evaluations in progress at the same time.
+        */
+        explicit AsyncEvaluator(AsyncFitnessFunction fitness_function, size_t num_threads = 0, size_t max_in_flight = 1024);
+
+        AsyncEvaluator(const AsyncEvaluator&) = delete;
+        AsyncEvaluator& operator=(const AsyncEvaluator&) = delete;
+
+        /** Stops the threads of the evaluator. */
+        ~AsyncEvaluator();
+
+        /**
+        * Evaluates the chromosomes, with at most max_in_flight evaluations in progress at the same time.
+        *
+        * @param chroms The chromosomes to evaluate.
+        * @returns The fitness vectors of the chromosomes.
+        * @throws Rethrows the first exception thrown by the fitness function, after the evaluations in progress have finished.
+        */
+        std::vector<std::vector<double>> operator()(const std::vector<const Chromosome*>& chroms);
+
+        /** Sets the maximum number of fitness evaluations in progress at the same time to @p count. */
+        void max_in_flight(size_t count);
+        [[nodiscard]] size_t max_in_flight() const noexcept { return max_in_flight_; }
+
+        /** @returns The number of threads used to run the fitness function coroutines. */
+        [[nodiscard]] size_t num_threads() const noexcept;
+
+    private:
+        class Batch;
+
+        AsyncFitnessFunction fitness_function_;
+        size_t max_in_flight_;
+        std::unique_ptr<detail::AsyncExecutor> executor_;
+    };
+
+    /** Suspends the fitness function for @p duration without blocking a thread. */
+    template<typename Rep, typename Period>
+    [[nodiscard]] auto async_sleep(std::chrono::duration<Rep, Period> duration);
+
+    /** Suspends the fitness function and resumes it later, letting the other evaluations run on its thread. */
+    [[nodiscard]] auto async_yield() noexcept;
+
+    /**
+    * Suspends the fitness function until a callback is called. \n
+    * @p start is called with the callback after the coroutine was suspended, and it should pass it
+    * to an asynchronous operation (eg. the callback based API of a database client), which calls it once when it completes.
+    * The callback can be called from any thread, the coroutine is resumed on the evaluator's threads.
+    */
+    [[nodiscard]] auto async_callback(std::function<void(std::function<void()>)> start);
+
+#if defined(__unix__) || defined(__APPLE__)
+
+    /** Suspends the fitness function until the file descriptor @p fd is readable (or closed, or has an error). Only available on POSIX systems. */
+    [[nodiscard]] auto async_readable(int fd) noexcept;
+
+    /** Suspends the fitness function until the file descriptor @p fd is writable (or has an error). Only available on POSIX systems. */
+    [[nodiscard]] auto async_writable(int fd) noexcept;
+
+#endif
+
+} // namespace genetic_algorithm
+
+
+/* IMPLEMENTATION */
+
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace genetic_algorithm::detail
+{
+    /*
+    * Runs the coroutines on a pool of threads, and resumes the suspended ones when their timers
+    * expire or their file descriptors become ready (using a separate thread for waiting on these).
+    */
+    class AsyncExecutor
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit AsyncExecutor(size_t num_threads);
+        AsyncExecutor(const AsyncExecutor&) = delete;
+        AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+        ~AsyncExecutor();
+
+        /* Resume the coroutine on one of the threads of the pool. */
+        void post(std::coroutine_handle<> handle);
+
+        /* Resume the coroutine on the pool once the time is reached. */
+        void postAt(Clock::time_point time, std::coroutine_handle<> handle);
+
+#if defined(__unix__) || defined(__APPLE__)
+        /* Resume the coroutine on the pool once the file descriptor has one of the events. */
+        void postWhenReady(int fd, short events, std::coroutine_handle<> handle);
+#endif
+
+        size_t num_threads() const noexcept { return threads_.size(); }
+
+    private:
+        struct Timer
+        {
+            Clock::time_point time;
+            std::coroutine_handle<> handle;
+
+            friend bool operator>(const Timer& lhs, const Timer& rhs) noexcept { return lhs.time > rhs.time; }
+        };
+
+        struct FdWait
+        {
+            int fd;
+            short events;
+            std::coroutine_handle<> handle;
+        };
+
+        std::vector<std::thread> threads_;
+        std::deque<std::coroutine_handle<>> ready_;
+        std::mutex ready_mtx_;
+        std::condition_variable ready_cv_;
+
+        std::thread reactor_;
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+        std::vector<FdWait> fd_waits_;
+        std::mutex reactor_mtx_;
+        std::condition_variable reactor_cv_;
+#if defined(__unix__) || defined(__APPLE__)
+        int wakeup_fds_[2] = { -1, -1 };    /* Self-pipe used to interrupt the poll of the reactor thread. */
+#endif
+
+        bool stop_ = false;
+
+        void runWorker();
+        void runReactor();
+        void wakeReactor();
+    };
+
+    inline AsyncExecutor::AsyncExecutor(size_t num_threads)
+    {
+        assert(num_threads > 0);
+
+#if defined(__unix__) || defined(__APPLE__)
+        if (::pipe(wakeup_fds_) != 0) throw std::runtime_error("Couldn't create the wakeup pipe of the asynchronous evaluator.");
+        for (int fd : wakeup_fds_)
+        {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+#endif
+        threads_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; i++) threads_.emplace_back(&AsyncExecutor::runWorker, this);
+
+        reactor_ = std::thread(&AsyncExecutor::runReactor, this);
+    }
+
+    inline AsyncExecutor::~AsyncExecutor()
+    {
+        {
+            std::scoped_lock lock(ready_mtx_, reactor_mtx_);
+            stop_ = true;
+        }
+        ready_cv_.notify_all();
+        wakeReactor();
+
+        for (auto& thread : threads_) thread.join();
+        reactor_.join();
+
+#if defined(__unix__) || defined(__APPLE__)
+        ::close(wakeup_fds_[0]);
+        ::close(wakeup_fds_[1]);
+#endif
+    }
+
+    inline void AsyncExecutor::post(std::coroutine_handle<> handle)
+    {
+        /* Notify with the lock held, the thread calling this might not be owned by the executor, which could be destroyed right after. */
+        std::lock_guard lock(ready_mtx_);
+        ready_.push_back(handle);
+        ready_cv_.notify_one();
+    }
+
+    inline void AsyncExecutor::postAt(Clock::time_point time, std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard lock(reactor_mtx_);
+            timers_.push({ time, handle });
+        }
+        wakeReactor();
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+
+    inline void AsyncExecutor::postWhenReady(int fd, short events, std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard lock(reactor_mtx_);
+            fd_waits_.push_back({ fd, events, handle });
+        }
+        wakeReactor();
+    }
+
+#endif
+
+    inline void AsyncExecutor::wakeReactor()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        char byte = 0;
+        [[maybe_unused]] auto ret = ::write(wakeup_fds_[1], &byte, 1);  /* The pipe being full is fine, the reactor will wake up anyway. */
+#else
+        reactor_cv_.notify_one();
+#endif
+    }
+
+    inline void AsyncExecutor::runWorker()
+    {
+        while (true)
+        {
+            std::unique_lock lock(ready_mtx_);
+            ready_cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+            if (ready_.empty()) return;
+
+            std::coroutine_handle<> handle = ready_.front();
+            ready_.pop_front();
+            lock.unlock();
+
+            handle.resume();
+        }
+    }
+
+    inline void AsyncExecutor::runReactor()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        std::vector<pollfd> poll_fds;
+#endif
+        std::unique_lock lock(reactor_mtx_);
+        while (!stop_)
+        {
+            /* Resume the coroutines whose timers expired. */
+            auto now = Clock::now();
+            while (!timers_.empty() && timers_.top().time <= now)
+            {
+                post(timers_.top().handle);
+                timers_.pop();
+            }
+
+#if defined(__unix__) || defined(__APPLE__)
+            int timeout = -1;
+            if (!timers_.empty())
+            {
+                auto wait_time = std::chrono::ceil<std::chrono::milliseconds>(timers_.top().time - now);
+                timeout = int(std::min<decltype(wait_time.count())>(wait_time.count(), 1000 * 60 * 60));
+            }
+
+            poll_fds.assign(1, { wakeup_fds_[0], POLLIN, 0 });
+            for (const auto& wait : fd_waits_) poll_fds.push_back({ wait.fd, wait.events, 0 });
+
+            lock.unlock();
+            int ret = ::poll(poll_fds.data(), poll_fds.size(), timeout);
+            lock.lock();
+
+            if (ret <= 0) continue;     /* Timeout or interrupted. */
+
+            if (poll_fds[0].revents != 0)
+            {
+                char buf[64];
+                while (::read(wakeup_fds_[0], buf, sizeof(buf)) > 0) {}
+            }
+
+            /* Resume the coroutines whose file descriptors are ready. The waits registered during the poll are after these in fd_waits_. */
+            size_t num_polled = poll_fds.size() - 1;
+            size_t num_kept = 0;
+            for (size_t i = 0; i < fd_waits_.size(); i++)
+            {
+                if (i < num_polled && poll_fds[i + 1].revents != 0) post(fd_waits_[i].handle);
+                else fd_waits_[num_kept++] = fd_waits_[i];
+            }
+            fd_waits_.resize(num_kept);
+#else
+            if (timers_.empty()) reactor_cv_.wait(lock);
+            else reactor_cv_.wait_until(lock, timers_.top().time);
+#endif
+        }
+    }
+
+    /* The interface used by the coroutines of a batch to report that they finished. */
+    class AsyncBatchBase
+    {
+    public:
+        virtual void complete(FitnessTask::Handle handle) noexcept = 0;
+
+    protected:
+        ~AsyncBatchBase() = default;
+    };
+
+    /* Base of the awaitables, which need access to the executor the coroutine is running on. */
+    struct AsyncAwaitableBase
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_resume() const noexcept {}
+    };
+
+    struct SleepAwaitable : AsyncAwaitableBase
+    {
+        AsyncExecutor::Clock::time_point time;
+
+        void await_suspend(FitnessTask::Handle handle) const { handle.promise().executor->postAt(time, handle); }
+    };
+
+    struct YieldAwaitable : AsyncAwaitableBase
+    {
+        void await_suspend(FitnessTask::Handle handle) const { handle.promise().executor->post(handle); }
+    };
+
+    struct CallbackAwaitable : AsyncAwaitableBase
+    {
+        std::function<void(std::function<void()>)> start;
+
+        void await_suspend(FitnessTask::Handle handle)
+        {
+            /* The callback might resume the coroutine and destroy this awaitable before start returns. */
+            auto start_ = std::move(start);
+            AsyncExecutor* executor = handle.promise().executor;
+            start_([executor, handle] { executor->post(handle); });
+        }
+    };
+
+#if defined(__unix__) || defined(__APPLE__)
+
+    struct FdAwaitable : AsyncAwaitableBase
+    {
+        int fd;
+        short events;
+
+        void await_suspend(FitnessTask::Handle handle) const { handle.promise().executor->postWhenReady(fd, events, handle); }
+    };
+
+#endif
+
+} // namespace genetic_algorithm::detail
+
+namespace genetic_algorithm
+{
+    inline auto FitnessTask::promise_type::final_suspend() noexcept
+    {
+        struct FinalAwaitable
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(Handle handle) const noexcept { handle.promise().batch->complete(handle); }
+            void await_resume() const noexcept {}
+        };
+
+        return FinalAwaitable{};
+    }
+
+    inline FitnessTask& FitnessTask::operator=(FitnessTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    template<typename Rep, typename Period>
+    auto async_sleep(std::chrono::duration<Rep, Period> duration)
+    {
+        auto time = detail::AsyncExecutor::Clock::now() + std::chrono::ceil<detail::AsyncExecutor::Clock::duration>(duration);
+
+        return detail::SleepAwaitable{ {}, time };
+    }
+
+    inline auto async_yield() noexcept
+    {
+        return detail::YieldAwaitable{};
+    }
+
+    inline auto async_callback(std::function<void(std::function<void()>)> start)
+    {
+        if (start == nullptr) throw std::invalid_argument("The start function of the callback awaitable must not be empty.");
+
+        return detail::CallbackAwaitable{ {}, std::move(start) };
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+
+    inline auto async_readable(int fd) noexcept
+    {
+        return detail::FdAwaitable{ {}, fd, POLLIN };
+    }
+
+    inline auto async_writable(int fd) noexcept
+    {
+        return detail::FdAwaitable{ {}, fd, POLLOUT };
+    }
+
+#endif
+
+    /* The state of a single call to the evaluator. The coroutines of the batch start the next evaluations when they finish. */
+    template<typename geneType>
+    class AsyncEvaluator<geneType>::Batch : public detail::AsyncBatchBase
+    {
+    public:
+        Batch(AsyncEvaluator& evaluator, const std::vector<const Chromosome*>& chroms)
+            : evaluator_(evaluator), chroms_(chroms), fitness_vecs_(chroms.size())
+        {}
+
+        std::vector<std::vector<double>> run()
+        {
+            size_t num_initial = std::min(evaluator_.max_in_flight_, chroms_.size());
+            in_flight_ = num_initial;
+            next_ = num_initial;
+            for (size_t i = 0; i < num_initial; i++) start(i);
+
+            std::unique_lock lock(mtx_);
+            done_cv_.wait(lock, [this] { return in_flight_ == 0; });
+
+            if (exception_) std::rethrow_exception(exception_);
+
+            return std::move(fitness_vecs_);
+        }
+
+        void complete(FitnessTask::Handle handle) noexcept override
+        {
+            auto& promise = handle.promise();
+            if (promise.exception) fail(promise.exception);
+            else fitness_vecs_[promise.index] = std::move(promise.fitness);
+            handle.destroy();
+
+            startNext();
+        }
+
+    private:
+        AsyncEvaluator& evaluator_;
+        const std::vector<const Chromosome*>& chroms_;
+        std::vector<std::vector<double>> fitness_vecs_;
+
+        std::atomic<size_t> next_ = 0;      /* The index of the next chromosome to evaluate. */
+        std::atomic<bool> failed_ = false;
+        std::exception_ptr exception_;
+        size_t in_flight_ = 0;
+        std::mutex mtx_;
+        std::condition_variable done_cv_;
+
+        void start(size_t idx) noexcept
+        {
+            try
+            {
+                FitnessTask::Handle handle = evaluator_.fitness_function_(*chroms_[idx]).release();
+                if (!handle) throw std::invalid_argument("The asynchronous fitness function returned an empty task.");
+
+                handle.promise().executor = evaluator_.executor_.get();
+                handle.promise().batch = this;
+                handle.promise().index = idx;
+                evaluator_.executor_->post(handle);
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+                startNext();
+            }
+        }
+
+        /* Start the evaluation of the next chromosome, or finish this evaluation slot. */
+        void startNext() noexcept
+        {
+            size_t idx = next_.fetch_add(1, std::memory_order_relaxed);
+            if (idx < chroms_.size() && !failed_.load(std::memory_order_relaxed)) return start(idx);
+
+            std::lock_guard lock(mtx_);
+            if (--in_flight_ == 0) done_cv_.notify_all();
+        }
+
+        void fail(std::exception_ptr exception) noexcept
+        {
+            std::lock_guard lock(mtx_);
+            if (!exception_) exception_ = exception;
+            failed_.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    template<typename geneType>
+    AsyncEvaluator<geneType>::AsyncEvaluator(AsyncFitnessFunction fitness_function, size_t num_threads, size_t max_in_flight)
+        : fitness_function_(std::move(fitness_function))
+    {
+        if (fitness_function_ == nullptr) throw std::invalid_argument("The fitness function is a nullptr.");
+
+        this->max_in_flight(max_in_flight);
+
+        if (num_threads == 0) num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+        executor_ = std::make_unique<detail::AsyncExecutor>(num_threads);
+    }
+
+    template<typename geneType>
+    AsyncEvaluator<geneType>::~AsyncEvaluator() = default;
+
+    template<typename geneType>
+    void AsyncEvaluator<geneType>::max_in_flight(size_t count)
+    {
+        if (count == 0) throw std::invalid_argument("The maximum number of evaluations in progress must be at least 1.");
+
+        max_in_flight_ = count;
+    }
+
+    template<typename geneType>
+    size_t AsyncEvaluator<geneType>::num_threads() const noexcept
+    {
+        return executor_->num_threads();
+    }
+
+    template<typename geneType>
+    std::vector<std::vector<double>> AsyncEvaluator<geneType>::operator()(const std::vector<const Chromosome*>& chroms)
+    {
+        if (chroms.empty()) return {};
+
+        Batch batch(*this, chroms);
+
+        return batch.run();
+    }
+
+} // namespace genetic_algorithm
+
+#endif // !GA_ASYNC_EVALUATOR_H
\ No newline at end of file
@@ -36,9 +36,21 @@
 #include <unordered_set>
 #include <utility>
 #include <functional>
+#include <type_traits>
 #include <atomic>
+#include <string>
+#include <chrono>
+#include <ctime>
 #include <cstddef>
 
+#include "small_vector.h"
+#include "reference_points.h"
+#include "mo_detail.h"
+#include "hypervolume.h"
+#include "cancellation_token.h"
+#include "surrogate.h"
+#include "profiler.h"
+
 /** Genetic algorithms and random number generation. */
 namespace genetic_algorithm
 {
@@ -52,7 +64,10 @@ namespace genetic_algorithm
     {
     public:
 
-        /** Structure containing stats of the single-objective algorithm. */
+        /**
+        * Structure containing stats of the single-objective algorithm. \n
+        * With a constraint function, the stats only include the feasible candidates, and they are NaN in the generations without feasible candidates.
+        */
         struct History
         {
             std::vector<double> fitness_mean;   /**< The mean fitness values of each generation. */
@@ -65,11 +80,18 @@ namespace genetic_algorithm
             void add(double mean, double sd, double min, double max);
         };
 
+        /**
+        * The type used to store the fitness vectors of the candidates. \n
+        * Up to 4 objectives are stored inline in the candidates without allocating memory on the heap. \n
+        * Implicitly convertible from/to std::vector<double>.
+        */
+        using FitnessVector = detail::SmallVector<double, 4>;
+
         /** The candidates used in the algorithm, each representing a solution to the problem. */
         struct Candidate
         {
             std::vector<geneType> chromosome;   /**< The chromosome encoding the solution. */
-            std::vector<double> fitness;        /**< The fitness values of the candidate solution. */
+            FitnessVector fitness;              /**< The fitness values of the candidate solution. */
 
             double selection_pdf = 0.0;         /**< The probability of selecting the candidate (SOGA). */
             double selection_cdf = 0.0;         /**< The value of the cumulative distribution function for the candidate (SOGA). */
@@ -80,6 +102,9 @@ namespace genetic_algorithm
             size_t niche_count = 0;             /**< Number of candidates associated with the same reference point as this candidate (NSGA-III). */
 
             bool is_evaluated = false;          /**< False if the candidate's fitness value needs to be computed. */
+            double constraint_violation = 0.0;  /**< The total constraint violation of the candidate, 0.0 if it's feasible. @see GA::constraintFunction */
+
+            std::vector<double> strategy_params;    /**< Algorithm-specific parameters of the candidate, inherited by its children (e.g. self-adapted step sizes). Empty if unused. */
 
             Candidate();
             Candidate(const std::vector<geneType>& chrom);
@@ -105,10 +130,13 @@ namespace genetic_algorithm
         using Population = std::vector<Candidate>;                              /**< . */
 
         using fitnessFunction_t = std::function<std::vector<double>(const Chromosome&)>;    /**< The type of the fitness function. */
+        using batchFitnessFunction_t = std::function<std::vector<std::vector<double>>(const std::vector<const Chromosome*>&)>;  /**< The type of the batch fitness function. */
         using selectionFunction_t = std::function<Candidate(const Population&)>;            /**< The type of the selection function. */
         using crossoverFunction_t = std::function<CandidatePair(const Candidate&, const Candidate&, double)>;    /**< The type of the crossover function. */
         using mutationFunction_t = std::function<void(Candidate&, double)>;                 /**< The type of the mutation function. */
         using repairFunction_t = std::function<Chromosome(const Chromosome&)>;              /**< The type of the repair function. */
+        using inPlaceRepairFunction_t = std::function<bool(Chromosome&, std::vector<double>&, size_t&)>;   /**< The type of the in-place repair function. */
+        using constraintFunction_t = std::function<double(const Chromosome&)>;             /**< The type of the constraint function. */
         using callbackFunction_t = std::function<void(const GA*)>;
 
         /**
@@ -125,7 +153,8 @@ namespace genetic_algorithm
         /**
         * The possible stop conditions used in the algorithm. The algorithm always stops when @ref max_gen has been reached,
         * regardless of the stop condition selected. \n
-        * Some of the stop condition do not work for multi-objective problems (fitness_mean_stall and fitness_best_stall).
+        * Some of the stop condition do not work for multi-objective problems (fitness_mean_stall and fitness_best_stall),
+        * while hypervolume_stall only works for multi-objective problems.
         * Choose the stop condition with @ref stop_condition. \n
         */
         enum class StopCondition
@@ -134,7 +163,10 @@ namespace genetic_algorithm
             fitness_value,         /**< Stop when a solution was found which dominates a reference fitness value. @see fitness_threshold */
             fitness_evals,         /**< Stop when the fitness function has been evaluated a set number of times. @see max_fitness_evals */
             fitness_mean_stall,    /**< Stop when the mean fitness of the population doesn't improve at least @ref stall_threshold over @ref stall_gen_count. */
-            fitness_best_stall     /**< Stop when the highest fitness of the population doesn't improve at least @ref stall_threshold over @ref stall_gen_count. */
+            fitness_best_stall,    /**< Stop when the highest fitness of the population doesn't improve at least @ref stall_threshold over @ref stall_gen_count. */
+            hypervolume_stall,     /**< Stop when the hypervolume of the population doesn't improve at least @ref stall_threshold (relative to its old value) over @ref stall_gen_count. @see hypervolume_ref_point */
+            time_budget,           /**< Stop when the wall-clock time elapsed since the start of the run reaches a set value. @see time_budget */
+            cpu_budget             /**< Stop when the processor time used by the program since the start of the run reaches a set value. @see cpu_budget */
         };
 
         /**
@@ -154,6 +186,24 @@ namespace genetic_algorithm
             custom             /**< A user defined function is used to compute the selection probabilities. @see customCalcWeights */
         };
 
+        /**
+        * The possible methods used for generating the reference points of the NSGA-III algorithm. \n
+        * Choose the method with @ref ref_point_method.
+        */
+        using RefPointMethod = detail::RefPointMethod;
+
+        /**
+        * The phases of a generation that are measured separately by the profiler. @see profile \n
+        * The measurements are only made if GA_ENABLE_PROFILING is defined before including the library.
+        */
+        using Phase = detail::Phase;
+        using PhaseStats = detail::PhaseStats;                  /**< The measurements of a single phase. */
+        using Profile = detail::Profile;                        /**< The measurements of a whole run. @see profile */
+        using GenerationProfile = detail::GenerationProfile;    /**< The measurements of a single generation. @see generation_profiles */
+
+        /** The accuracy of the surrogate model's predictions in a run. @see surrogate_eval_fraction @see surrogate_stats */
+        using SurrogateStats = detail::SurrogateStats;
+
         /**
         * Should be set to false if the fitness function does not change over time. \n
         * (The fitness function will always return the same value for a given chromosome.) \n
@@ -168,14 +218,90 @@ namespace genetic_algorithm
         */
         bool archive_optimal_solutions = false;
 
+        /**
+        * The hypervolume of the population will be calculated in every generation of the multi-objective algorithms
+        * and stored in the hypervolume history if this is set to true. @see hypervolume_history \n
+        * The hypervolume is always tracked if the hypervolume_stall stop condition is selected.
+        */
+        bool track_hypervolume = false;
+
+        /**
+        * The children will be created and evaluated in a single parallel pass if this is set to true, with every step
+        * (selection, crossover, mutation, repair, and evaluation) being performed for a pair of children at once, instead of
+        * performing each step for all of the children before starting the next one. \n
+        * This avoids the synchronization between the steps and keeps the children in the cache of the thread processing them,
+        * which can be faster, especially if the time the fitness evaluations take varies. \n
+        * The optimal solutions archive is also updated at the same time as the children are created in this mode.
+        * The time spent creating the children is profiled as a single phase, and only the time spent waiting for the
+        * archive update after it is profiled as the update of the optimal solutions. @see Phase
+        */
+        bool pipelined_breeding = false;
+
         /**
         * The repair function applied to each Candidate of the population after the mutations if it isn't a nullptr. \n
         * This can be used to perform local search after the mutations, implementing a memetic algorithm.
         */
         repairFunction_t repairFunction = nullptr;
 
+        /**
+        * The repair function applied to each Candidate of the population after the mutations, modifying the chromosomes in place,
+        * if it isn't a nullptr. It's an alternative to @ref repairFunction which avoids copying and comparing the chromosomes,
+        * and only one of them can be set. \n
+        * The function must return true if it modified the chromosome. The fitness vector passed to it is empty,
+        * but if the function evaluated the (modified) chromosome, e.g. while performing a local search, it can store
+        * the fitness vector of the chromosome in it, and the candidate won't be evaluated again (Lamarckian local search). \n
+        * The last parameter is the number of fitness evaluations performed by the function (initially 0), which it must set
+        * if it called the fitness function. These evaluations are included in @ref num_fitness_evals and the fitness evaluation budget. \n
+        * The constraint function is still called for the candidates evaluated by the repair function, and the infeasible ones
+        * are ranked like the other infeasible candidates. @see constraintFunction
+        */
+        inPlaceRepairFunction_t inPlaceRepairFunction = nullptr;
+
+        /**
+        * The function used to check the constraints of the problem before the fitness evaluations if it isn't a nullptr. \n
+        * It must return the total constraint violation of a chromosome (a non-negative value, which is 0.0 if the chromosome is feasible).
+        * It's called for every child after the repair function, and the fitness function is only called for the feasible children. \n
+        * The infeasible candidates are always worse than the feasible ones, and the ones with lower constraint violations
+        * are better than the ones with higher violations (feasibility-first ranking in the single-objective mode, and constrained
+        * domination in the multi-objective modes). \n
+        * In the single-objective mode, this is done by replacing the fitness values of the infeasible candidates with penalty values:
+        * the worst fitness value among the feasible candidates minus the constraint violation. In the multi-objective modes, the
+        * infeasible candidates are ranked by their constraint violations alone, after all of the feasible candidates, and they are
+        * not used for the normalization and the niching of the NSGA-III algorithm. \n
+        * The fitness values of the infeasible candidates are only used for ranking the candidates: they are never included in the
+        * optimal solutions (which are empty if no feasible solution was found), and they are ignored by the fitness-based
+        * stop conditions and the fitness history.
+        */
+        constraintFunction_t constraintFunction = nullptr;
+
         callbackFunction_t endOfGenerationCallback = nullptr;
 
+        /**
+        * The function used to evaluate the candidates in batches if it isn't a nullptr. \n
+        * When set, the candidates that need to be evaluated are passed to this function all at once (in every generation),
+        * instead of calling the fitness function for each of them in parallel. It must return the fitness vectors of the
+        * chromosomes in the same order. The fitness function is not called by the GA in this case. \n
+        * This can be used to plug in different evaluation backends, e.g. the ProcessPoolEvaluator. \n
+        * The evaluation of a batch can't be interrupted by the cancellation token. \n
+        * The local searches of the RCGA call this function with a single chromosome for each of their evaluations.
+        */
+        batchFitnessFunction_t batchFitnessFunction = nullptr;
+
+        /**
+        * Cheaper, less accurate versions of the fitness function used for multi-fidelity evaluation,
+        * ordered from the most accurate to the cheapest. \n
+        * If it isn't empty, the children are first evaluated using the cheapest (last) function, and only the most
+        * promising part of them (@ref promotion_fraction) is promoted to the next, more accurate level, up to the fitness function.
+        * This is only a pre-screening of the children: the ones that weren't promoted are discarded, and the promoted ones are evaluated
+        * by the fitness function, so the population, the optimal solutions, and the history only contain fitness values computed by the
+        * fitness function. \n
+        * In the single-objective mode, the children with the highest fitness are promoted, while in the multi-objective modes all
+        * of the non-dominated children are promoted, and the children in the next fronts if the non-dominated ones are fewer than the promotion fraction. \n
+        * The low-fidelity functions are called for each child in parallel, even if the batch fitness function is set.
+        * Can't be used together with @ref pipelined_breeding. @see num_low_fidelity_evals
+        */
+        std::vector<fitnessFunction_t> lowFidelityFunctions;
+
         /**
         * Standard constructor for the GA.
         *
@@ -187,11 +313,21 @@ namespace genetic_algorithm
         virtual ~GA() = default;
 
         /**
-        * Runs the genetic algorithm with the selected settings.
+        * Runs the genetic algorithm with the selected settings. \n
+        * The run can be stopped early using the cancellation token of the GA. @see cancellation_token \n
+        * The derived classes can override it to call the main loop of the algorithm with their own operators. @see runGenerations
         *
         * @returns The optimal solutions.
         */
-        [[maybe_unused]] CandidateVec run();
+        [[maybe_unused]] virtual CandidateVec run();
+
+        /**
+        * @returns The cancellation token of the GA, which can be used to stop a run in progress. \n
+        * Cancelling it is thread-safe, and can be done from another thread, a signal handler, or from inside the fitness function.
+        * When cancelled, the fitness evaluations which haven't started yet are skipped, and run() returns the best solutions found until then. \n
+        * The token is reset at the start of every run, so it has no effect if it is cancelled before calling run().
+        */
+        [[nodiscard]] CancellationToken& cancellation_token() noexcept;
 
 
         /** @returns A vector of the pareto optimal solutions found while running the algorithm. */
@@ -209,6 +345,49 @@ namespace genetic_algorithm
         /** @returns A History object containing stats from each generation of the single objective genetic algorithm. */
         [[nodiscard]] History soga_history() const;
 
+        /**
+        * @returns The hypervolume of the population in each generation of the multi-objective algorithms,
+        * if it was tracked. @see track_hypervolume @see hypervolume_ref_point
+        */
+        [[nodiscard]] std::vector<double> hypervolume_history() const;
+
+        /**
+        * @returns The wall-clock and processor times spent in each phase of the last run, the number of candidates
+        * processed in them, and a histogram of the fitness evaluation latencies. @see Phase \n
+        * Only measured if GA_ENABLE_PROFILING is defined before including the library, otherwise everything is 0.
+        */
+        [[nodiscard]] const Profile& profile() const noexcept;
+
+        /**
+        * @returns The accuracy of the surrogate model's fitness predictions in each generation of the last run,
+        * and the number of fitness evaluations it saved. Empty unless surrogate screening was used. @see surrogate_eval_fraction
+        */
+        [[nodiscard]] const SurrogateStats& surrogate_stats() const noexcept;
+
+        /**
+        * Sets whether the measurements of the profiler should also be stored separately for each generation. \n
+        * Has no effect unless GA_ENABLE_PROFILING is defined. @see generation_profiles
+        *
+        * @param enable True if the measurements of each generation should be stored.
+        */
+        void record_generation_profiles(bool enable) noexcept;
+        [[nodiscard]] bool record_generation_profiles() const noexcept;
+
+        /** @returns The measurements of each generation of the last run, if @ref record_generation_profiles was set. */
+        [[nodiscard]] const std::vector<GenerationProfile>& generation_profiles() const noexcept;
+
+        /**
+        * Sets the file the timeline of the runs should be written to. If it is not empty, the start and end times of each
+        * phase and fitness evaluation (with the threads they ran on) will be written to the file @p fname in the Chrome trace
+        * event format, which can be opened in Perfetto or chrome://tracing. \n
+        * The events are written by a background thread while the algorithm is running. This works regardless of GA_ENABLE_PROFILING. \n
+        * The file is overwritten by each run. Set an empty file name to disable tracing (default).
+        *
+        * @param fname The name of the file to write the trace events to.
+        */
+        void trace_file(const std::string& fname);
+        [[nodiscard]] std::string trace_file() const;
+
         /**
         * Set the type of the problem/genetic algorithm that will be used (single-/multi-objective).
         *
@@ -350,6 +529,70 @@ namespace genetic_algorithm
         void max_fitness_evals(size_t max_evals);
         [[nodiscard]] size_t max_fitness_evals() const;
 
+        /**
+        * Sets the maximum wall-clock time the algorithm runs for to @p seconds if the time_budget stop condition is selected.
+        * @see stop_condition @see StopCondition \n
+        * The algorithm may run longer than the time set, since the stop condition is only checked at the end of each generation. \n
+        * The value of @p seconds must be greater than 0.
+        *
+        * @param seconds The time budget of a run in seconds.
+        */
+        void time_budget(double seconds);
+        [[nodiscard]] double time_budget() const;
+
+        /**
+        * Sets the maximum processor time the algorithm runs for to @p seconds if the cpu_budget stop condition is selected.
+        * The processor time of all of the threads of the program is counted, as measured by std::clock. @see stop_condition @see StopCondition \n
+        * The algorithm may run longer than the time set, since the stop condition is only checked at the end of each generation. \n
+        * The value of @p seconds must be greater than 0.
+        *
+        * @param seconds The processor time budget of a run in seconds.
+        */
+        void cpu_budget(double seconds);
+        [[nodiscard]] double cpu_budget() const;
+
+        /**
+        * Sets the fraction of the children that are evaluated using the fitness function in each generation to @p fraction. \n
+        * If it is less than 1.0, the fitness of the children is predicted first using a k-nearest neighbours regression model
+        * built from the previously evaluated candidates (the surrogate model), and only the most promising @p fraction
+        * of the children are evaluated and considered for the next population, the rest are discarded. \n
+        * This can reduce the number of fitness evaluations a lot for expensive fitness functions, but the predictions
+        * also cost some time, and may be inaccurate. @see surrogate_stats \n
+        * The value of @p fraction must be on the interval (0.0, 1.0]. The default is 1.0, which means that the surrogate model isn't used. \n
+        * Can't be used together with @ref pipelined_breeding.
+        *
+        * @param fraction The fraction of the children evaluated in each generation.
+        */
+        void surrogate_eval_fraction(double fraction);
+        [[nodiscard]] double surrogate_eval_fraction() const;
+
+        /**
+        * Sets the number of neighbours used by the surrogate model to predict the fitness of a child to @p k. \n
+        * The predicted fitness is the inverse distance weighted mean of the fitness of the @p k closest evaluated
+        * candidates. @see surrogate_eval_fraction \n
+        * The value of @p k must be at least 1.
+        *
+        * @param k The number of neighbours used by the surrogate model.
+        */
+        void surrogate_neighbours(size_t k);
+        [[nodiscard]] size_t surrogate_neighbours() const;
+
+        /**
+        * Sets the fraction of the children promoted from each fidelity level to the next one when using
+        * multi-fidelity evaluation. @see lowFidelityFunctions \n
+        * The value of @p fraction must be on the interval (0.0, 1.0]. The default is 0.5.
+        *
+        * @param fraction The fraction of the children promoted to the next fidelity level.
+        */
+        void promotion_fraction(double fraction);
+        [[nodiscard]] double promotion_fraction() const;
+
+        /**
+        * @returns The number of times each of the low-fidelity functions was called in the last run
+        * (in the same order as the functions in @ref lowFidelityFunctions). These aren't included in @ref num_fitness_evals.
+        */
+        [[nodiscard]] const std::vector<size_t>& num_low_fidelity_evals() const noexcept;
+
         /**
         * Sets the reference fitness value for the fitness_value stop condition to @p ref. \n
         * The algorithm will stop running if a solution has been found which dominates this reference point. \n
@@ -363,7 +606,7 @@ namespace genetic_algorithm
 
         /**
         * Sets the number of generations to look back when evaluating the stall stop conditions. \n
-        * Only relevant for the single-objective algorithm. @see stop_condition @see StopCondition \n
+        * @see stop_condition @see StopCondition \n
         * Must be at least 1.
         *
         * @param count The number of generations to look back when checking the stall conditions.
@@ -373,7 +616,8 @@ namespace genetic_algorithm
 
         /**
         * Sets the value of the stall threshold to @p threshold for the stall stop conditions. \n
-        * Only relevant for the single-objective algorithm. @see stop_condition @see StopCondition \n
+        * For the hypervolume_stall condition, the threshold is relative to the old hypervolume of the population. \n
+        * @see stop_condition @see StopCondition \n
         * May be negative if the deterioration of the stall metric can be allowed.
         *
         * @param threshold The stall threshold to use.
@@ -381,6 +625,20 @@ namespace genetic_algorithm
         void stall_threshold(double threshold);
         [[nodiscard]] double stall_threshold() const;
 
+        /**
+        * Sets the reference point used for calculating the hypervolume of the population to @p ref. \n
+        * The reference point should be dominated by every solution (the fitness functions are maximized),
+        * the solutions which don't dominate it don't contribute to the hypervolume. \n
+        * If @p ref is empty, the reference point is determined from the initial population instead: for each objective,
+        * the lowest fitness value in the initial population minus 10% of the range of the values. \n
+        * The size of @p ref must be equal to the number of objectives if it's not empty.
+        * @see track_hypervolume @see StopCondition
+        *
+        * @param ref The reference point used for the hypervolume calculations.
+        */
+        void hypervolume_ref_point(std::vector<double> ref);
+        [[nodiscard]] std::vector<double> hypervolume_ref_point() const;
+
         /**
         * Sets the initial population to be used in the algorithm to @p pop instead of randomly generating it. \n
         * If @p pop is empty, the initial population will be randomly generated. \n
@@ -400,6 +658,45 @@ namespace genetic_algorithm
         */
         void setFitnessFunction(fitnessFunction_t f);
 
+        /**
+        * Sets the method used to generate the reference points of the NSGA-III algorithm to @p method. \n
+        * Only relevant for the NSGA-III algorithm, and only used if no reference points were preset. \n
+        * The generated reference points are cached, so they are only generated once for each population size,
+        * number of objectives and method.
+        * @see RefPointMethod @see presetRefPoints
+        *
+        * @param method The reference point generation method used.
+        */
+        void ref_point_method(RefPointMethod method);
+        [[nodiscard]] RefPointMethod ref_point_method() const;
+
+        /**
+        * Sets the reference points used in the NSGA-III algorithm to @p refs instead of generating them. \n
+        * The size of each reference point must be equal to the number of objectives. \n
+        * If @p refs is empty, the reference points will be generated using the method set with @ref ref_point_method.
+        *
+        * @param refs The reference points to use in the NSGA-III algorithm.
+        */
+        void presetRefPoints(const std::vector<std::vector<double>>& refs);
+
+        /**
+        * Loads the reference points used in the NSGA-III algorithm from the binary file @p fname,
+        * which was written by @ref saveRefPoints. \n
+        * Throws std::runtime_error if the file can't be read.
+        * @see presetRefPoints
+        *
+        * @param fname The name of the file to read the reference points from.
+        */
+        void loadRefPoints(const std::string& fname);
+
+        /**
+        * Saves the reference points used in the last run of the NSGA-III algorithm to the binary file @p fname. \n
+        * Throws std::runtime_error if the file can't be written.
+        *
+        * @param fname The name of the file to write the reference points to.
+        */
+        void saveRefPoints(const std::string& fname) const;
+
         /* Some getters for the NSGA-III algorithm. */
         [[nodiscard]] std::vector<std::vector<double>> ref_points() const;
         [[nodiscard]] std::vector<double> ideal_point() const;
@@ -413,6 +710,8 @@ namespace genetic_algorithm
 
         /* For the NSGA-III. */
         std::vector<std::vector<double>> ref_points_;
+        detail::ObjectiveMatrix ref_matrix_;        /* Same as ref_points_, stored in a flat matrix. */
+        detail::ObjectiveMatrix fnorms_;            /* The normalized fitness vectors of the last population. Reused between generations. */
         std::vector<double> ideal_point_;
         std::vector<double> nadir_point_;
         std::vector<std::vector<double>> extreme_points_;
@@ -421,6 +720,10 @@ namespace genetic_algorithm
         CandidateVec solutions_;
         std::atomic<size_t> num_fitness_evals_ = 0;
         History soga_history_;
+        std::vector<double> hv_history_;
+        CancellationToken cancellation_token_;
+        detail::Profiler profiler_;
+        SurrogateStats surrogate_stats_;
 
         /* Basic parameters of the GA. */
         Mode mode_ = Mode::single_objective;
@@ -442,13 +745,36 @@ namespace genetic_algorithm
         StopCondition stop_condition_ = StopCondition::max_gen;
         size_t max_gen_ = 500;
         size_t max_fitness_evals_ = 5000;
+        double time_budget_ = 10.0;
+        double cpu_budget_ = 10.0;
+        std::chrono::steady_clock::time_point run_start_time_;
+        std::clock_t run_start_cpu_time_ = 0;
         std::vector<double> fitness_reference_;
         size_t stall_gen_count_ = 20;
         double stall_threshold_ = 1e-6;
 
+        /* Hypervolume settings. */
+        std::vector<double> hv_ref_point_preset_;
+        std::vector<double> hv_ref_point_;      /* The reference point used in the current run. */
+
+        /* Surrogate model settings. */
+        double surrogate_eval_fraction_ = 1.0;
+        detail::KnnSurrogate surrogate_;
+
+        /* Multi-fidelity evaluation settings. */
+        double promotion_fraction_ = 0.5;
+        std::vector<size_t> num_low_fidelity_evals_;
+
         /* Initial population settings. */
         Population initial_population_preset_;
 
+        /* Profiling settings. */
+        std::string trace_fname_;
+
+        /* NSGA-III reference point settings. */
+        RefPointMethod ref_point_method_ = RefPointMethod::das_dennis;
+        std::vector<std::vector<double>> ref_points_preset_;
+
         /* User supplied functions used in the GA. All of these are optional except for the fitness function. */
         fitnessFunction_t fitnessFunction;
         selectionFunction_t customSelection = nullptr;
@@ -462,15 +788,83 @@ namespace genetic_algorithm
         virtual Candidate generateCandidate() const = 0;
         Population generateInitialPopulation() const;
         void evaluate(Population& pop);
+        template<typename FitnessF>
+        void evaluate(Population& pop, FitnessF&& fitness_f);    /* Uses fitness_f instead of the fitness function set. */
+        template<typename FitnessF>
+        void evaluateCandidate(Candidate& sol, FitnessF&& fitness_f);
+        void evaluateBatch(Population& pop);
+        void checkFitnessValues(const Population& pop) const;
+        void checkConstraints(Population& pop) const;
+        void checkCandidateConstraints(Candidate& sol) const;
+        double constraintViolation(const Chromosome& chrom) const;
+        void penalizeInfeasible(Population& old_pop, CandidateVec& children) const;
         void updateOptimalSolutions(CandidateVec& optimal_sols, const Population& pop) const;
         void prepSelections(Population& pop) const;
         Candidate select(const Population& pop) const;
         virtual CandidatePair crossover(const Candidate& parent1, const Candidate& parent2) const = 0;
         virtual void mutate(Candidate& child) const = 0;
-        void repair(Population& pop) const;      
+
+        /*
+        * Called after the population of each generation was created, before the end of generation callback. The derived
+        * classes can override it to modify the candidates of the population, e.g. by performing a local search on them.
+        */
+        virtual void improvePopulation(Population& /* pop */) {}
+
+        /*
+        * Called at the end of init(). The derived classes can override it to check their own parameters
+        * and to reset their state at the start of a run.
+        */
+        virtual void initAlgorithm() {}
+
+        /*
+        * Returns true if the fitness value of the candidate isn't the fitness of its chromosome (e.g. it was
+        * improved by a Baldwinian local search in the RCGA). These candidates aren't added to the optimal solutions.
+        */
+        virtual bool hasLearnedFitness(const Candidate& /* sol */) const { return false; }
+
+        /*
+        * The derived classes can override these to implement algorithms which create the children and the next population differently
+        * (e.g. differential evolution in the RCGA). If usesCustomBreeding() returns true, the children are created by customBreed()
+        * instead of the genetic operators, and the next population is created by customUpdatePopulation() instead of the method
+        * of the mode. The rest of the steps (repair, constraint checks, evaluation, etc.) are the same. \n
+        * The children passed to customUpdatePopulation() can contain unevaluated candidates if the run was cancelled.
+        */
+        virtual bool usesCustomBreeding() const noexcept { return false; }
+        virtual CandidateVec customBreed(const Population& /* pop */) { return {}; }
+        virtual Population customUpdatePopulation(Population& old_pop, CandidateVec& /* children */) { return old_pop; }
+        void repair(Population& pop);
+        void repairCandidate(Candidate& sol);
+        void checkChromosomeLengths(const Population& pop) const;
         Population updatePopulation(Population& old_pop, CandidateVec& children);       
         bool stopCondition() const;
+        bool budgetExhausted() const;   /* True if the fitness evaluation, time, or processor time budget of the stop condition was used up. */
         void updateStats(const Population& pop);
+        static void eraseUnevaluated(Population& pop);
+        std::vector<size_t> orderByFitness(Population& pop) const;
+        std::vector<FitnessVector> screenChildren(CandidateVec& children);
+        void updateSurrogate(const CandidateVec& children, const std::vector<FitnessVector>& predictions);
+        void promoteChildren(CandidateVec& children, std::vector<FitnessVector>& predictions);
+        double populationHypervolume(const Population& pop);
+
+        /*
+        * The main loop of the algorithm, with the genetic operators passed as function objects. \n
+        * run() calls this with the runtime selected operators, while the StaticGA passes its operator policies
+        * directly so they can be inlined.
+        */
+        template<typename PrepF, typename SelectF, typename CrossoverF, typename MutateF, typename FitnessF>
+        CandidateVec runGenerations(PrepF&& prep_f, SelectF&& select_f, CrossoverF&& crossover_f, MutateF&& mutate_f, FitnessF&& fitness_f);
+
+        /* Create and evaluate the children of a generation, performing each step for the entire population before the next one. */
+        template<typename SelectF, typename CrossoverF, typename MutateF, typename FitnessF>
+        CandidateVec generateChildren(size_t num_children, SelectF&& select_f, CrossoverF&& crossover_f, MutateF&& mutate_f, FitnessF&& fitness_f);
+
+        /* Create the children of a generation using the selection, crossover, and mutation operators. */
+        template<typename SelectF, typename CrossoverF, typename MutateF>
+        CandidateVec breedChildren(size_t num_children, SelectF&& select_f, CrossoverF&& crossover_f, MutateF&& mutate_f);
+
+        /* Create and evaluate the children of a generation, performing every step for a pair of children at once. @see pipelined_breeding */
+        template<typename SelectF, typename CrossoverF, typename MutateF, typename FitnessF>
+        CandidateVec generateChildrenPipelined(size_t num_children, SelectF&& select_f, CrossoverF&& crossover_f, MutateF&& mutate_f, FitnessF&& fitness_f);
 
 
         /* SOGA functions. */
@@ -514,11 +908,11 @@ namespace genetic_algorithm
 
         /* NSGA-III functions. */
 
-        void updateIdealPoint(const Population& pop);
-        void updateNadirPoint(const Population& pop);
+        void updateIdealPoint(const detail::ObjectiveMatrix& fmat);
+        void updateNadirPoint(const detail::ObjectiveMatrix& fmat);
 
         /* Find the closest reference point to each candidate after normalization, and their distances. */
-        void associatePopToRefs(Population& pop, const std::vector<std::vector<double>>& ref_points);
+        void associatePopToRefs(Population& pop, const detail::ObjectiveMatrix& ref_points);
 
         /* Return the niche counts of the ref points and assign niche counts to the candidates. */
         static std::vector<size_t> calcNicheCounts(Population& pop, const std::vector<std::vector<double>>& ref_points);
@@ -547,6 +941,10 @@ namespace genetic_algorithm
         static double fitnessMean(const Population& pop);
         static double fitnessSD(const Population& pop);
 
+        /* Copy the fitness vectors of the population into a flat matrix. */
+        static detail::ObjectiveMatrix fitnessMatrix(const Population& pop);
+        static detail::ObjectiveMatrix fitnessMatrix(const Population& pop, const std::vector<size_t>& indices);   /* Only the rows of the candidates at indices. */
+
     };
 
 } // namespace genetic_algorithm
@@ -556,6 +954,10 @@ namespace genetic_algorithm
 
 #include <execution>
 #include <numeric>
+#include <queue>
+#include <iterator>
+#include <future>
+#include <tuple>
 #include <limits>
 #include <stdexcept>
 #include <cstdlib>
@@ -563,8 +965,6 @@ namespace genetic_algorithm
 #include <cmath>
 
 #include "rng.h"
-#include "reference_points.h"
-#include "mo_detail.h"
 
 namespace genetic_algorithm
 {
@@ -679,6 +1079,60 @@ namespace genetic_algorithm
         return soga_history_;
     }
 
+    template<typename geneType>
+    inline auto GA<geneType>::surrogate_stats() const noexcept -> const SurrogateStats&
+    {
+        return surrogate_stats_;
+    }
+
+    template<typename geneType>
+    inline CancellationToken& GA<geneType>::cancellation_token() noexcept
+    {
+        return cancellation_token_;
+    }
+
+    template<typename geneType>
+    inline std::vector<double> GA<geneType>::hypervolume_history() const
+    {
+        return hv_history_;
+    }
+
+    template<typename geneType>
+    inline auto GA<geneType>::profile() const noexcept -> const Profile&
+    {
+        return profiler_.profile();
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::record_generation_profiles(bool enable) noexcept
+    {
+        profiler_.record_generations = enable;
+    }
+
+    template<typename geneType>
+    inline bool GA<geneType>::record_generation_profiles() const noexcept
+    {
+        return profiler_.record_generations;
+    }
+
+    template<typename geneType>
+    inline auto GA<geneType>::generation_profiles() const noexcept -> const std::vector<GenerationProfile>&
+    {
+        return profiler_.generations();
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::trace_file(const std::string& fname)
+    {
+        trace_fname_ = fname;
+    }
+
+    template<typename geneType>
+    inline std::string GA<geneType>::trace_file() const
+    {
+        return trace_fname_;
+    }
+
     template<typename geneType>
     inline void GA<geneType>::mode(Mode mode)
     {
@@ -850,7 +1304,7 @@ namespace genetic_algorithm
     template<typename geneType>
     inline void GA<geneType>::stop_condition(StopCondition condition)
     {
-        if (static_cast<size_t>(condition) > 4) throw std::invalid_argument("Invalid stop condition selected.");
+        if (static_cast<size_t>(condition) > 7) throw std::invalid_argument("Invalid stop condition selected.");
 
         stop_condition_ = condition;
     }
@@ -889,6 +1343,82 @@ namespace genetic_algorithm
         return max_fitness_evals_;
     }
 
+    template<typename geneType>
+    inline void GA<geneType>::time_budget(double seconds)
+    {
+        if (!(seconds > 0.0) || !std::isfinite(seconds)) throw std::invalid_argument("The time budget must be a positive, finite value.");
+
+        time_budget_ = seconds;
+    }
+
+    template<typename geneType>
+    inline double GA<geneType>::time_budget() const
+    {
+        return time_budget_;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::cpu_budget(double seconds)
+    {
+        if (!(seconds > 0.0) || !std::isfinite(seconds)) throw std::invalid_argument("The processor time budget must be a positive, finite value.");
+
+        cpu_budget_ = seconds;
+    }
+
+    template<typename geneType>
+    inline double GA<geneType>::cpu_budget() const
+    {
+        return cpu_budget_;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::surrogate_eval_fraction(double fraction)
+    {
+        if (!(0.0 < fraction && fraction <= 1.0)) throw std::invalid_argument("The surrogate evaluation fraction must be in the range (0.0, 1.0].");
+
+        surrogate_eval_fraction_ = fraction;
+    }
+
+    template<typename geneType>
+    inline double GA<geneType>::surrogate_eval_fraction() const
+    {
+        return surrogate_eval_fraction_;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::surrogate_neighbours(size_t k)
+    {
+        if (k == 0) throw std::invalid_argument("The number of neighbours used by the surrogate model must be at least 1.");
+
+        surrogate_.num_neighbours = k;
+    }
+
+    template<typename geneType>
+    inline size_t GA<geneType>::surrogate_neighbours() const
+    {
+        return surrogate_.num_neighbours;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::promotion_fraction(double fraction)
+    {
+        if (!(0.0 < fraction && fraction <= 1.0)) throw std::invalid_argument("The promotion fraction must be in the range (0.0, 1.0].");
+
+        promotion_fraction_ = fraction;
+    }
+
+    template<typename geneType>
+    inline double GA<geneType>::promotion_fraction() const
+    {
+        return promotion_fraction_;
+    }
+
+    template<typename geneType>
+    inline const std::vector<size_t>& GA<geneType>::num_low_fidelity_evals() const noexcept
+    {
+        return num_low_fidelity_evals_;
+    }
+
     template<typename geneType>
     inline void GA<geneType>::fitness_threshold(std::vector<double> ref)
     {
@@ -938,6 +1468,23 @@ namespace genetic_algorithm
         return stall_threshold_;
     }
 
+    template<typename geneType>
+    inline void GA<geneType>::hypervolume_ref_point(std::vector<double> ref)
+    {
+        if (!std::all_of(ref.begin(), ref.end(), [](double val) { return std::isfinite(val); }))
+        {
+            throw std::invalid_argument("Invalid value in the hypervolume reference point.");
+        }
+
+        hv_ref_point_preset_ = ref;
+    }
+
+    template<typename geneType>
+    inline std::vector<double> GA<geneType>::hypervolume_ref_point() const
+    {
+        return hv_ref_point_preset_;
+    }
+
     template<typename geneType>
     inline void GA<geneType>::presetInitialPopulation(const Population& pop)
     {
@@ -957,6 +1504,58 @@ namespace genetic_algorithm
         fitnessFunction = f;
     }
 
+    template<typename geneType>
+    inline void GA<geneType>::ref_point_method(RefPointMethod method)
+    {
+        if (static_cast<size_t>(method) > 1) throw std::invalid_argument("Invalid reference point method selected.");
+
+        ref_point_method_ = method;
+    }
+
+    template<typename geneType>
+    inline typename GA<geneType>::RefPointMethod GA<geneType>::ref_point_method() const
+    {
+        return ref_point_method_;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::presetRefPoints(const std::vector<std::vector<double>>& refs)
+    {
+        if (!refs.empty() && refs[0].size() < 2)
+        {
+            throw std::invalid_argument("The reference points must have at least 2 dimensions.");
+        }
+        if (!std::all_of(refs.begin(), refs.end(), [&refs](const std::vector<double>& ref) { return ref.size() == refs[0].size(); }))
+        {
+            throw std::invalid_argument("The size of each reference point must be the same.");
+        }
+        if (!std::all_of(refs.begin(), refs.end(),
+        [](const std::vector<double>& ref)
+        {
+            return std::all_of(ref.begin(), ref.end(), [](double val) { return std::isfinite(val) && val >= 0.0; })
+                && std::any_of(ref.begin(), ref.end(), [](double val) { return val > 0.0; });
+        }))
+        {
+            throw std::invalid_argument("The reference points must be nonnegative, finite, nonzero vectors.");
+        }
+
+        ref_points_preset_ = refs;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::loadRefPoints(const std::string& fname)
+    {
+        presetRefPoints(detail::readRefPoints(fname));
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::saveRefPoints(const std::string& fname) const
+    {
+        if (ref_points_.empty()) throw std::logic_error("There are no reference points to save, the NSGA-III algorithm hasn't been run yet.");
+
+        detail::writeRefPoints(fname, ref_points_);
+    }
+
     template<typename geneType>
     inline std::vector<std::vector<double>> GA<geneType>::ref_points() const
     {
@@ -978,69 +1577,302 @@ namespace genetic_algorithm
 
     template<typename geneType>
     inline typename GA<geneType>::CandidateVec GA<geneType>::run()
+    {
+        return runGenerations(
+            [this](Population& pop) { prepSelections(pop); },
+            [this](const Population& pop) { return select(pop); },
+            [this](const Candidate& parent1, const Candidate& parent2) { return crossover(parent1, parent2); },
+            [this](Candidate& child) { mutate(child); },
+            fitnessFunction);
+    }
+
+    template<typename geneType>
+    template<typename PrepF, typename SelectF, typename CrossoverF, typename MutateF, typename FitnessF>
+    inline typename GA<geneType>::CandidateVec GA<geneType>::runGenerations(PrepF&& prep_f, SelectF&& select_f, CrossoverF&& crossover_f,
+                                                                            MutateF&& mutate_f, FitnessF&& fitness_f)
     {
         using namespace std;
 
+        run_start_time_ = std::chrono::steady_clock::now();
+        run_start_cpu_time_ = std::clock();
+        cancellation_token_.reset();
+
         init();
+        profiler_.beginRun();
+        if (!trace_fname_.empty()) profiler_.tracer.open(trace_fname_);
 
         /* Create and evaluate the initial population. */
         population_ = generateInitialPopulation();
-        evaluate(population_);
-        updateStats(population_);
-
-        /* Other generations. */
-        size_t num_children = population_size_ + population_size_ % 2;
-        while (!stopCondition())
+        if (constraintFunction != nullptr)
         {
-            vector<CandidatePair> parent_pairs(num_children / 2);
+            auto timer = profiler_.time(Phase::check_constraints, population_.size());
+            checkConstraints(population_);
+        }
+        {
+            auto timer = profiler_.time(Phase::evaluate, population_.size());
+            evaluate(population_, fitness_f);
+        }
+        if (cancellation_token_.cancelled()) eraseUnevaluated(population_);
+        if (constraintFunction != nullptr)
+        {
+            CandidateVec no_children;
+            penalizeInfeasible(population_, no_children);
+        }
+        if constexpr (is_arithmetic_v<geneType>)
+        {
+            /* The surrogate model can only be used with numeric genes. */
+            if (surrogate_eval_fraction_ < 1.0)
+            {
+                for (const auto& sol : population_)
+                {
+                    if (sol.constraint_violation == 0.0) surrogate_.add(sol.chromosome, sol.fitness);
+                }
+            }
+        }
+        if (!population_.empty())
+        {
+            auto timer = profiler_.time(Phase::update_stats);
+            updateStats(population_);
+        }
+        profiler_.endGeneration(generation_cntr_);
 
-            prepSelections(population_);
-            if (archive_optimal_solutions) updateOptimalSolutions(solutions_, population_);
+        /* Other generations. */
+        size_t num_children = population_size_ + population_size_ % 2;
+        while (!cancellation_token_.cancelled() && !stopCondition())
+        {
+            if (!usesCustomBreeding())
+            {
+                auto timer = profiler_.time(Phase::prep_selections, population_.size());
+                prep_f(population_);
+            }
 
-            /* Selections. */
+            /* Create and evaluate the children. */
+            CandidateVec children;
+            if (pipelined_breeding)
+            {
+                /* The population is only read while breeding, so the archive can be updated at the same time. */
+                future<void> archive_update;
+                if (archive_optimal_solutions)
+                {
+                    archive_update = async(launch::async, [this] { updateOptimalSolutions(solutions_, population_); });
+                }
+                children = generateChildrenPipelined(num_children, select_f, crossover_f, mutate_f, fitness_f);
+                if (archive_update.valid())
+                {
+                    /* The profiler can only be used from this thread, so only the time spent waiting for the update is measured. */
+                    auto timer = profiler_.time(Phase::update_optimal_solutions, population_.size());
+                    archive_update.get();
+                }
+            }
+            else
+            {
+                if (archive_optimal_solutions)
+                {
+                    auto timer = profiler_.time(Phase::update_optimal_solutions, population_.size());
+                    updateOptimalSolutions(solutions_, population_);
+                }
+                children = generateChildren(num_children, select_f, crossover_f, mutate_f, fitness_f);
+            }
+            if (cancellation_token_.cancelled() && !usesCustomBreeding())
+            {
+                /* Only keep the children evaluated before the cancellation. */
+                eraseUnevaluated(children);
+                if (children.empty()) break;
+            }
+            {
+                auto timer = profiler_.time(Phase::update_population, population_.size() + children.size());
+                if (constraintFunction != nullptr) penalizeInfeasible(population_, children);
+                population_ = updatePopulation(population_, children);
+            }
+            {
+                auto timer = profiler_.time(Phase::local_search, population_.size());
+                improvePopulation(population_);
+            }
+
+            if (endOfGenerationCallback != nullptr)
+            {
+                auto timer = profiler_.time(Phase::callback);
+                endOfGenerationCallback(this);
+            }
+            generation_cntr_++;
+
+            {
+                auto timer = profiler_.time(Phase::update_stats);
+                updateStats(population_);
+            }
+            profiler_.endGeneration(generation_cntr_);
+        }
+        if (!population_.empty())
+        {
+            auto timer = profiler_.time(Phase::update_optimal_solutions, population_.size());
+            updateOptimalSolutions(solutions_, population_);
+        }
+        profiler_.endRun();
+        profiler_.tracer.close();
+
+        return solutions_;
+    }
+
+    template<typename geneType>
+    template<typename SelectF, typename CrossoverF, typename MutateF, typename FitnessF>
+    inline typename GA<geneType>::CandidateVec GA<geneType>::generateChildren(size_t num_children, SelectF&& select_f, CrossoverF&& crossover_f,
+                                                                              MutateF&& mutate_f, FitnessF&& fitness_f)
+    {
+        using namespace std;
+        assert(num_children % 2 == 0);
+
+        vector<Candidate> children;
+        if (usesCustomBreeding())
+        {
+            auto timer = profiler_.time(Phase::custom_breeding, num_children);
+            children = customBreed(population_);
+        }
+        else
+        {
+            children = breedChildren(num_children, select_f, crossover_f, mutate_f);
+        }
+
+        /* Apply repair function to the children if set. */
+        if (repairFunction != nullptr || inPlaceRepairFunction != nullptr)
+        {
+            auto timer = profiler_.time(Phase::repair, children.size());
+            repair(children);
+        }
+
+        /* Check the constraints, the infeasible children aren't evaluated by the fitness function. */
+        if (constraintFunction != nullptr)
+        {
+            auto timer = profiler_.time(Phase::check_constraints, children.size());
+            checkConstraints(children);
+        }
+
+        /* Only evaluate the most promising children according to the surrogate model. */
+        vector<FitnessVector> predictions;
+        if constexpr (is_arithmetic_v<geneType>)
+        {
+            if (surrogate_eval_fraction_ < 1.0)
+            {
+                auto timer = profiler_.time(Phase::surrogate_screening, children.size());
+                predictions = screenChildren(children);
+            }
+        }
+
+        /* Only evaluate the children which are the most promising according to the low-fidelity evaluations. */
+        if (!lowFidelityFunctions.empty())
+        {
+            auto timer = profiler_.time(Phase::low_fidelity_evaluate, children.size());
+            promoteChildren(children, predictions);
+        }
+
+        /* Evaluate the children. */
+        {
+            auto timer = profiler_.time(Phase::evaluate, children.size());
+            evaluate(children, fitness_f);
+        }
+        if constexpr (is_arithmetic_v<geneType>)
+        {
+            if (surrogate_eval_fraction_ < 1.0) updateSurrogate(children, predictions);
+        }
+
+        return children;
+    }
+
+    template<typename geneType>
+    template<typename SelectF, typename CrossoverF, typename MutateF>
+    inline typename GA<geneType>::CandidateVec GA<geneType>::breedChildren(size_t num_children, SelectF&& select_f, CrossoverF&& crossover_f, MutateF&& mutate_f)
+    {
+        using namespace std;
+        assert(num_children % 2 == 0);
+
+        vector<CandidatePair> parent_pairs(num_children / 2);
+
+        /* Selections. */
+        {
+            auto timer = profiler_.time(Phase::selection, num_children);
             generate(execution::par_unseq, parent_pairs.begin(), parent_pairs.end(),
-            [this]() -> CandidatePair
+            [this, &select_f]() -> CandidatePair
             {
-                return make_pair(select(population_), select(population_));
+                return make_pair(select_f(population_), select_f(population_));
             });
+        }
 
-            /* Crossovers. */
+        /* Crossovers. */
+        {
+            auto timer = profiler_.time(Phase::crossover, num_children);
             for_each(execution::par_unseq, parent_pairs.begin(), parent_pairs.end(),
-            [this](CandidatePair& p) -> void
+            [&crossover_f](CandidatePair& p) -> void
             {
-                p = crossover(p.first, p.second);
+                p = crossover_f(p.first, p.second);
             });
+        }
 
-            vector<Candidate> children;
-            children.reserve(num_children);
-            for (size_t i = 0; i < parent_pairs.size(); i++)
-            {
-                children.push_back(move(parent_pairs[i].first));
-                children.push_back(move(parent_pairs[i].second));
-            }
+        vector<Candidate> children;
+        children.reserve(num_children);
+        for (size_t i = 0; i < parent_pairs.size(); i++)
+        {
+            children.push_back(move(parent_pairs[i].first));
+            children.push_back(move(parent_pairs[i].second));
+        }
 
-            /* Mutations. */
+        /* Mutations. */
+        {
+            auto timer = profiler_.time(Phase::mutation, children.size());
             for_each(execution::par_unseq, children.begin(), children.end(),
-            [this](Candidate& c) -> void
+            [&mutate_f](Candidate& c) -> void
             {
-                mutate(c);
+                mutate_f(c);
             });
+        }
 
-            /* Apply repair function to the children if set. */
-            repair(children);
+        return children;
+    }
 
-            /* Overwrite the current population with the children. */
-            evaluate(children);
-            population_ = updatePopulation(population_, children);
+    template<typename geneType>
+    template<typename SelectF, typename CrossoverF, typename MutateF, typename FitnessF>
+    inline typename GA<geneType>::CandidateVec GA<geneType>::generateChildrenPipelined(size_t num_children, SelectF&& select_f, CrossoverF&& crossover_f,
+                                                                                       MutateF&& mutate_f, FitnessF&& fitness_f)
+    {
+        using namespace std;
+        assert(num_children % 2 == 0);
 
-            if (endOfGenerationCallback != nullptr) endOfGenerationCallback(this);
-            generation_cntr_++;
+        auto timer = profiler_.time(Phase::pipelined_breeding, num_children);
 
-            updateStats(population_);
-        }
-        updateOptimalSolutions(solutions_, population_);
+        CandidateVec children(num_children);
+        vector<size_t> pair_indices(num_children / 2);
+        iota(pair_indices.begin(), pair_indices.end(), size_t{ 0 });
 
-        return solutions_;
+        /* Each pair of children is created and evaluated by the same thread in one go, while they are still in its cache. */
+        for_each(execution::par_unseq, pair_indices.begin(), pair_indices.end(),
+        [&, this](size_t idx) -> void
+        {
+            Candidate& child1 = children[2 * idx];
+            Candidate& child2 = children[2 * idx + 1];
+
+            tie(child1, child2) = crossover_f(select_f(population_), select_f(population_));
+            mutate_f(child1);
+            mutate_f(child2);
+            if (repairFunction != nullptr || inPlaceRepairFunction != nullptr)
+            {
+                repairCandidate(child1);
+                repairCandidate(child2);
+            }
+            if (constraintFunction != nullptr)
+            {
+                checkCandidateConstraints(child1);
+                checkCandidateConstraints(child2);
+            }
+            if (batchFitnessFunction == nullptr)
+            {
+                evaluateCandidate(child1, fitness_f);
+                evaluateCandidate(child2, fitness_f);
+            }
+        });
+
+        if (repairFunction != nullptr || inPlaceRepairFunction != nullptr) checkChromosomeLengths(children);
+        if (batchFitnessFunction != nullptr) evaluateBatch(children);
+        checkFitnessValues(children);
+
+        return children;
     }
 
     template<typename geneType>
@@ -1054,6 +1886,38 @@ namespace genetic_algorithm
                 throw std::invalid_argument("The stall stop conditions only work for the single-objective algorithm.");
             }
         }
+        else if (stop_condition_ == StopCondition::hypervolume_stall)
+        {
+            throw std::invalid_argument("The hypervolume stall stop condition only works for the multi-objective algorithms.");
+        }
+        /* Check surrogate screening. */
+        if (surrogate_eval_fraction_ < 1.0 && !std::is_arithmetic_v<geneType>)
+        {
+            throw std::invalid_argument("The surrogate screening can only be used with numeric gene types.");
+        }
+        if (surrogate_eval_fraction_ < 1.0 && pipelined_breeding)
+        {
+            throw std::invalid_argument("The surrogate screening can't be used together with pipelined breeding.");
+        }
+        /* Check multi-fidelity evaluation. */
+        if (!lowFidelityFunctions.empty() && pipelined_breeding)
+        {
+            throw std::invalid_argument("The multi-fidelity evaluation can't be used together with pipelined breeding.");
+        }
+        if (std::any_of(lowFidelityFunctions.begin(), lowFidelityFunctions.end(), [](const fitnessFunction_t& f) { return f == nullptr; }))
+        {
+            throw std::invalid_argument("The low-fidelity functions can't be nullptrs.");
+        }
+        /* Check custom breeding. */
+        if (usesCustomBreeding() && (pipelined_breeding || surrogate_eval_fraction_ < 1.0 || !lowFidelityFunctions.empty()))
+        {
+            throw std::invalid_argument("The pipelined breeding, surrogate screening, and multi-fidelity evaluation can't be used with the custom breeding method of the algorithm.");
+        }
+        /* Check repair functions. */
+        if (repairFunction != nullptr && inPlaceRepairFunction != nullptr)
+        {
+            throw std::invalid_argument("Only one of the repair functions can be set.");
+        }
         /* Check selection method. */
         if (selection_method_ == SogaSelection::custom && customSelection == nullptr)
         {
@@ -1061,7 +1925,16 @@ namespace genetic_algorithm
         }
         /* Check mode. */
         Candidate temp = generateCandidate();
-        temp.fitness = fitnessFunction(temp.chromosome);
+        if (batchFitnessFunction != nullptr)
+        {
+            auto fitness_vecs = batchFitnessFunction({ &temp.chromosome });
+            if (fitness_vecs.size() != 1) throw std::domain_error("The batch fitness function must return a fitness vector for every chromosome.");
+            temp.fitness = fitness_vecs[0];
+        }
+        else
+        {
+            temp.fitness = fitnessFunction(temp.chromosome);
+        }
         num_objectives_ = temp.fitness.size();
         if (mode_ == Mode::single_objective && num_objectives_ != 1)
         {
@@ -1071,6 +1944,14 @@ namespace genetic_algorithm
         {
             throw std::invalid_argument("The size of the fitness vector must be at least 2 for multi-objective optimization.");
         }
+        if (stop_condition_ == StopCondition::fitness_value && fitness_reference_.size() != num_objectives_)
+        {
+            throw std::invalid_argument("The size of the fitness threshold must be equal to the number of objectives.");
+        }
+        if (mode_ != Mode::single_objective && !hv_ref_point_preset_.empty() && hv_ref_point_preset_.size() != num_objectives_)
+        {
+            throw std::invalid_argument("The size of the hypervolume reference point must be equal to the number of objectives.");
+        }
 
         /* General initialization. */
         generation_cntr_ = 0;
@@ -1085,16 +1966,42 @@ namespace genetic_algorithm
             soga_history_.reserve(max_gen_);
         }
 
+        /* Multi-objective stuff (hypervolume). */
+        hv_history_.clear();
+        hv_ref_point_ = hv_ref_point_preset_;
+
+        /* Surrogate model. */
+        surrogate_.clear();
+        surrogate_stats_.clear();
+
+        /* Multi-fidelity evaluation. */
+        num_low_fidelity_evals_.assign(lowFidelityFunctions.size(), 0);
+
         /* Multi-objective stuff (NSGA-III). */
         ideal_point_ = std::vector<double>(num_objectives_, -std::numeric_limits<double>::max());
         nadir_point_ = std::vector<double>(num_objectives_);
-        extreme_points_ = std::vector<std::vector<double>>(num_objectives_, std::vector<double>(num_objectives_));
+        extreme_points_.clear();
 
         /* Generate the reference points for the NSGA-III algorithm. */
         if (mode_ == Mode::multi_objective_decomp)
         {
-            ref_points_ = detail::generateRefPoints(population_size_, num_objectives_);
+            if (ref_points_preset_.empty())
+            {
+                ref_points_ = detail::generateRefPoints(population_size_, num_objectives_, ref_point_method_);
+            }
+            else if (ref_points_preset_[0].size() == num_objectives_)
+            {
+                ref_points_ = ref_points_preset_;
+            }
+            else
+            {
+                throw std::invalid_argument("The size of the preset reference points must be equal to the number of objectives.");
+            }
+            ref_matrix_ = detail::ObjectiveMatrix(ref_points_);
         }
+
+        /* Algorithm specific initialization. */
+        initAlgorithm();
     }
 
     template<typename geneType>
@@ -1131,20 +2038,84 @@ namespace genetic_algorithm
     {
         assert(fitnessFunction != nullptr);
 
-        std::for_each(std::execution::par_unseq, pop.begin(), pop.end(),
-        [this](Candidate& sol)
+        evaluate(pop, fitnessFunction);
+    }
+
+    template<typename geneType>
+    template<typename FitnessF>
+    inline void GA<geneType>::evaluate(Population& pop, FitnessF&& fitness_f)
+    {
+        if (batchFitnessFunction != nullptr)
+        {
+            evaluateBatch(pop);
+        }
+        else
         {
-            if (changing_fitness_func || !sol.is_evaluated)
+            std::for_each(std::execution::par_unseq, pop.begin(), pop.end(),
+            [this, &fitness_f](Candidate& sol)
             {
-                sol.fitness = fitnessFunction(sol.chromosome);
-                sol.is_evaluated = true;
+                evaluateCandidate(sol, fitness_f);
+            });
+        }
+
+        checkFitnessValues(pop);
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::evaluateBatch(Population& pop)
+    {
+        assert(batchFitnessFunction != nullptr);
+
+        if (cancellation_token_.cancelled()) return;
 
-                num_fitness_evals_++;
+        std::vector<size_t> indices;
+        std::vector<const Chromosome*> chroms;
+        for (size_t i = 0; i < pop.size(); i++)
+        {
+            if ((changing_fitness_func || !pop[i].is_evaluated) && pop[i].constraint_violation == 0.0)
+            {
+                indices.push_back(i);
+                chroms.push_back(&pop[i].chromosome);
             }
-        });
+        }
+        if (chroms.empty()) return;
 
+        std::vector<std::vector<double>> fitness_vecs = batchFitnessFunction(chroms);
+        if (fitness_vecs.size() != chroms.size())
+        {
+            throw std::domain_error("The batch fitness function must return a fitness vector for every chromosome.");
+        }
+
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            pop[indices[i]].fitness.assign(fitness_vecs[i].begin(), fitness_vecs[i].end());
+            pop[indices[i]].is_evaluated = true;
+        }
+        num_fitness_evals_ += indices.size();
+    }
+
+    template<typename geneType>
+    template<typename FitnessF>
+    inline void GA<geneType>::evaluateCandidate(Candidate& sol, FitnessF&& fitness_f)
+    {
+        if (cancellation_token_.cancelled()) return;
+        if ((changing_fitness_func || !sol.is_evaluated) && sol.constraint_violation == 0.0)
+        {
+            auto eval_start = profiler_.evalStart();
+            sol.fitness = fitness_f(sol.chromosome);
+            profiler_.addEvaluation(eval_start);
+            sol.is_evaluated = true;
+
+            num_fitness_evals_++;
+        }
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::checkFitnessValues(const Population& pop) const
+    {
         for (const auto& sol : pop)
         {
+            if (!sol.is_evaluated) continue;    /* The evaluation was cancelled. */
             if (sol.fitness.size() != num_objectives_)
             {
                 throw std::domain_error("A fitness vector returned by the fitness function has incorrect size.");
@@ -1156,12 +2127,91 @@ namespace genetic_algorithm
         }
     }
 
+    template<typename geneType>
+    inline void GA<geneType>::checkConstraints(Population& pop) const
+    {
+        std::for_each(std::execution::par_unseq, pop.begin(), pop.end(),
+        [this](Candidate& sol)
+        {
+            checkCandidateConstraints(sol);
+        });
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::checkCandidateConstraints(Candidate& sol) const
+    {
+        assert(constraintFunction != nullptr);
+
+        if (!changing_fitness_func && sol.is_evaluated) return;
+
+        double violation = constraintViolation(sol.chromosome);
+        sol.constraint_violation = violation;
+
+        /* The infeasible candidates are not evaluated, they get a penalty fitness value instead in the single-objective mode. */
+        if (violation > 0.0)
+        {
+            sol.fitness.clear();
+            sol.fitness.resize(num_objectives_, 0.0);
+            sol.is_evaluated = true;
+        }
+    }
+
+    template<typename geneType>
+    inline double GA<geneType>::constraintViolation(const Chromosome& chrom) const
+    {
+        assert(constraintFunction != nullptr);
+
+        double violation = constraintFunction(chrom);
+        if (!(violation >= 0.0) || !std::isfinite(violation))
+        {
+            throw std::domain_error("The constraint function must return a finite, non-negative constraint violation.");
+        }
+        return violation;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::penalizeInfeasible(Population& old_pop, CandidateVec& children) const
+    {
+        /* The multi-objective algorithms use constrained domination instead of the penalty values. @see nonDominatedSort */
+        if (mode_ != Mode::single_objective) return;
+
+        /* The worst fitness values of the feasible candidates, or 0.0 if there are no feasible candidates. */
+        std::vector<double> fworst(num_objectives_, std::numeric_limits<double>::max());
+        bool has_feasible = false;
+        for (const Population* pop : { &old_pop, &children })
+        {
+            for (const Candidate& sol : *pop)
+            {
+                if (sol.constraint_violation > 0.0) continue;
+                for (size_t obj = 0; obj < num_objectives_; obj++) fworst[obj] = std::min(fworst[obj], sol.fitness[obj]);
+                has_feasible = true;
+            }
+        }
+        if (!has_feasible) std::fill(fworst.begin(), fworst.end(), 0.0);
+
+        /* Every infeasible candidate is worse than every feasible one, and than the infeasible ones with lower constraint violations. */
+        for (Population* pop : { &old_pop, &children })
+        {
+            for (Candidate& sol : *pop)
+            {
+                if (sol.constraint_violation == 0.0) continue;
+                for (size_t obj = 0; obj < num_objectives_; obj++) sol.fitness[obj] = fworst[obj] - sol.constraint_violation;
+            }
+        }
+    }
+
     template<typename geneType>
     inline void GA<geneType>::updateOptimalSolutions(CandidateVec& optimal_sols, const Population& pop) const
     {
         assert(std::all_of(pop.begin(), pop.end(), [](const Candidate& sol) { return sol.is_evaluated; }));
 
         optimal_sols.insert(optimal_sols.end(), pop.begin(), pop.end());
+        std::erase_if(optimal_sols, [this](const Candidate& sol) { return hasLearnedFitness(sol); });
+
+        /* The fitness values of the infeasible solutions are only penalty values, not the fitness of the solutions. */
+        std::erase_if(optimal_sols, [](const Candidate& sol) { return sol.constraint_violation > 0.0; });
+        if (optimal_sols.empty()) return;
+
         if (mode_ == Mode::single_objective)
         {
             optimal_sols = findParetoFront1D(optimal_sols);
@@ -1215,22 +2265,56 @@ namespace genetic_algorithm
     }
 
     template<typename geneType>
-    inline void GA<geneType>::repair(Population& pop) const
+    inline void GA<geneType>::repair(Population& pop)
     {
         /* This function doesn't do anything unless a repair function is specified. */
-        if (repairFunction == nullptr) return;
+        if (repairFunction == nullptr && inPlaceRepairFunction == nullptr) return;
 
         std::for_each(std::execution::par_unseq, pop.begin(), pop.end(),
         [this](Candidate& sol)
         {
-            Chromosome improved_chrom = repairFunction(sol.chromosome);
-            if (improved_chrom != sol.chromosome)
+            repairCandidate(sol);
+        });
+
+        checkChromosomeLengths(pop);
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::repairCandidate(Candidate& sol)
+    {
+        assert(repairFunction != nullptr || inPlaceRepairFunction != nullptr);
+
+        if (inPlaceRepairFunction != nullptr)
+        {
+            std::vector<double> fitness;
+            size_t num_evals = 0;
+            bool modified = inPlaceRepairFunction(sol.chromosome, fitness, num_evals);
+            num_fitness_evals_ += num_evals;
+            if (!fitness.empty())
+            {
+                /* An infeasible chromosome is ranked later like the other infeasible candidates. */
+                sol.fitness.assign(fitness.begin(), fitness.end());
+                sol.is_evaluated = true;
+                sol.constraint_violation = (constraintFunction != nullptr) ? constraintViolation(sol.chromosome) : 0.0;
+            }
+            else if (modified)
             {
                 sol.is_evaluated = false;
-                sol.chromosome = std::move(improved_chrom);
             }
-        });
+            return;
+        }
+
+        Chromosome improved_chrom = repairFunction(sol.chromosome);
+        if (improved_chrom != sol.chromosome)
+        {
+            sol.is_evaluated = false;
+            sol.chromosome = std::move(improved_chrom);
+        }
+    }
 
+    template<typename geneType>
+    inline void GA<geneType>::checkChromosomeLengths(const Population& pop) const
+    {
         for (const auto& sol : pop)
         {
             if (sol.chromosome.size() != chrom_len_)
@@ -1243,6 +2327,8 @@ namespace genetic_algorithm
     template<typename geneType>
     inline typename GA<geneType>::Population GA<geneType>::updatePopulation(Population& old_pop, CandidateVec& children)
     {
+        if (usesCustomBreeding()) return customUpdatePopulation(old_pop, children);
+
         switch (mode_)
         {
             case Mode::single_objective:
@@ -1268,6 +2354,10 @@ namespace genetic_algorithm
         {
             throw std::invalid_argument("The stall stop conditions only work with the single-objective algorithm.");
         }
+        else if (mode_ == Mode::single_objective && stop_condition_ == StopCondition::hypervolume_stall)
+        {
+            throw std::invalid_argument("The hypervolume stall stop condition only works with the multi-objective algorithms.");
+        }
 
         /* Always stop when reaching max_gen regardless of stop condition. */
         if (generation_cntr_ >= max_gen_ - 1) return true;
@@ -1284,11 +2374,14 @@ namespace genetic_algorithm
                 return std::any_of(population_.begin(), population_.end(),
                 [this](const Candidate& sol)
                 {
-                    return detail::paretoCompare(fitness_reference_, sol.fitness);
+                    /* The fitness values of the infeasible candidates are penalty values. */
+                    return sol.constraint_violation == 0.0 && detail::paretoCompare(fitness_reference_.data(), sol.fitness.data(), sol.fitness.size());
                 });
 
             case StopCondition::fitness_evals:
-                return num_fitness_evals_ >= max_fitness_evals_;
+            case StopCondition::time_budget:
+            case StopCondition::cpu_budget:
+                return budgetExhausted();
 
             case StopCondition::fitness_mean_stall:
                 if (generation_cntr_ >= stall_gen_count_)
@@ -1310,23 +2403,72 @@ namespace genetic_algorithm
                 }
                 else return false;
 
+            case StopCondition::hypervolume_stall:
+                if (generation_cntr_ >= stall_gen_count_)
+                {
+                    metric_now = hv_history_[generation_cntr_];
+                    metric_old = hv_history_[generation_cntr_ - stall_gen_count_];
+
+                    return (metric_now - metric_old) < stall_threshold_ * std::abs(metric_old);
+                }
+                else return false;
+
             default:
                 assert(false);    /* Invalid stop condition. Shouldn't get here. */
                 std::abort();
         }
     }
 
+    template<typename geneType>
+    inline bool GA<geneType>::budgetExhausted() const
+    {
+        switch (stop_condition_)
+        {
+            case StopCondition::fitness_evals:
+                return num_fitness_evals_ >= max_fitness_evals_;
+
+            case StopCondition::time_budget:
+                return std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start_time_).count() >= time_budget_;
+
+            case StopCondition::cpu_budget:
+                return double(std::clock() - run_start_cpu_time_) / CLOCKS_PER_SEC >= cpu_budget_;
+
+            default:
+                return false;
+        }
+    }
+
     template<typename geneType>
     inline void GA<geneType>::updateStats(const Population& pop)
     {
+        /* The fitness values of the infeasible candidates are penalty values, so only the feasible candidates are used. */
+        Population feasible_pop;
+        if (constraintFunction != nullptr)
+        {
+            std::copy_if(pop.begin(), pop.end(), std::back_inserter(feasible_pop), [](const Candidate& sol) { return sol.constraint_violation == 0.0; });
+        }
+        const Population& stats_pop = (constraintFunction != nullptr) ? feasible_pop : pop;
+
         switch (mode_)
         {
             case Mode::single_objective:
-                soga_history_.add(fitnessMean(pop), fitnessSD(pop), fitnessMin(pop)[0], fitnessMax(pop)[0]);
+                if (stats_pop.empty())
+                {
+                    /* There are no feasible candidates in the population. */
+                    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+                    soga_history_.add(nan, nan, nan, nan);
+                }
+                else
+                {
+                    soga_history_.add(fitnessMean(stats_pop), fitnessSD(stats_pop), fitnessMin(stats_pop)[0], fitnessMax(stats_pop)[0]);
+                }
                 break;
             case Mode::multi_objective_sorting:
-                break;
             case Mode::multi_objective_decomp:
+                if (track_hypervolume || stop_condition_ == StopCondition::hypervolume_stall)
+                {
+                    hv_history_.push_back(stats_pop.empty() ? 0.0 : populationHypervolume(stats_pop));
+                }
                 break;
             default:
                 assert(false);    /* Invalid mode, shouldn't get here. */
@@ -1334,6 +2476,235 @@ namespace genetic_algorithm
         }
     }
 
+    template<typename geneType>
+    inline void GA<geneType>::eraseUnevaluated(Population& pop)
+    {
+        std::erase_if(pop, [](const Candidate& sol) { return !sol.is_evaluated; });
+    }
+
+    template<typename geneType>
+    inline std::vector<size_t> GA<geneType>::orderByFitness(Population& pop) const
+    {
+        using namespace std;
+
+        vector<size_t> order;
+        order.reserve(pop.size());
+        if (mode_ == Mode::single_objective)
+        {
+            order.resize(pop.size());
+            iota(order.begin(), order.end(), size_t{ 0 });
+            sort(order.begin(), order.end(), [&pop](size_t lidx, size_t ridx) { return pop[lidx].fitness[0] > pop[ridx].fitness[0]; });
+        }
+        else
+        {
+            /* The ranks of the candidates are also set by the sorting. The order is random inside a front. */
+            for (auto& front : nonDominatedSort(pop))
+            {
+                shuffle(front.begin(), front.end(), rng::prng);
+                order.insert(order.end(), front.begin(), front.end());
+            }
+        }
+
+        return order;
+    }
+
+    template<typename geneType>
+    inline auto GA<geneType>::screenChildren(CandidateVec& children) -> std::vector<FitnessVector>
+    {
+        using namespace std;
+
+        if (surrogate_.size() == 0) return {};
+
+        vector<size_t> unevaluated;
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            if (!children[i].is_evaluated) unevaluated.push_back(i);
+        }
+        if (unevaluated.empty()) return {};
+
+        /* Predict the fitness of the children which need to be evaluated. The predictions are stored in a temporary population for the sorting. */
+        Population predicted(unevaluated.size());
+        vector<size_t> indices(unevaluated.size());
+        iota(indices.begin(), indices.end(), size_t{ 0 });
+        for_each(execution::par_unseq, indices.begin(), indices.end(),
+        [&, this](size_t idx)
+        {
+            vector<double> fx = surrogate_.predict(children[unevaluated[idx]].chromosome);
+            predicted[idx].fitness.assign(fx.begin(), fx.end());
+        });
+
+        /* Order the children by their predicted fitness, the most promising ones first. */
+        vector<size_t> order = orderByFitness(predicted);
+
+        size_t num_kept = size_t(ceil(surrogate_eval_fraction_ * unevaluated.size()));
+        num_kept = clamp(num_kept, size_t{ 1 }, unevaluated.size());
+
+        surrogate_stats_.num_predictions += unevaluated.size();
+        surrogate_stats_.num_skipped_evals += unevaluated.size() - num_kept;
+
+        /* Keep the children which were already evaluated, and the most promising ones of the rest. */
+        vector<bool> discard(children.size(), false);
+        for (size_t i = num_kept; i < order.size(); i++) discard[unevaluated[order[i]]] = true;
+
+        vector<FitnessVector> child_predictions(children.size());
+        for (size_t i = 0; i < unevaluated.size(); i++) child_predictions[unevaluated[i]] = move(predicted[i].fitness);
+
+        size_t num_children = 0;
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            if (discard[i]) continue;
+            if (num_children != i)
+            {
+                children[num_children] = move(children[i]);
+                child_predictions[num_children] = move(child_predictions[i]);
+            }
+            num_children++;
+        }
+        children.resize(num_children);
+        child_predictions.resize(num_children);
+
+        return child_predictions;
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::updateSurrogate(const CandidateVec& children, const std::vector<FitnessVector>& predictions)
+    {
+        assert(predictions.empty() || predictions.size() == children.size());
+
+        /* The accuracy of the predictions for the evaluated children. */
+        std::vector<size_t> predicted;
+        for (size_t i = 0; i < predictions.size(); i++)
+        {
+            if (!predictions[i].empty() && children[i].is_evaluated) predicted.push_back(i);
+        }
+        if (!predicted.empty())
+        {
+            double rank_correlation = 0.0;
+            double rmse = 0.0;
+            for (size_t obj = 0; obj < num_objectives_; obj++)
+            {
+                std::vector<double> fpred, freal;
+                for (size_t idx : predicted)
+                {
+                    fpred.push_back(predictions[idx][obj]);
+                    freal.push_back(children[idx].fitness[obj]);
+                }
+                double squared_error = 0.0;
+                for (size_t i = 0; i < fpred.size(); i++) squared_error += (fpred[i] - freal[i]) * (fpred[i] - freal[i]);
+
+                rank_correlation += detail::rankCorrelation(fpred, freal);
+                rmse += std::sqrt(squared_error / fpred.size());
+            }
+            surrogate_stats_.rank_correlation.push_back(rank_correlation / num_objectives_);
+            surrogate_stats_.rmse.push_back(rmse / num_objectives_);
+        }
+
+        /* Add the newly evaluated children to the model. */
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            bool is_new = predictions.empty() || !predictions[i].empty();
+            if (is_new && children[i].is_evaluated && children[i].constraint_violation == 0.0) surrogate_.add(children[i].chromosome, children[i].fitness);
+        }
+    }
+
+    template<typename geneType>
+    inline void GA<geneType>::promoteChildren(CandidateVec& children, std::vector<FitnessVector>& predictions)
+    {
+        using namespace std;
+        assert(predictions.empty() || predictions.size() == children.size());
+
+        for (size_t level = lowFidelityFunctions.size(); level > 0; level--)
+        {
+            const fitnessFunction_t& fitness_f = lowFidelityFunctions[level - 1];
+
+            /* The children which were already evaluated by the fitness function don't need to be promoted. */
+            vector<size_t> unevaluated;
+            for (size_t i = 0; i < children.size(); i++)
+            {
+                if (!children[i].is_evaluated) unevaluated.push_back(i);
+            }
+            if (unevaluated.empty()) return;
+
+            /* Evaluate the children at this fidelity level. The results are stored in a temporary population for the sorting. */
+            Population evaluated(unevaluated.size());
+            vector<size_t> indices(unevaluated.size());
+            iota(indices.begin(), indices.end(), size_t{ 0 });
+            for_each(execution::par_unseq, indices.begin(), indices.end(),
+            [&, this](size_t idx)
+            {
+                if (cancellation_token_.cancelled()) return;
+                vector<double> fx = fitness_f(children[unevaluated[idx]].chromosome);
+                evaluated[idx].fitness.assign(fx.begin(), fx.end());
+                evaluated[idx].is_evaluated = true;
+            });
+            if (cancellation_token_.cancelled()) return;    /* The children stay unevaluated. */
+
+            checkFitnessValues(evaluated);
+            num_low_fidelity_evals_[level - 1] += unevaluated.size();
+
+            /* Promote the most promising children at this level, and discard the rest. */
+            vector<size_t> order = orderByFitness(evaluated);
+
+            size_t num_promoted = size_t(ceil(promotion_fraction_ * unevaluated.size()));
+            if (mode_ != Mode::single_objective)
+            {
+                size_t num_nondominated = size_t(count_if(evaluated.begin(), evaluated.end(), [](const Candidate& sol) { return sol.rank == 0; }));
+                num_promoted = max(num_promoted, num_nondominated);
+            }
+            num_promoted = clamp(num_promoted, size_t{ 1 }, unevaluated.size());
+
+            vector<bool> discard(children.size(), false);
+            for (size_t i = num_promoted; i < order.size(); i++) discard[unevaluated[order[i]]] = true;
+
+            size_t num_children = 0;
+            for (size_t i = 0; i < children.size(); i++)
+            {
+                if (discard[i]) continue;
+                if (num_children != i)
+                {
+                    children[num_children] = move(children[i]);
+                    if (!predictions.empty()) predictions[num_children] = move(predictions[i]);
+                }
+                num_children++;
+            }
+            children.resize(num_children);
+            if (!predictions.empty()) predictions.resize(num_children);
+        }
+    }
+
+    template<typename geneType>
+    inline double GA<geneType>::populationHypervolume(const Population& pop)
+    {
+        assert(!pop.empty());
+
+        std::vector<std::vector<double>> fitness_vecs;
+        fitness_vecs.reserve(pop.size());
+        for (const auto& sol : pop) fitness_vecs.push_back(sol.fitness);
+
+        /* Determine the reference point from the first (initial) population if it wasn't set. */
+        if (hv_ref_point_.empty())
+        {
+            std::vector<double> fmin = fitness_vecs[0];
+            std::vector<double> fmax = fitness_vecs[0];
+            for (const auto& fvec : fitness_vecs)
+            {
+                for (size_t i = 0; i < num_objectives_; i++)
+                {
+                    fmin[i] = std::min(fmin[i], fvec[i]);
+                    fmax[i] = std::max(fmax[i], fvec[i]);
+                }
+            }
+            hv_ref_point_.resize(num_objectives_);
+            for (size_t i = 0; i < num_objectives_; i++)
+            {
+                double range = fmax[i] - fmin[i];
+                hv_ref_point_[i] = fmin[i] - ((range > 0.0) ? 0.1 * range : 1.0);
+            }
+        }
+
+        return detail::hypervolume(std::move(fitness_vecs), hv_ref_point_);
+    }
+
     template<typename geneType>
     inline void GA<geneType>::sogaCalcRouletteWeights(Population& pop)
     {
@@ -1576,59 +2947,92 @@ namespace genetic_algorithm
     {
         using namespace std;
 
-        /* Calc the number of candidates which dominate each candidate, and the indices of the candidates it dominates. */
-        vector<size_t> dom_count(pop.size(), 0);
-        vector<vector<size_t>> dom_list(pop.size());
-
+        /*
+        * Constrained domination: the feasible candidates are sorted by Pareto dominance, while the infeasible ones are placed
+        * in the fronts after them based only on their constraint violations, with equal violations in the same front.
+        */
+        vector<size_t> feasible, infeasible;
         for (size_t i = 0; i < pop.size(); i++)
         {
-            for (size_t j = 0; j < i; j++)
+            (pop[i].constraint_violation > 0.0 ? infeasible : feasible).push_back(i);
+        }
+
+        vector<vector<size_t>> pareto_fronts;
+        if (!feasible.empty())
+        {
+            /* Calc the number of candidates which dominate each candidate, and the indices of the candidates it dominates. */
+            vector<size_t> dom_count(feasible.size(), 0);
+            vector<vector<size_t>> dom_list(feasible.size());
+
+            const detail::ObjectiveMatrix fmat = infeasible.empty() ? fitnessMatrix(pop) : fitnessMatrix(pop, feasible);
+            detail::dispatchObjectives(fmat.ncols(),
+            [&]<size_t M>(integral_constant<size_t, M>)
             {
-                if (detail::paretoCompare(pop[j].fitness, pop[i].fitness))
-                {
-                    dom_count[j]++;
-                    dom_list[i].push_back(j);
-                }
-                else if (detail::paretoCompare(pop[i].fitness, pop[j].fitness))
+                for (size_t i = 0; i < feasible.size(); i++)
                 {
-                    dom_count[i]++;
-                    dom_list[j].push_back(i);
+                    for (size_t j = 0; j < i; j++)
+                    {
+                        int comp = detail::paretoCompareThreeWay<M>(fmat[i], fmat[j], fmat.ncols());
+                        if (comp > 0)
+                        {
+                            dom_count[j]++;
+                            dom_list[i].push_back(j);
+                        }
+                        else if (comp < 0)
+                        {
+                            dom_count[i]++;
+                            dom_list[j].push_back(i);
+                        }
+                    }
                 }
-            }
-        }
+            });
 
-        /* Find the indices of all non-dominated candidates (first/best pareto front). */
-        vector<size_t> front;
-        for (size_t i = 0; i < pop.size(); i++)
-        {
-            if (dom_count[i] == 0)
+            /* Find the indices of all non-dominated candidates (first/best pareto front). */
+            vector<size_t> front;
+            for (size_t i = 0; i < feasible.size(); i++)
             {
-                front.push_back(i);
-                pop[i].rank = 0;
+                if (dom_count[i] == 0)
+                {
+                    front.push_back(i);
+                    pop[feasible[i]].rank = 0;
+                }
             }
-        }
-        /* Find all the other pareto fronts. */
-        vector<vector<size_t>> pareto_fronts;
-        size_t front_idx = 1;
-        while (!front.empty())
-        {
-            /* "Remove" the current front and find the next one. */
-            vector<size_t> next_front;
-            for (const auto& i : front)
+            /* Find all the other pareto fronts. */
+            size_t front_idx = 1;
+            while (!front.empty())
             {
-                for (const auto& j : dom_list[i])
+                /* "Remove" the current front and find the next one. */
+                vector<size_t> next_front;
+                for (const auto& i : front)
                 {
-                    /* j belongs to the next front if it's domination count will become 0. */
-                    if (--dom_count[j] == 0)
+                    for (const auto& j : dom_list[i])
                     {
-                        next_front.push_back(j);
-                        pop[j].rank = front_idx;
+                        /* j belongs to the next front if it's domination count will become 0. */
+                        if (--dom_count[j] == 0)
+                        {
+                            next_front.push_back(j);
+                            pop[feasible[j]].rank = front_idx;
+                        }
                     }
                 }
+                for (auto& i : front) i = feasible[i];
+                pareto_fronts.push_back(move(front));
+                front = move(next_front);
+                front_idx++;
             }
-            pareto_fronts.push_back(front);
-            front = next_front;
-            front_idx++;
+        }
+
+        /* The fronts of the infeasible candidates, from the lowest constraint violation to the highest. */
+        sort(infeasible.begin(), infeasible.end(),
+        [&pop](size_t lidx, size_t ridx)
+        {
+            return pop[lidx].constraint_violation < pop[ridx].constraint_violation;
+        });
+        for (size_t i = 0; i < infeasible.size(); i++)
+        {
+            if (i == 0 || pop[infeasible[i]].constraint_violation != pop[infeasible[i - 1]].constraint_violation) pareto_fronts.emplace_back();
+            pop[infeasible[i]].rank = pareto_fronts.size() - 1;
+            pareto_fronts.back().push_back(infeasible[i]);
         }
 
         return pareto_fronts;
@@ -1648,27 +3052,29 @@ namespace genetic_algorithm
             }
         }
 
+        const detail::ObjectiveMatrix fmat = fitnessMatrix(pop);
+
         for_each(execution::par_unseq, pfronts.begin(), pfronts.end(),
-        [&pop](vector<size_t>& pfront)
+        [&pop, &fmat](vector<size_t>& pfront)
         {
             /* Calc the distances in each fitness dimension. */
-            for (size_t d = 0; d < pop[0].fitness.size(); d++)
+            for (size_t d = 0; d < fmat.ncols(); d++)
             {
                 sort(pfront.begin(), pfront.end(),
-                [&pop, &d](size_t lidx, size_t ridx)
+                [&fmat, &d](size_t lidx, size_t ridx)
                 {
-                    return pop[lidx].fitness[d] < pop[ridx].fitness[d];
+                    return fmat[lidx][d] < fmat[ridx][d];
                 });
 
                 /* Calc the crowding distance for each solution. */
-                double finterval = pop[pfront.back()].fitness[d] - pop[pfront.front()].fitness[d];
+                double finterval = fmat[pfront.back()][d] - fmat[pfront.front()][d];
                 finterval = max(finterval, 1E-6);
 
                 pop[pfront.front()].distance = numeric_limits<double>::infinity();
                 pop[pfront.back()].distance = numeric_limits<double>::infinity();
                 for (size_t i = 1; i < pfront.size() - 1; i++)
                 {
-                    pop[pfront[i]].distance += (pop[pfront[i + 1]].fitness[d] - pop[pfront[i - 1]].fitness[d]) / finterval;
+                    pop[pfront[i]].distance += (fmat[pfront[i + 1]][d] - fmat[pfront[i - 1]][d]) / finterval;
                 }
             }
         });
@@ -1748,65 +3154,70 @@ namespace genetic_algorithm
     }
 
     template<typename geneType>
-    inline void GA<geneType>::updateIdealPoint(const Population& pop)
+    inline void GA<geneType>::updateIdealPoint(const detail::ObjectiveMatrix& fmat)
     {
-        assert(std::all_of(pop.begin(), pop.end(), [this](const Candidate& sol) { return sol.fitness.size() == ideal_point_.size(); }));
+        assert(fmat.ncols() == ideal_point_.size());
 
-        for (const auto& sol : pop)
+        for (size_t row = 0; row < fmat.nrows(); row++)
         {
             for (size_t i = 0; i < ideal_point_.size(); i++)
             {
-                ideal_point_[i] = std::max(ideal_point_[i], sol.fitness[i]);
+                ideal_point_[i] = std::max(ideal_point_[i], fmat[row][i]);
             }
         }
     }
 
     template<typename geneType>
-    inline void GA<geneType>::updateNadirPoint(const Population& pop)
+    inline void GA<geneType>::updateNadirPoint(const detail::ObjectiveMatrix& fmat)
     {
         using namespace std;
-        assert(!pop.empty());
-        assert(all_of(pop.begin(), pop.end(), [this, &pop](const Candidate& sol) { return sol.fitness.size() == nadir_point_.size(); }));
+        assert(!fmat.empty());
+        assert(fmat.ncols() == nadir_point_.size());
+
+        const size_t dim = fmat.ncols();
+
+        /* There are no extreme points yet before the first feasible candidates are found. */
+        const bool has_extreme_points = !extreme_points_.empty();
+        if (!has_extreme_points) extreme_points_.assign(dim, vector<double>(dim));
 
         /* Identify/update extreme points for each objective axis. */
-        for (size_t i = 0; i < nadir_point_.size(); i++)
+        for (size_t i = 0; i < dim; i++)
         {
-            vector<double> weights(nadir_point_.size(), 1E-6);
+            vector<double> weights(dim, 1E-6);
             weights[i] = 1.0;
 
             /* Find the solution or extreme point with the lowest Chebysev distance to the objective axis. */
             double dmin = numeric_limits<double>::max();
-            vector<double> argmin;
-            for (const auto& sol : pop)
+            const double* argmin = nullptr;
+            for (size_t row = 0; row < fmat.nrows(); row++)
             {
-                double d = detail::ASF(sol.fitness, ideal_point_, weights);
+                double d = detail::ASF(fmat[row], ideal_point_.data(), weights.data(), dim);
 
                 if (d < dmin)
                 {
                     dmin = d;
-                    argmin = sol.fitness;
+                    argmin = fmat[row];
                 }
             }
 
-            /* There are no extreme points yet in the first generation. */
-            if (generation_cntr_ != 0)
+            if (has_extreme_points)
             {
                 for (const auto& extreme_point : extreme_points_)
                 {
-                    double d = detail::ASF(extreme_point, ideal_point_, weights);
+                    double d = detail::ASF(extreme_point.data(), ideal_point_.data(), weights.data(), dim);
                     if (d < dmin)
                     {
                         dmin = d;
-                        argmin = extreme_point;
+                        argmin = extreme_point.data();
                     }
                 }
             }
 
-            extreme_points_[i] = argmin;
+            if (argmin != extreme_points_[i].data()) extreme_points_[i].assign(argmin, argmin + dim);
         }
 
         /* Find minimum of extreme points along each objective (nadir point). */
-        for (size_t i = 0; i < nadir_point_.size(); i++)
+        for (size_t i = 0; i < dim; i++)
         {
             nadir_point_[i] = extreme_points_[0][i];
             for (size_t j = 1; j < extreme_points_.size(); j++)
@@ -1817,51 +3228,89 @@ namespace genetic_algorithm
     }
 
     template<typename geneType>
-    inline void GA<geneType>::associatePopToRefs(Population& pop, const std::vector<std::vector<double>>& ref_points)
+    inline void GA<geneType>::associatePopToRefs(Population& pop, const detail::ObjectiveMatrix& ref_points)
     {
         using namespace std;
         assert(!pop.empty());
         assert(all_of(pop.begin(), pop.end(), [&pop](const Candidate& sol) { return sol.fitness.size() == pop[0].fitness.size(); }));
+        assert(ref_points.ncols() == pop[0].fitness.size());
 
-        updateIdealPoint(pop);
-        updateNadirPoint(pop);
+        const size_t dim = pop[0].fitness.size();
 
-        vector<vector<double>> fnorms(pop.size(), vector<double>(pop[0].fitness.size(), 0.0));    /* Don't change the actual fitness values. */
+        /* Don't change the actual fitness values, the normalized values are stored separately. */
+        fnorms_.resize(pop.size(), dim);
+        for (size_t row = 0; row < pop.size(); row++)
+        {
+            copy(pop[row].fitness.begin(), pop[row].fitness.end(), fnorms_[row]);
+        }
 
-        transform(execution::par_unseq, pop.begin(), pop.end(), fnorms.begin(), fnorms.begin(),
-        [this](const Candidate& sol, vector<double>& fnorm) -> vector<double>
+        /* The infeasible candidates aren't used for the normalization, and they aren't associated with any reference point. */
+        vector<size_t> feasible;
+        for (size_t i = 0; i < pop.size(); i++)
         {
-            for (size_t i = 0; i < sol.fitness.size(); i++)
-            {
-                fnorm[i] = sol.fitness[i] - ideal_point_[i];
-                fnorm[i] /= min(nadir_point_[i] - ideal_point_[i], -1E-6);
-            }
+            if (pop[i].constraint_violation == 0.0) feasible.push_back(i);
+        }
+        if (feasible.empty())
+        {
+            for (auto& sol : pop) tie(sol.ref_idx, sol.distance) = make_pair(size_t{ 0 }, numeric_limits<double>::infinity());
+            return;
+        }
+        if (feasible.size() == pop.size())
+        {
+            updateIdealPoint(fnorms_);
+            updateNadirPoint(fnorms_);
+        }
+        else
+        {
+            const detail::ObjectiveMatrix feasible_fmat = fitnessMatrix(pop, feasible);
+            updateIdealPoint(feasible_fmat);
+            updateNadirPoint(feasible_fmat);
+        }
 
-            return fnorm;
-        });
+        vector<double> scale(dim);
+        for (size_t i = 0; i < dim; i++)
+        {
+            scale[i] = 1.0 / min(nadir_point_[i] - ideal_point_[i], -1E-6);
+        }
 
-        /* Associate each candidate with the closest reference point. */
-        transform(execution::par_unseq, pop.begin(), pop.end(), fnorms.begin(), pop.begin(),
-        [&ref_points](Candidate& sol, const vector<double>& f) -> Candidate
+        /* Normalize the fitness values and associate each candidate with the closest reference point. */
+        detail::dispatchObjectives(dim,
+        [&]<size_t M>(integral_constant<size_t, M>)
         {
-            tie(sol.ref_idx, sol.distance) = detail::findClosestRef(ref_points, f);
-            return sol;
+            for_each(execution::par_unseq, pop.begin(), pop.end(),
+            [&](Candidate& sol)
+            {
+                if (sol.constraint_violation > 0.0)
+                {
+                    tie(sol.ref_idx, sol.distance) = make_pair(size_t{ 0 }, numeric_limits<double>::infinity());
+                    return;
+                }
+
+                double* fnorm = fnorms_[size_t(&sol - pop.data())];
+                for (size_t i = 0; i < dim; i++)
+                {
+                    fnorm[i] = (fnorm[i] - ideal_point_[i]) * scale[i];
+                }
+
+                tie(sol.ref_idx, sol.distance) = detail::findClosestRef<M>(ref_points, fnorm);
+            });
         });
     }
 
     template<typename geneType>
     inline std::vector<size_t> GA<geneType>::calcNicheCounts(Population& pop, const std::vector<std::vector<double>>& ref_points)
     {
+        /* The infeasible candidates aren't associated with the reference points. */
         std::vector<size_t> niche_counts(ref_points.size(), 0U);
         for (const auto& sol : pop)
         {
-            niche_counts[sol.ref_idx]++;
+            if (sol.constraint_violation == 0.0) niche_counts[sol.ref_idx]++;
         }
 
         /* Assign the niche counts to the candidates too. */
         for (auto& sol : pop)
         {
-            sol.niche_count = niche_counts[sol.ref_idx];
+            sol.niche_count = (sol.constraint_violation == 0.0) ? niche_counts[sol.ref_idx] : 0;
         }
 
         return niche_counts;
@@ -1901,7 +3350,7 @@ namespace genetic_algorithm
 
         old_pop.insert(old_pop.end(), make_move_iterator(children.begin()), make_move_iterator(children.end()));
         vector<vector<size_t>> pareto_fronts = nonDominatedSort(old_pop);
-        associatePopToRefs(old_pop, ref_points_);
+        associatePopToRefs(old_pop, ref_matrix_);
 
         /* Add entire fronts while possible. */
         size_t front_idx = 0;
@@ -1913,54 +3362,68 @@ namespace genetic_algorithm
             }
             front_idx++;
         }
-        vector<size_t> niche_counts = calcNicheCounts(new_pop, ref_points_);
 
-        /* Add remaining candidates from the partial front if there is one. */
-        vector<size_t> partial_front = pareto_fronts[front_idx];
-        while (new_pop.size() != population_size_)
+        /* Niche counts of the ref points, only counting the candidates already added to new_pop. */
+        vector<size_t> niche_counts(ref_points_.size(), 0U);
+        for (const auto& sol : new_pop)
         {
-            /* Find the lowest niche count in the partial front. */
-            size_t min_count = population_size_;
-            for (const auto& idx : partial_front)
+            if (sol.constraint_violation == 0.0) niche_counts[sol.ref_idx]++;
+        }
+
+        if (new_pop.size() != population_size_ && old_pop[pareto_fronts[front_idx][0]].constraint_violation > 0.0)
+        {
+            /* The candidates of an infeasible front all have the same constraint violation, so any of them can be added. */
+            vector<size_t>& partial_front = pareto_fronts[front_idx];
+            shuffle(partial_front.begin(), partial_front.end(), rng::prng);
+            for (size_t i = 0; new_pop.size() != population_size_; i++)
             {
-                min_count = min(min_count, niche_counts[old_pop[idx].ref_idx]);
+                new_pop.push_back(move(old_pop[partial_front[i]]));
             }
-
-            /* Find the reference points with minimal niche counts, and pick one. */
-            vector<size_t> refs = {};
-            for (const auto& idx : partial_front)
+        }
+        else if (new_pop.size() != population_size_)
+        {
+            /* Group the candidates of the partial front by their ref points, sorted by their distances (closest last). */
+            vector<vector<size_t>> ref_members(ref_points_.size());
+            for (const auto& idx : pareto_fronts[front_idx])
             {
-                size_t ref = old_pop[idx].ref_idx;
-                if (niche_counts[ref] == min_count && find(refs.begin(), refs.end(), ref) == refs.end())
-                {
-                    refs.push_back(ref);
-                }
+                ref_members[old_pop[idx].ref_idx].push_back(idx);
             }
-            size_t ref = refs[rng::randomIdx(refs.size())];
-
-            /* Find the idx of the closest sol in the partial front associated with this ref point. */
-            size_t sol_idx = partial_front[0];
-            double min_distance = numeric_limits<double>::infinity();
-            for (const auto& idx : partial_front)
+            for (auto& members : ref_members)
             {
-                if (old_pop[idx].ref_idx == ref && old_pop[idx].distance < min_distance)
+                sort(members.begin(), members.end(),
+                [&old_pop](size_t lidx, size_t ridx)
                 {
-                    min_distance = old_pop[idx].distance;
-                    sol_idx = idx;
-                }
+                    return old_pop[lidx].distance > old_pop[ridx].distance;
+                });
             }
 
-            /* Move this candidate to new_pop and increment the associated niche count. */
-            new_pop.push_back(move(old_pop[sol_idx]));
-            partial_front.erase(remove(partial_front.begin(), partial_front.end(), sol_idx), partial_front.end());
+            /* Min-heap of the ref points with associated candidates left, ordered by niche count. Ties are broken randomly. */
+            using RefEntry = tuple<size_t, size_t, size_t>;    /* (niche count, random tiebreak, ref idx) */
+            priority_queue<RefEntry, vector<RefEntry>, greater<RefEntry>> refs;
+            for (size_t ref = 0; ref < ref_members.size(); ref++)
+            {
+                if (!ref_members[ref].empty()) refs.emplace(niche_counts[ref], rng::prng(), ref);
+            }
 
-            niche_counts[ref]++;
-            for (auto& sol : new_pop)
+            /* Add the closest candidate of the least crowded ref point to new_pop until it is full. */
+            while (new_pop.size() != population_size_)
             {
-                if (sol.ref_idx == ref) sol.niche_count++;
+                assert(!refs.empty());
+
+                size_t ref = get<2>(refs.top());
+                refs.pop();
+
+                new_pop.push_back(move(old_pop[ref_members[ref].back()]));
+                ref_members[ref].pop_back();
+                niche_counts[ref]++;
+
+                if (!ref_members[ref].empty()) refs.emplace(niche_counts[ref], rng::prng(), ref);
             }
         }
 
+        /* Assign the final niche counts to the candidates. */
+        calcNicheCounts(new_pop, ref_points_);
+
         return new_pop;
     }
 
@@ -2121,6 +3584,36 @@ namespace genetic_algorithm
         return double(std::sqrt(variance));
     }
 
+    template<typename geneType>
+    inline detail::ObjectiveMatrix GA<geneType>::fitnessMatrix(const Population& pop)
+    {
+        assert(!pop.empty());
+        assert(std::all_of(pop.begin(), pop.end(), [&pop](const Candidate& sol) { return sol.fitness.size() == pop[0].fitness.size(); }));
+
+        detail::ObjectiveMatrix fmat(pop.size(), pop[0].fitness.size());
+        for (size_t row = 0; row < pop.size(); row++)
+        {
+            std::copy(pop[row].fitness.begin(), pop[row].fitness.end(), fmat[row]);
+        }
+
+        return fmat;
+    }
+
+    template<typename geneType>
+    inline detail::ObjectiveMatrix GA<geneType>::fitnessMatrix(const Population& pop, const std::vector<size_t>& indices)
+    {
+        assert(!indices.empty());
+        assert(std::all_of(indices.begin(), indices.end(), [&pop](size_t idx) { return idx < pop.size(); }));
+
+        detail::ObjectiveMatrix fmat(indices.size(), pop[indices[0]].fitness.size());
+        for (size_t row = 0; row < indices.size(); row++)
+        {
+            std::copy(pop[indices[row]].fitness.begin(), pop[indices[row]].fitness.end(), fmat[row]);
+        }
+
+        return fmat;
+    }
+
 } // namespace genetic_algorithm
 
 #endif // !GA_BASE_GA_H
\ No newline at end of file
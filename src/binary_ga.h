@@ -122,6 +122,12 @@ namespace genetic_algorithm
         void num_crossover_points(size_t n);
         [[nodiscard]] size_t num_crossover_points() const;
 
+        /* The genetic operators of the BinaryGA. They can also be used on their own, eg. as the operators of a StaticGA. */
+        static CandidatePair nPointCrossover(const Candidate& parent1, const Candidate& parent2, double pc, size_t n);
+        static CandidatePair uniformCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
+
+        static void standardMutate(Candidate& child, double pm);
+
     private:
 
         CrossoverMethod crossover_method_ = CrossoverMethod::single_point;
@@ -131,12 +137,6 @@ namespace genetic_algorithm
         Candidate generateCandidate() const override;
         CandidatePair crossover(const Candidate& parent1, const Candidate& parent2) const override;
         void mutate(Candidate& child) const override;
-
-        static CandidatePair nPointCrossover(const Candidate& parent1, const Candidate& parent2, double pc, size_t n);
-        static CandidatePair uniformCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
-
-        static void standardMutate(Candidate& child, double pm);
-
     };
 
 } // namespace genetic_algorithm
@@ -0,0 +1,92 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/**
+* This file contains the cancellation token class, which can be used to stop a running genetic algorithm
+* from another thread, from a signal handler, or from inside the fitness function.
+*
+* @file cancellation_token.h
+*/
+
+#ifndef GA_CANCELLATION_TOKEN_H
+#define GA_CANCELLATION_TOKEN_H
+
+#include <atomic>
+
+namespace genetic_algorithm
+{
+    /**
+    * A thread-safe flag used to request the cancellation of a run of a genetic algorithm. \n
+    * All of the member functions are lock-free, so they can also be called from signal handlers.
+    */
+    class CancellationToken
+    {
+    public:
+
+        CancellationToken() noexcept = default;
+
+        CancellationToken(const CancellationToken&) = delete;
+        CancellationToken& operator=(const CancellationToken&) = delete;
+
+        /** Request the cancellation of the run. */
+        void cancel() noexcept;
+
+        /** @returns True if the cancellation was requested. */
+        [[nodiscard]] bool cancelled() const noexcept;
+
+        /** Clear the cancellation request. */
+        void reset() noexcept;
+
+    private:
+
+        std::atomic<bool> cancelled_ = false;
+
+        static_assert(std::atomic<bool>::is_always_lock_free, "The cancellation token must be lock-free to be usable in signal handlers.");
+    };
+
+} // namespace genetic_algorithm
+
+
+/* IMPLEMENTATION */
+
+namespace genetic_algorithm
+{
+    inline void CancellationToken::cancel() noexcept
+    {
+        cancelled_.store(true, std::memory_order_release);
+    }
+
+    inline bool CancellationToken::cancelled() const noexcept
+    {
+        return cancelled_.load(std::memory_order_acquire);
+    }
+
+    inline void CancellationToken::reset() noexcept
+    {
+        cancelled_.store(false, std::memory_order_release);
+    }
+
+} // namespace genetic_algorithm
+
+#endif // !GA_CANCELLATION_TOKEN_H
\ No newline at end of file
@@ -0,0 +1,566 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/*
+* This file contains the covariance matrix adaptation evolution strategy (CMA-ES)
+* used by the CMA-ES mode of the real-coded genetic algorithm.
+*/
+
+#ifndef GA_CMA_ES_H
+#define GA_CMA_ES_H
+
+#include <vector>
+#include <cstddef>
+
+namespace genetic_algorithm::detail
+{
+    /*
+    * The state of a (mu/mu_w, lambda)-CMA-ES maximizing a function, with the points stored in row-major (lambda x dim) matrices. \n
+    * In the separable mode (sep-CMA-ES), only the diagonal of the covariance matrix is adapted, so the cost of each generation
+    * is linear in the number of dimensions instead of quadratic (and cubic for the eigendecomposition).
+    */
+    class CmaEs
+    {
+    public:
+
+        CmaEs(std::vector<double> mean, double sigma, size_t lambda, bool separable);
+
+        /* Sample lambda new points from the current distribution into xs. */
+        void sample(std::vector<double>& xs) const;
+
+        /*
+        * Update the distribution using the points in xs and their fitness values. The points may differ from the sampled
+        * ones (e.g. if they were repaired to be inside the bounds), the update uses the points in xs.
+        */
+        void update(const std::vector<double>& xs, const std::vector<double>& fvals);
+
+        /* True if the search has converged or the distribution became ill-conditioned, so the search should be restarted. */
+        [[nodiscard]] bool shouldRestart() const noexcept;
+
+        [[nodiscard]] size_t dim() const noexcept { return dim_; }
+        [[nodiscard]] size_t lambda() const noexcept { return lambda_; }
+        [[nodiscard]] double sigma() const noexcept { return sigma_; }
+
+    private:
+
+        size_t dim_;
+        size_t lambda_;
+        size_t mu_;
+        bool separable_;
+
+        /* The strategy parameters. */
+        std::vector<double> weights_;
+        double mueff_;
+        double cc_, cs_, c1_, cmu_, damps_, chin_;
+
+        /* The state of the distribution. */
+        std::vector<double> mean_;
+        double sigma_;
+        std::vector<double> pc_;
+        std::vector<double> ps_;
+        std::vector<double> C_;     /* The covariance matrix (row-major), or only its diagonal in the separable mode. */
+        std::vector<double> B_;     /* The eigenvectors of C (in the columns, row-major). Not used in the separable mode. */
+        std::vector<double> D_;     /* The square roots of the eigenvalues of C (the standard deviations along the eigenvectors). */
+        std::vector<double> BD_;    /* B * diag(D), used for sampling. */
+
+        size_t generation_ = 0;
+        size_t eigen_generation_ = 0;
+        std::vector<double> best_history_;  /* The best fitness value of each generation. */
+        double fitness_range_ = 0.0;        /* The range of the fitness values in the last generation. */
+
+        void updateEigensystem();
+        void updateCovarianceFull(const std::vector<double>& ys, double hsig);
+        void updateCovarianceSeparable(const std::vector<double>& ys, double hsig);
+    };
+
+    /*
+    * Compute the eigendecomposition of the symmetric (n x n, row-major) matrix in V using Householder tridiagonalization
+    * and the QL algorithm. On return, V contains the eigenvectors in its columns, and d contains the eigenvalues.
+    */
+    inline void symmetricEigen(std::vector<double>& V, std::vector<double>& d, size_t n);
+
+} // namespace genetic_algorithm::detail
+
+
+/* IMPLEMENTATION */
+
+#include "rng.h"
+#include <algorithm>
+#include <numeric>
+#include <execution>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+namespace genetic_algorithm::detail
+{
+    inline CmaEs::CmaEs(std::vector<double> mean, double sigma, size_t lambda, bool separable)
+        : dim_(mean.size()), lambda_(lambda), mu_(lambda / 2), separable_(separable), mean_(std::move(mean)), sigma_(sigma)
+    {
+        using namespace std;
+        assert(dim_ > 0);
+        assert(lambda_ >= 2);
+        assert(sigma_ > 0.0);
+
+        double n = double(dim_);
+
+        weights_.resize(mu_);
+        for (size_t i = 0; i < mu_; i++) weights_[i] = log((lambda_ + 1.0) / 2.0) - log(i + 1.0);
+        double wsum = accumulate(weights_.begin(), weights_.end(), 0.0);
+        for (auto& w : weights_) w /= wsum;
+        mueff_ = 1.0 / inner_product(weights_.begin(), weights_.end(), weights_.begin(), 0.0);
+
+        cc_ = (4.0 + mueff_ / n) / (n + 4.0 + 2.0 * mueff_ / n);
+        cs_ = (mueff_ + 2.0) / (n + mueff_ + 5.0);
+        c1_ = 2.0 / ((n + 1.3) * (n + 1.3) + mueff_);
+        cmu_ = min(1.0 - c1_, 2.0 * (mueff_ - 2.0 + 1.0 / mueff_) / ((n + 2.0) * (n + 2.0) + mueff_));
+        if (separable_)
+        {
+            /* The learning rates can be larger when only the diagonal is adapted (Ros and Hansen, 2008). */
+            c1_ = min(1.0, c1_ * (n + 2.0) / 3.0);
+            cmu_ = min(1.0 - c1_, cmu_ * (n + 2.0) / 3.0);
+        }
+        damps_ = 1.0 + 2.0 * max(0.0, sqrt((mueff_ - 1.0) / (n + 1.0)) - 1.0) + cs_;
+        chin_ = sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+        pc_.assign(dim_, 0.0);
+        ps_.assign(dim_, 0.0);
+        D_.assign(dim_, 1.0);
+        if (separable_)
+        {
+            C_.assign(dim_, 1.0);
+        }
+        else
+        {
+            C_.assign(dim_ * dim_, 0.0);
+            B_.assign(dim_ * dim_, 0.0);
+            for (size_t i = 0; i < dim_; i++) C_[i * dim_ + i] = B_[i * dim_ + i] = 1.0;
+            BD_ = B_;
+        }
+    }
+
+    inline void CmaEs::sample(std::vector<double>& xs) const
+    {
+        using namespace std;
+
+        xs.resize(lambda_ * dim_);
+
+        vector<size_t> indices(lambda_);
+        iota(indices.begin(), indices.end(), size_t{ 0 });
+        for_each(execution::par_unseq, indices.begin(), indices.end(),
+        [&xs, this](size_t k)
+        {
+            vector<double> z(dim_);
+            for (auto& zi : z) zi = rng::randomNormal<double>();
+
+            double* x = &xs[k * dim_];
+            if (separable_)
+            {
+                for (size_t i = 0; i < dim_; i++) x[i] = mean_[i] + sigma_ * D_[i] * z[i];
+            }
+            else
+            {
+                /* x = m + sigma * B * D * z */
+                for (size_t i = 0; i < dim_; i++)
+                {
+                    const double* bd_row = &BD_[i * dim_];
+                    double y = 0.0;
+                    for (size_t j = 0; j < dim_; j++) y += bd_row[j] * z[j];
+                    x[i] = mean_[i] + sigma_ * y;
+                }
+            }
+        });
+    }
+
+    inline void CmaEs::update(const std::vector<double>& xs, const std::vector<double>& fvals)
+    {
+        using namespace std;
+        assert(xs.size() == lambda_ * dim_);
+        assert(fvals.size() == lambda_);
+
+        vector<size_t> order(lambda_);
+        iota(order.begin(), order.end(), size_t{ 0 });
+        sort(order.begin(), order.end(), [&fvals](size_t lidx, size_t ridx) { return fvals[lidx] > fvals[ridx]; });
+
+        best_history_.push_back(fvals[order.front()]);
+        fitness_range_ = fvals[order.front()] - fvals[order.back()];
+
+        /* The steps of the points from the old mean, y_k = (x_k - m) / sigma. Only the mu best are needed. */
+        vector<double> ys(mu_ * dim_);
+        for (size_t k = 0; k < mu_; k++)
+        {
+            const double* x = &xs[order[k] * dim_];
+            double* y = &ys[k * dim_];
+            for (size_t i = 0; i < dim_; i++) y[i] = (x[i] - mean_[i]) / sigma_;
+        }
+
+        /* The weighted mean of the steps, and the new mean. */
+        vector<double> yw(dim_, 0.0);
+        for (size_t k = 0; k < mu_; k++)
+        {
+            const double* y = &ys[k * dim_];
+            for (size_t i = 0; i < dim_; i++) yw[i] += weights_[k] * y[i];
+        }
+        for (size_t i = 0; i < dim_; i++) mean_[i] += sigma_ * yw[i];
+
+        /* Update the evolution path of sigma using C^(-1/2) * yw = B * D^-1 * B^T * yw. */
+        vector<double> cinv_yw(dim_);
+        if (separable_)
+        {
+            for (size_t i = 0; i < dim_; i++) cinv_yw[i] = yw[i] / D_[i];
+        }
+        else
+        {
+            vector<double> tmp(dim_, 0.0);
+            for (size_t j = 0; j < dim_; j++)
+            {
+                const double* b_row = &B_[j * dim_];
+                for (size_t i = 0; i < dim_; i++) tmp[i] += b_row[i] * yw[j];
+            }
+            for (size_t i = 0; i < dim_; i++) tmp[i] /= D_[i];
+            for (size_t i = 0; i < dim_; i++)
+            {
+                const double* b_row = &B_[i * dim_];
+                cinv_yw[i] = inner_product(b_row, b_row + dim_, tmp.begin(), 0.0);
+            }
+        }
+        double cs_coef = sqrt(cs_ * (2.0 - cs_) * mueff_);
+        for (size_t i = 0; i < dim_; i++) ps_[i] = (1.0 - cs_) * ps_[i] + cs_coef * cinv_yw[i];
+
+        generation_++;
+        double ps_norm = sqrt(inner_product(ps_.begin(), ps_.end(), ps_.begin(), 0.0));
+        double hsig_threshold = (1.4 + 2.0 / (dim_ + 1.0)) * chin_ * sqrt(1.0 - pow(1.0 - cs_, 2.0 * generation_));
+        double hsig = (ps_norm < hsig_threshold) ? 1.0 : 0.0;
+
+        /* Update the evolution path of C. */
+        double cc_coef = hsig * sqrt(cc_ * (2.0 - cc_) * mueff_);
+        for (size_t i = 0; i < dim_; i++) pc_[i] = (1.0 - cc_) * pc_[i] + cc_coef * yw[i];
+
+        if (separable_)
+        {
+            updateCovarianceSeparable(ys, hsig);
+        }
+        else
+        {
+            updateCovarianceFull(ys, hsig);
+        }
+
+        sigma_ *= exp(min(1.0, (cs_ / damps_) * (ps_norm / chin_ - 1.0)));
+
+        /* The eigendecomposition is only updated periodically, so its cost is amortized over several generations. */
+        if (separable_)
+        {
+            for (size_t i = 0; i < dim_; i++) D_[i] = sqrt(max(C_[i], 0.0));
+        }
+        else if (double(generation_ - eigen_generation_) > lambda_ / ((c1_ + cmu_) * dim_ * 10.0))
+        {
+            updateEigensystem();
+        }
+    }
+
+    inline void CmaEs::updateCovarianceSeparable(const std::vector<double>& ys, double hsig)
+    {
+        double decay = 1.0 - c1_ - cmu_ + (1.0 - hsig) * c1_ * cc_ * (2.0 - cc_);
+        for (size_t i = 0; i < dim_; i++)
+        {
+            double rank_mu = 0.0;
+            for (size_t k = 0; k < mu_; k++) rank_mu += weights_[k] * ys[k * dim_ + i] * ys[k * dim_ + i];
+            C_[i] = decay * C_[i] + c1_ * pc_[i] * pc_[i] + cmu_ * rank_mu;
+        }
+    }
+
+    inline void CmaEs::updateCovarianceFull(const std::vector<double>& ys, double hsig)
+    {
+        using namespace std;
+
+        /*
+        * C = decay * C + c1 * pc * pc^T + cmu * Y^T * W * Y
+        * The rank-mu update is computed like a symmetric rank-k update: the steps are transposed so the inner products
+        * are over contiguous memory, and the upper triangle of C is computed in blocks that fit in the cache.
+        */
+        vector<double> yt(dim_ * mu_);      /* Y^T */
+        vector<double> ywt(dim_ * mu_);     /* (W * Y)^T */
+        for (size_t k = 0; k < mu_; k++)
+        {
+            for (size_t i = 0; i < dim_; i++)
+            {
+                yt[i * mu_ + k] = ys[k * dim_ + i];
+                ywt[i * mu_ + k] = weights_[k] * ys[k * dim_ + i];
+            }
+        }
+
+        double decay = 1.0 - c1_ - cmu_ + (1.0 - hsig) * c1_ * cc_ * (2.0 - cc_);
+        constexpr size_t block_size = 64;
+        size_t num_blocks = (dim_ + block_size - 1) / block_size;
+
+        vector<size_t> row_blocks(num_blocks);
+        iota(row_blocks.begin(), row_blocks.end(), size_t{ 0 });
+        for_each(execution::par_unseq, row_blocks.begin(), row_blocks.end(),
+        [&, this](size_t ib)
+        {
+            size_t i_first = ib * block_size;
+            size_t i_last = min(i_first + block_size, dim_);
+            for (size_t jb = ib; jb < num_blocks; jb++)
+            {
+                size_t j_first = jb * block_size;
+                size_t j_last = min(j_first + block_size, dim_);
+                for (size_t i = i_first; i < i_last; i++)
+                {
+                    const double* yi = &yt[i * mu_];
+                    for (size_t j = max(i, j_first); j < j_last; j++)
+                    {
+                        const double* ywj = &ywt[j * mu_];
+                        double rank_mu = 0.0;
+                        for (size_t k = 0; k < mu_; k++) rank_mu += yi[k] * ywj[k];
+
+                        C_[i * dim_ + j] = decay * C_[i * dim_ + j] + c1_ * pc_[i] * pc_[j] + cmu_ * rank_mu;
+                    }
+                }
+            }
+        });
+
+        /* Mirror the upper triangle. */
+        for (size_t i = 1; i < dim_; i++)
+        {
+            for (size_t j = 0; j < i; j++) C_[i * dim_ + j] = C_[j * dim_ + i];
+        }
+    }
+
+    inline void CmaEs::updateEigensystem()
+    {
+        using namespace std;
+
+        eigen_generation_ = generation_;
+
+        B_ = C_;
+        vector<double> eigenvalues(dim_);
+        symmetricEigen(B_, eigenvalues, dim_);
+
+        for (size_t i = 0; i < dim_; i++) D_[i] = sqrt(max(eigenvalues[i], 1e-300));
+        for (size_t i = 0; i < dim_; i++)
+        {
+            for (size_t j = 0; j < dim_; j++) BD_[i * dim_ + j] = B_[i * dim_ + j] * D_[j];
+        }
+    }
+
+    inline bool CmaEs::shouldRestart() const noexcept
+    {
+        using namespace std;
+
+        if (generation_ == 0) return false;
+
+        /* TolX: the standard deviations are negligible in every coordinate. */
+        double max_sd = 0.0;
+        for (size_t i = 0; i < dim_; i++)
+        {
+            double cii = separable_ ? C_[i] : C_[i * dim_ + i];
+            max_sd = max(max_sd, sigma_ * sqrt(cii));
+        }
+        if (max_sd < 1e-12) return true;
+
+        /* ConditionCov: the covariance matrix is ill-conditioned. */
+        auto [dmin, dmax] = minmax_element(D_.begin(), D_.end());
+        if (*dmax > 1e7 * *dmin) return true;
+
+        /* TolFun: the fitness values haven't changed over the last generations. */
+        size_t history_len = 10 + size_t(ceil(30.0 * dim_ / lambda_));
+        if (best_history_.size() >= history_len)
+        {
+            auto [fmin, fmax] = minmax_element(best_history_.end() - history_len, best_history_.end());
+            if (max(*fmax - *fmin, fitness_range_) < 1e-12) return true;
+        }
+
+        /* The step size diverged. */
+        return !isfinite(sigma_) || max_sd > 1e6;
+    }
+
+    inline void symmetricEigen(std::vector<double>& V, std::vector<double>& d, size_t n)
+    {
+        using namespace std;
+        assert(V.size() == n * n);
+
+        /* Based on the tred2 and tql2 routines of the public domain JAMA library (which are derived from EISPACK). */
+        auto v = [&V, n](ptrdiff_t i, ptrdiff_t j) -> double& { return V[i * n + j]; };
+        const ptrdiff_t size = ptrdiff_t(n);
+        d.resize(n);
+        vector<double> e(n, 0.0);
+
+        /* Householder reduction to tridiagonal form. */
+        for (ptrdiff_t j = 0; j < size; j++) d[j] = v(size - 1, j);
+
+        for (ptrdiff_t i = size - 1; i > 0; i--)
+        {
+            double scale = 0.0;
+            double h = 0.0;
+            for (ptrdiff_t k = 0; k < i; k++) scale += abs(d[k]);
+
+            if (scale == 0.0)
+            {
+                e[i] = d[i - 1];
+                for (ptrdiff_t j = 0; j < i; j++)
+                {
+                    d[j] = v(i - 1, j);
+                    v(i, j) = 0.0;
+                    v(j, i) = 0.0;
+                }
+            }
+            else
+            {
+                for (ptrdiff_t k = 0; k < i; k++)
+                {
+                    d[k] /= scale;
+                    h += d[k] * d[k];
+                }
+                double f = d[i - 1];
+                double g = (f > 0.0) ? -sqrt(h) : sqrt(h);
+                e[i] = scale * g;
+                h -= f * g;
+                d[i - 1] = f - g;
+                for (ptrdiff_t j = 0; j < i; j++) e[j] = 0.0;
+
+                for (ptrdiff_t j = 0; j < i; j++)
+                {
+                    f = d[j];
+                    v(j, i) = f;
+                    g = e[j] + v(j, j) * f;
+                    for (ptrdiff_t k = j + 1; k <= i - 1; k++)
+                    {
+                        g += v(k, j) * d[k];
+                        e[k] += v(k, j) * f;
+                    }
+                    e[j] = g;
+                }
+                f = 0.0;
+                for (ptrdiff_t j = 0; j < i; j++)
+                {
+                    e[j] /= h;
+                    f += e[j] * d[j];
+                }
+                double hh = f / (h + h);
+                for (ptrdiff_t j = 0; j < i; j++) e[j] -= hh * d[j];
+                for (ptrdiff_t j = 0; j < i; j++)
+                {
+                    f = d[j];
+                    g = e[j];
+                    for (ptrdiff_t k = j; k <= i - 1; k++) v(k, j) -= (f * e[k] + g * d[k]);
+                    d[j] = v(i - 1, j);
+                    v(i, j) = 0.0;
+                }
+            }
+            d[i] = h;
+        }
+
+        /* Accumulate the transformations. */
+        for (ptrdiff_t i = 0; i < size - 1; i++)
+        {
+            v(size - 1, i) = v(i, i);
+            v(i, i) = 1.0;
+            double h = d[i + 1];
+            if (h != 0.0)
+            {
+                for (ptrdiff_t k = 0; k <= i; k++) d[k] = v(k, i + 1) / h;
+                for (ptrdiff_t j = 0; j <= i; j++)
+                {
+                    double g = 0.0;
+                    for (ptrdiff_t k = 0; k <= i; k++) g += v(k, i + 1) * v(k, j);
+                    for (ptrdiff_t k = 0; k <= i; k++) v(k, j) -= g * d[k];
+                }
+            }
+            for (ptrdiff_t k = 0; k <= i; k++) v(k, i + 1) = 0.0;
+        }
+        for (ptrdiff_t j = 0; j < size; j++)
+        {
+            d[j] = v(size - 1, j);
+            v(size - 1, j) = 0.0;
+        }
+        v(size - 1, size - 1) = 1.0;
+        e[0] = 0.0;
+
+        /* Symmetric tridiagonal QL algorithm. */
+        for (ptrdiff_t i = 1; i < size; i++) e[i - 1] = e[i];
+        e[size - 1] = 0.0;
+
+        double f = 0.0;
+        double tst1 = 0.0;
+        const double eps = numeric_limits<double>::epsilon();
+        for (ptrdiff_t l = 0; l < size; l++)
+        {
+            tst1 = max(tst1, abs(d[l]) + abs(e[l]));
+            ptrdiff_t m = l;
+            while (m < size - 1 && abs(e[m]) > eps * tst1) m++;
+
+            if (m > l)
+            {
+                size_t iter = 0;
+                do
+                {
+                    double g = d[l];
+                    double p = (d[l + 1] - g) / (2.0 * e[l]);
+                    double r = hypot(p, 1.0);
+                    if (p < 0) r = -r;
+                    d[l] = e[l] / (p + r);
+                    d[l + 1] = e[l] * (p + r);
+                    double dl1 = d[l + 1];
+                    double h = g - d[l];
+                    for (ptrdiff_t i = l + 2; i < size; i++) d[i] -= h;
+                    f += h;
+
+                    p = d[m];
+                    double c = 1.0, c2 = 1.0, c3 = 1.0;
+                    double el1 = e[l + 1];
+                    double s = 0.0, s2 = 0.0;
+                    for (ptrdiff_t i = m - 1; i >= l; i--)
+                    {
+                        c3 = c2;
+                        c2 = c;
+                        s2 = s;
+                        g = c * e[i];
+                        h = c * p;
+                        r = hypot(p, e[i]);
+                        e[i + 1] = s * r;
+                        s = e[i] / r;
+                        c = p / r;
+                        p = c * d[i] - s * g;
+                        d[i + 1] = h + s * (c * g + s * d[i]);
+                        for (ptrdiff_t k = 0; k < size; k++)
+                        {
+                            h = v(k, i + 1);
+                            v(k, i + 1) = s * v(k, i) + c * h;
+                            v(k, i) = c * v(k, i) - s * h;
+                        }
+                    }
+                    p = -s * s2 * c3 * el1 * e[l] / dl1;
+                    e[l] = s * p;
+                    d[l] = c * p;
+                } while (abs(e[l]) > eps * tst1 && ++iter < 100);
+            }
+            d[l] += f;
+            e[l] = 0.0;
+        }
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // !GA_CMA_ES_H
\ No newline at end of file
@@ -33,5 +33,9 @@
 #include "real_ga.h"
 #include "permutation_ga.h"
 #include "integer_ga.h"
+#include "static_ga.h"
+#include "process_pool.h"
+#include "socket_evaluator.h"
+#include "async_evaluator.h"
 
 #endif // !GA_GENETIC_ALGORITHM_H
\ No newline at end of file
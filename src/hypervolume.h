@@ -0,0 +1,303 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/*
+* This file contains the functions used for computing the hypervolume indicator of
+* a set of points in the objective space (assuming fitness maximization).
+*/
+
+#ifndef GA_HYPERVOLUME_H
+#define GA_HYPERVOLUME_H
+
+#include <vector>
+#include <cstddef>
+
+namespace genetic_algorithm::detail
+{
+    /*
+    * The number of objectives above which the hypervolume is estimated using Monte Carlo sampling
+    * instead of being calculated exactly with the WFG algorithm (whose cost grows exponentially with the number of objectives).
+    */
+    inline constexpr size_t HV_MAX_EXACT_DIM = 8;
+
+    /*
+    * Returns the hypervolume of the region dominated by the points and bounded by the reference point ref. \n
+    * The points which don't dominate the reference point don't contribute to the hypervolume. \n
+    * Exact for at most HV_MAX_EXACT_DIM objectives (sweep for 2 and 3 objectives, WFG for more),
+    * and estimated with Monte Carlo sampling for more objectives.
+    */
+    inline double hypervolume(std::vector<std::vector<double>> points, const std::vector<double>& ref);
+
+    /* Exact hypervolume in 2 dimensions, O(nlogn). */
+    inline double hypervolume2D(std::vector<std::vector<double>> points, const std::vector<double>& ref);
+
+    /* Exact hypervolume in 3 dimensions using a sweep along the last objective, O(nlogn) (Beume et al.). */
+    inline double hypervolume3D(std::vector<std::vector<double>> points, const std::vector<double>& ref);
+
+    /* Exact hypervolume in any number of dimensions using the WFG algorithm. */
+    inline double hypervolumeWFG(std::vector<std::vector<double>> points, const std::vector<double>& ref);
+
+    /* Monte Carlo estimate of the hypervolume in any number of dimensions, using num_samples samples. */
+    inline double hypervolumeMonteCarlo(std::vector<std::vector<double>> points, const std::vector<double>& ref, size_t num_samples = 100000);
+
+} // namespace genetic_algorithm::detail
+
+
+/* IMPLEMENTATION */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <cassert>
+
+#include "mo_detail.h"
+#include "rng.h"
+
+namespace genetic_algorithm::detail
+{
+    /* Remove the points which don't dominate ref, or are dominated by another point. Only the first dim coordinates are considered. */
+    inline void filterHvPoints(std::vector<std::vector<double>>& points, const std::vector<double>& ref, size_t dim)
+    {
+        auto strictlyBetter = [dim](const std::vector<double>& lhs, const std::vector<double>& rhs)
+        {
+            for (size_t i = 0; i < dim; i++)
+            {
+                if (lhs[i] <= rhs[i]) return false;
+            }
+            return true;
+        };
+        auto weaklyDominates = [dim](const std::vector<double>& lhs, const std::vector<double>& rhs)
+        {
+            for (size_t i = 0; i < dim; i++)
+            {
+                if (lhs[i] < rhs[i]) return false;
+            }
+            return true;
+        };
+
+        std::erase_if(points, [&](const std::vector<double>& p) { return !strictlyBetter(p, ref); });
+
+        /* Sort by the first objective so a point can only be weakly dominated by the points before it. */
+        std::sort(points.begin(), points.end(), std::greater<>{});
+
+        std::vector<std::vector<double>> nondominated;
+        for (auto& p : points)
+        {
+            bool is_dominated = std::any_of(nondominated.begin(), nondominated.end(), [&](const std::vector<double>& q) { return weaklyDominates(q, p); });
+            if (!is_dominated) nondominated.push_back(std::move(p));
+        }
+        points = std::move(nondominated);
+    }
+
+    inline double boxVolume(const std::vector<double>& point, const std::vector<double>& ref, size_t dim)
+    {
+        double volume = 1.0;
+        for (size_t i = 0; i < dim; i++) volume *= point[i] - ref[i];
+
+        return volume;
+    }
+
+    /* The 2D sweep for points that are already filtered and sorted by their first objective in descending order. */
+    inline double hypervolume2DSorted(const std::vector<std::vector<double>>& points, const std::vector<double>& ref)
+    {
+        double volume = 0.0;
+        double prev_f2 = ref[1];
+        for (const auto& p : points)
+        {
+            volume += (p[0] - ref[0]) * (p[1] - prev_f2);
+            prev_f2 = p[1];
+        }
+
+        return volume;
+    }
+
+    inline double hypervolume2D(std::vector<std::vector<double>> points, const std::vector<double>& ref)
+    {
+        assert(ref.size() >= 2);
+
+        filterHvPoints(points, ref, 2);
+
+        return hypervolume2DSorted(points, ref);
+    }
+
+    inline double hypervolume3D(std::vector<std::vector<double>> points, const std::vector<double>& ref)
+    {
+        assert(ref.size() >= 3);
+
+        std::erase_if(points, [&](const std::vector<double>& p) { return !(p[0] > ref[0] && p[1] > ref[1] && p[2] > ref[2]); });
+        std::sort(points.begin(), points.end(), [](const std::vector<double>& lhs, const std::vector<double>& rhs) { return lhs[2] > rhs[2]; });
+
+        /*
+        * The points are processed in decreasing order of the third objective, while maintaining the 2D front of the points
+        * processed so far (the staircase) and its area. The staircase is ordered by increasing f1 (and decreasing f2).
+        */
+        std::map<double, double> staircase;
+        double area = 0.0;
+
+        /* The area only dominated by the point at it. */
+        auto exclusiveArea = [&](std::map<double, double>::iterator it)
+        {
+            double x_prev = (it == staircase.begin()) ? ref[0] : std::prev(it)->first;
+            double y_next = (std::next(it) == staircase.end()) ? ref[1] : std::next(it)->second;
+
+            return (it->first - x_prev) * (it->second - y_next);
+        };
+
+        double volume = 0.0;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            const double x = points[i][0];
+            const double y = points[i][1];
+
+            auto it = staircase.lower_bound(x);
+            if (it == staircase.end() || it->second < y)    /* Not dominated by the staircase. */
+            {
+                /* Remove the points of the staircase dominated by the new point. */
+                if (it != staircase.end() && it->first == x)
+                {
+                    area -= exclusiveArea(it);
+                    it = staircase.erase(it);
+                }
+                while (it != staircase.begin() && std::prev(it)->second <= y)
+                {
+                    auto dominated = std::prev(it);
+                    area -= exclusiveArea(dominated);
+                    staircase.erase(dominated);
+                }
+
+                it = staircase.emplace_hint(it, x, y);
+                area += exclusiveArea(it);
+            }
+
+            double next_f3 = (i + 1 < points.size()) ? points[i + 1][2] : ref[2];
+            volume += area * (points[i][2] - next_f3);
+        }
+
+        return volume;
+    }
+
+    /*
+    * WFG algorithm for the first dim objectives of the points (While et al.). The points must be filtered already. \n
+    * The points are sorted in increasing order of the last objective, so the limit set of each point (the remaining points
+    * limited by the point) has the same value as the point in the last objective, and its hypervolume can be calculated
+    * in one less dimension.
+    */
+    inline double hypervolumeWFGImpl(std::vector<std::vector<double>>& points, const std::vector<double>& ref, size_t dim)
+    {
+        if (points.empty()) return 0.0;
+        if (dim == 2)
+        {
+            std::sort(points.begin(), points.end(), std::greater<>{});
+            return hypervolume2DSorted(points, ref);
+        }
+
+        std::sort(points.begin(), points.end(), [dim](const std::vector<double>& lhs, const std::vector<double>& rhs) { return lhs[dim - 1] < rhs[dim - 1]; });
+
+        double volume = 0.0;
+        std::vector<std::vector<double>> limit_set;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            limit_set.clear();
+            for (size_t j = i + 1; j < points.size(); j++)
+            {
+                std::vector<double> limited(dim - 1);
+                for (size_t k = 0; k < dim - 1; k++) limited[k] = std::min(points[i][k], points[j][k]);
+                limit_set.push_back(std::move(limited));
+            }
+            filterHvPoints(limit_set, ref, dim - 1);
+
+            volume += (points[i][dim - 1] - ref[dim - 1]) * (boxVolume(points[i], ref, dim - 1) - hypervolumeWFGImpl(limit_set, ref, dim - 1));
+        }
+
+        return volume;
+    }
+
+    inline double hypervolumeWFG(std::vector<std::vector<double>> points, const std::vector<double>& ref)
+    {
+        assert(ref.size() >= 2);
+
+        filterHvPoints(points, ref, ref.size());
+
+        return hypervolumeWFGImpl(points, ref, ref.size());
+    }
+
+    inline double hypervolumeMonteCarlo(std::vector<std::vector<double>> points, const std::vector<double>& ref, size_t num_samples)
+    {
+        assert(num_samples > 0);
+
+        const size_t dim = ref.size();
+
+        filterHvPoints(points, ref, dim);
+        if (points.empty()) return 0.0;
+
+        /* Sample the bounding box of the points. */
+        std::vector<double> upper = ref;
+        for (const auto& p : points)
+        {
+            for (size_t i = 0; i < dim; i++) upper[i] = std::max(upper[i], p[i]);
+        }
+
+        size_t num_dominated = 0;
+        std::vector<double> sample(dim);
+        for (size_t n = 0; n < num_samples; n++)
+        {
+            for (size_t i = 0; i < dim; i++) sample[i] = rng::randomReal(ref[i], upper[i]);
+
+            num_dominated += std::any_of(points.begin(), points.end(),
+            [&](const std::vector<double>& p)
+            {
+                return std::equal(sample.begin(), sample.end(), p.begin(), std::less_equal<>{});
+            });
+        }
+
+        return boxVolume(upper, ref, dim) * double(num_dominated) / num_samples;
+    }
+
+    inline double hypervolume(std::vector<std::vector<double>> points, const std::vector<double>& ref)
+    {
+        assert(!ref.empty());
+        assert(std::all_of(points.begin(), points.end(), [&ref](const std::vector<double>& p) { return p.size() == ref.size(); }));
+
+        switch (ref.size())
+        {
+            case 1:
+            {
+                double best = ref[0];
+                for (const auto& p : points) best = std::max(best, p[0]);
+                return best - ref[0];
+            }
+            case 2:
+                return hypervolume2D(std::move(points), ref);
+            case 3:
+                return hypervolume3D(std::move(points), ref);
+            default:
+                if (ref.size() <= HV_MAX_EXACT_DIM) return hypervolumeWFG(std::move(points), ref);
+                else return hypervolumeMonteCarlo(std::move(points), ref);
+        }
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // !GA_HYPERVOLUME_H
\ No newline at end of file
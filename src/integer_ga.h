@@ -154,6 +154,12 @@ namespace genetic_algorithm
         void inversion_rate(double pi);
         [[nodiscard]] double inversion_rate() const;
 
+        /* The genetic operators of the IntegerGA. They can also be used on their own, eg. as the operators of a StaticGA. */
+        static CandidatePair nPointCrossover(const Candidate& parent1, const Candidate& parent2, double pc, size_t n);
+        static CandidatePair uniformCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
+
+        static void standardMutate(Candidate& child, double pm, double ps, double pi, size_t base_);
+
     private:
 
         CrossoverMethod crossover_method_ = CrossoverMethod::single_point;
@@ -166,11 +172,6 @@ namespace genetic_algorithm
         Candidate generateCandidate() const override;
         CandidatePair crossover(const Candidate& parent1, const Candidate& parent2) const override;
         void mutate(Candidate& child) const override;
-
-        static CandidatePair nPointCrossover(const Candidate& parent1, const Candidate& parent2, double pc, size_t n);
-        static CandidatePair uniformCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
-
-        static void standardMutate(Candidate& child, double pm, double ps, double pi, size_t base_);
     };
 
 } // namespace genetic_algorithm
@@ -0,0 +1,120 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/*
+* This file contains some utility functions for the communication with the worker processes
+* of the process pool and socket evaluation backends. Only available on POSIX systems.
+*/
+
+#ifndef GA_IPC_DETAIL_H
+#define GA_IPC_DETAIL_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstddef>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace genetic_algorithm::detail
+{
+    /* Read exactly size bytes. Returns false on EOF or error. */
+    inline bool readAll(int fd, void* buf, size_t size) noexcept
+    {
+        char* ptr = static_cast<char*>(buf);
+        while (size > 0)
+        {
+            ssize_t n = ::read(fd, ptr, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            ptr += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    /* Write exactly size bytes to a socket without raising SIGPIPE. Returns false on error. */
+    inline bool sendAll(int fd, const void* buf, size_t size) noexcept
+    {
+#ifdef MSG_NOSIGNAL
+        constexpr int flags = MSG_NOSIGNAL;
+#else
+        constexpr int flags = 0;    /* SO_NOSIGPIPE is set on the socket instead. */
+#endif
+        const char* ptr = static_cast<const char*>(buf);
+        while (size > 0)
+        {
+            ssize_t n = ::send(fd, ptr, size, flags);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            ptr += n;
+            size -= size_t(n);
+        }
+        return true;
+    }
+
+    /* Write at most size bytes to a socket without blocking or raising SIGPIPE. Returns the number of bytes written (0 if it would block), or -1 on error. */
+    inline ssize_t sendSome(int fd, const void* buf, size_t size) noexcept
+    {
+#ifdef MSG_NOSIGNAL
+        constexpr int flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+        constexpr int flags = MSG_DONTWAIT;     /* SO_NOSIGPIPE is set on the socket instead. */
+#endif
+        while (true)
+        {
+            ssize_t n = ::send(fd, buf, size, flags);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+            return (n < 0) ? -1 : n;
+        }
+    }
+
+    /* Read at most size bytes from a socket without blocking. Returns the number of bytes read (0 if it would block), or -1 on EOF or error. */
+    inline ssize_t readSome(int fd, void* buf, size_t size) noexcept
+    {
+        while (true)
+        {
+            ssize_t n = ::recv(fd, buf, size, MSG_DONTWAIT);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+            return (n <= 0) ? -1 : n;
+        }
+    }
+
+    /* Prevent SIGPIPE when writing to the socket if MSG_NOSIGNAL isn't available. */
+    inline void disableSigPipe([[maybe_unused]] int fd) noexcept
+    {
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+        int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#endif // !GA_IPC_DETAIL_H
\ No newline at end of file
@@ -0,0 +1,259 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/*
+* This file contains the gradient-free local search methods used by the memetic
+* mode of the real-coded genetic algorithm.
+*/
+
+#ifndef GA_LOCAL_SEARCH_H
+#define GA_LOCAL_SEARCH_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace genetic_algorithm::detail
+{
+    /* The best point found by a local search, its fitness value, and the number of evaluations used. */
+    struct LocalSearchResult
+    {
+        std::vector<double> x;
+        double fx;
+        size_t num_evals;
+    };
+
+    /*
+    * Maximize f (returning a scalar) starting from x0 using the Nelder-Mead simplex method, with the bounds handled by clamping.
+    * The initial simplex is created by moving x0 along each axis by step times the range of the bounds.
+    * Stops after max_evals evaluations, or when the simplex has collapsed.
+    */
+    template<typename F>
+    LocalSearchResult nelderMead(F&& f, std::vector<double> x0, double fx0, const std::vector<std::pair<double, double>>& bounds,
+                                 size_t max_evals, double step = 0.05);
+
+    /*
+    * Maximize f (returning a scalar) starting from x0 using a coordinate (compass) pattern search. Each coordinate is moved by
+    * +-step times the range of the bounds, and the step is halved when none of these moves improve the point.
+    * Stops after max_evals evaluations, or when the steps become negligible.
+    */
+    template<typename F>
+    LocalSearchResult patternSearch(F&& f, std::vector<double> x0, double fx0, const std::vector<std::pair<double, double>>& bounds,
+                                    size_t max_evals, double step = 0.05);
+
+} // namespace genetic_algorithm::detail
+
+
+/* IMPLEMENTATION */
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+
+namespace genetic_algorithm::detail
+{
+    template<typename F>
+    LocalSearchResult nelderMead(F&& f, std::vector<double> x0, double fx0, const std::vector<std::pair<double, double>>& bounds,
+                                 size_t max_evals, double step)
+    {
+        using namespace std;
+        assert(x0.size() == bounds.size());
+
+        constexpr double alpha = 1.0;   /* Reflection. */
+        constexpr double gamma = 2.0;   /* Expansion. */
+        constexpr double rho = 0.5;     /* Contraction. */
+        constexpr double sigma = 0.5;   /* Shrink. */
+        constexpr double tol = 1e-12;
+
+        const size_t dim = x0.size();
+        size_t num_evals = 0;
+
+        auto clamped = [&bounds](vector<double> x)
+        {
+            for (size_t i = 0; i < x.size(); i++) x[i] = clamp(x[i], bounds[i].first, bounds[i].second);
+            return x;
+        };
+
+        /* The vertices of the simplex and their fitness values. */
+        vector<vector<double>> simplex(dim + 1, x0);
+        vector<double> fvals(dim + 1, fx0);
+        for (size_t i = 0; i < dim && num_evals < max_evals; i++)
+        {
+            double delta = step * (bounds[i].second - bounds[i].first);
+            simplex[i + 1][i] += (x0[i] + delta <= bounds[i].second) ? delta : -delta;
+            simplex[i + 1] = clamped(move(simplex[i + 1]));
+            fvals[i + 1] = f(simplex[i + 1]);
+            num_evals++;
+        }
+
+        vector<size_t> order(dim + 1);
+        vector<double> centroid(dim);
+        auto along = [&](const vector<double>& from, double coeff)
+        {
+            /* centroid + coeff * (centroid - from) */
+            vector<double> x(dim);
+            for (size_t i = 0; i < dim; i++) x[i] = centroid[i] + coeff * (centroid[i] - from[i]);
+            return clamped(move(x));
+        };
+
+        while (num_evals < max_evals)
+        {
+            /* Order the vertices from the best to the worst. */
+            iota(order.begin(), order.end(), size_t{ 0 });
+            sort(order.begin(), order.end(), [&fvals](size_t lidx, size_t ridx) { return fvals[lidx] > fvals[ridx]; });
+            const size_t best = order.front();
+            const size_t worst = order.back();
+            const size_t second_worst = order[dim - (dim > 0)];
+
+            /* Stop if the simplex has collapsed. */
+            double size = 0.0;
+            for (const auto& vertex : simplex)
+            {
+                for (size_t i = 0; i < dim; i++) size = max(size, abs(vertex[i] - simplex[best][i]) / (bounds[i].second - bounds[i].first + tol));
+            }
+            if (size < tol) break;
+
+            fill(centroid.begin(), centroid.end(), 0.0);
+            for (size_t v : order)
+            {
+                if (v == worst) continue;
+                for (size_t i = 0; i < dim; i++) centroid[i] += simplex[v][i] / double(dim);
+            }
+
+            vector<double> xr = along(simplex[worst], alpha);
+            double fr = f(xr);
+            num_evals++;
+
+            if (fr > fvals[best])
+            {
+                /* Try to expand further in the same direction. */
+                if (num_evals < max_evals)
+                {
+                    vector<double> xe = along(simplex[worst], gamma);
+                    double fe = f(xe);
+                    num_evals++;
+                    if (fe > fr)
+                    {
+                        xr = move(xe);
+                        fr = fe;
+                    }
+                }
+                simplex[worst] = move(xr);
+                fvals[worst] = fr;
+            }
+            else if (fr > fvals[second_worst])
+            {
+                simplex[worst] = move(xr);
+                fvals[worst] = fr;
+            }
+            else
+            {
+                /* Contract towards the better of the worst and the reflected point. */
+                bool outside = fr > fvals[worst];
+                vector<double> xc = along(outside ? xr : simplex[worst], -rho);
+                if (num_evals >= max_evals) break;
+                double fc = f(xc);
+                num_evals++;
+
+                if (fc > max(fr, fvals[worst]))
+                {
+                    simplex[worst] = move(xc);
+                    fvals[worst] = fc;
+                }
+                else
+                {
+                    /* Shrink the simplex towards the best vertex. */
+                    for (size_t v = 0; v <= dim && num_evals < max_evals; v++)
+                    {
+                        if (v == best) continue;
+                        for (size_t i = 0; i < dim; i++) simplex[v][i] = simplex[best][i] + sigma * (simplex[v][i] - simplex[best][i]);
+                        fvals[v] = f(simplex[v]);
+                        num_evals++;
+                    }
+                }
+            }
+        }
+
+        size_t best = size_t(max_element(fvals.begin(), fvals.end()) - fvals.begin());
+
+        return { move(simplex[best]), fvals[best], num_evals };
+    }
+
+    template<typename F>
+    LocalSearchResult patternSearch(F&& f, std::vector<double> x0, double fx0, const std::vector<std::pair<double, double>>& bounds,
+                                    size_t max_evals, double step)
+    {
+        using namespace std;
+        assert(x0.size() == bounds.size());
+
+        constexpr double tol = 1e-12;
+
+        const size_t dim = x0.size();
+        size_t num_evals = 0;
+
+        vector<double> steps(dim);
+        for (size_t i = 0; i < dim; i++) steps[i] = step * (bounds[i].second - bounds[i].first);
+
+        vector<double> x = move(x0);
+        double fx = fx0;
+        while (num_evals < max_evals && step > tol)
+        {
+            bool improved = false;
+            for (size_t i = 0; i < dim && num_evals < max_evals; i++)
+            {
+                for (double direction : { 1.0, -1.0 })
+                {
+                    double old_val = x[i];
+                    x[i] = clamp(old_val + direction * steps[i], bounds[i].first, bounds[i].second);
+                    if (x[i] == old_val || num_evals >= max_evals)
+                    {
+                        x[i] = old_val;
+                        continue;
+                    }
+
+                    double fnew = f(x);
+                    num_evals++;
+                    if (fnew > fx)
+                    {
+                        fx = fnew;
+                        improved = true;
+                        break;
+                    }
+                    x[i] = old_val;
+                }
+            }
+            if (!improved)
+            {
+                for (double& s : steps) s *= 0.5;
+                step *= 0.5;
+            }
+        }
+
+        return { move(x), fx, num_evals };
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // !GA_LOCAL_SEARCH_H
\ No newline at end of file
@@ -23,7 +23,7 @@
 */
 
 /**
-* This file contains some utility functions for the NSGA-III algorithm.
+* This file contains some utility functions for the NSGA-II and NSGA-III algorithms.
 */
 
 #ifndef GA_MO_DETAIL_H
@@ -31,23 +31,78 @@
 
 #include <vector>
 #include <utility>
+#include <type_traits>
 #include <cstddef>
 
 namespace genetic_algorithm::detail
 {
+    /*
+    * Flat, row-major matrix of points in the objective space (eg. fitness vectors, normalized fitness vectors or reference points).
+    * Each row is a point, and the number of columns is the number of objectives.
+    */
+    class ObjectiveMatrix
+    {
+    public:
+        ObjectiveMatrix() = default;
+        ObjectiveMatrix(size_t nrows, size_t ncols);
+        explicit ObjectiveMatrix(const std::vector<std::vector<double>>& points);
+
+        /* Resize the matrix. Doesn't reallocate if the new size isn't larger than the capacity. The contents are unspecified after resizing. */
+        void resize(size_t nrows, size_t ncols);
+
+        [[nodiscard]] size_t nrows() const noexcept { return nrows_; }
+        [[nodiscard]] size_t ncols() const noexcept { return ncols_; }
+        [[nodiscard]] bool empty() const noexcept { return nrows_ == 0; }
+
+        [[nodiscard]] double* operator[](size_t row) noexcept { return data_.data() + row * ncols_; }
+        [[nodiscard]] const double* operator[](size_t row) const noexcept { return data_.data() + row * ncols_; }
+
+    private:
+        size_t nrows_ = 0;
+        size_t ncols_ = 0;
+        std::vector<double> data_;
+    };
+
+    /*
+    * The kernels below take the number of objectives as a template parameter M so the loops can be fully unrolled/vectorized.
+    * M = 0 means the number of objectives is only known at runtime, and the dim parameter is used instead.
+    */
+    inline constexpr size_t DYNAMIC_DIM = 0;
+
+    /* Calls f with a std::integral_constant holding the compile-time number of objectives for dim (2, 3, 4, 8, or DYNAMIC_DIM otherwise). */
+    template<typename F>
+    inline decltype(auto) dispatchObjectives(size_t dim, F&& f);
+
     /* Return true if lhs is dominated by rhs (lhs < rhs) assuming maximization. */
-    inline bool paretoCompare(const std::vector<double>& lhs, const std::vector<double>& rhs);
+    template<size_t M = DYNAMIC_DIM>
+    inline bool paretoCompare(const double* lhs, const double* rhs, size_t dim = M);
+
+    /* Return -1 if lhs is dominated by rhs, 1 if rhs is dominated by lhs, and 0 otherwise, assuming maximization. */
+    template<size_t M = DYNAMIC_DIM>
+    inline int paretoCompareThreeWay(const double* lhs, const double* rhs, size_t dim = M);
 
     /* Calculate the square of the Euclidean distance between the vectors v1 and v2. */
-    inline double euclideanDistanceSq(const std::vector<double>& v1, const std::vector<double>& v2);
+    template<size_t M = DYNAMIC_DIM>
+    inline double euclideanDistanceSq(const double* v1, const double* v2, size_t dim = M);
 
     /* Calculate the square of the perpendicular distance between the line ref and the point p. */
-    inline double perpendicularDistanceSq(const std::vector<double>& ref, const std::vector<double>& p);
+    template<size_t M = DYNAMIC_DIM>
+    inline double perpendicularDistanceSq(const double* ref, const double* p, size_t dim = M);
 
     /* Find the index and distance of the closest reference line to the point p. */
-    inline std::pair<size_t, double> findClosestRef(const std::vector<std::vector<double>>& refs, const std::vector<double>& p);
+    template<size_t M = DYNAMIC_DIM>
+    inline std::pair<size_t, double> findClosestRef(const ObjectiveMatrix& refs, const double* p);
 
     /* Achievement scalarization function. */
+    template<size_t M = DYNAMIC_DIM>
+    inline double ASF(const double* f, const double* z, const double* w, size_t dim = M);
+
+    /* Overloads of the above functions for vectors with runtime lengths. */
+
+    inline bool paretoCompare(const std::vector<double>& lhs, const std::vector<double>& rhs);
+    inline double euclideanDistanceSq(const std::vector<double>& v1, const std::vector<double>& v2);
+    inline double perpendicularDistanceSq(const std::vector<double>& ref, const std::vector<double>& p);
+    inline std::pair<size_t, double> findClosestRef(const std::vector<std::vector<double>>& refs, const std::vector<double>& p);
     inline double ASF(const std::vector<double>& f, const std::vector<double>& z, const std::vector<double>& w);
 
 } // namespace genetic_algorithm::detail
@@ -62,25 +117,95 @@ namespace genetic_algorithm::detail
 
 namespace genetic_algorithm::detail
 {
-    bool paretoCompare(const std::vector<double>& lhs, const std::vector<double>& rhs)
+    inline ObjectiveMatrix::ObjectiveMatrix(size_t nrows, size_t ncols)
+        : nrows_(nrows), ncols_(ncols), data_(nrows * ncols)
     {
-        assert(lhs.size() == rhs.size());
+    }
+
+    inline ObjectiveMatrix::ObjectiveMatrix(const std::vector<std::vector<double>>& points)
+        : nrows_(points.size()), ncols_(points.empty() ? 0 : points[0].size())
+    {
+        assert(std::all_of(points.begin(), points.end(), [this](const std::vector<double>& p) { return p.size() == ncols_; }));
 
-        bool has_lower = false;
-        for (size_t i = 0; i < lhs.size(); i++)
+        data_.reserve(nrows_ * ncols_);
+        for (const auto& point : points)
         {
-            if (lhs[i] > rhs[i]) return false;
-            if (lhs[i] < rhs[i]) has_lower = true;
+            data_.insert(data_.end(), point.begin(), point.end());
         }
-        return has_lower;
     }
 
-    double euclideanDistanceSq(const std::vector<double>& v1, const std::vector<double>& v2)
+    inline void ObjectiveMatrix::resize(size_t nrows, size_t ncols)
     {
-        assert(v1.size() == v2.size());
+        nrows_ = nrows;
+        ncols_ = ncols;
+        data_.resize(nrows * ncols);
+    }
+
+    template<typename F>
+    decltype(auto) dispatchObjectives(size_t dim, F&& f)
+    {
+        switch (dim)
+        {
+            case 2: return f(std::integral_constant<size_t, 2>{});
+            case 3: return f(std::integral_constant<size_t, 3>{});
+            case 4: return f(std::integral_constant<size_t, 4>{});
+            case 8: return f(std::integral_constant<size_t, 8>{});
+            default: return f(std::integral_constant<size_t, DYNAMIC_DIM>{});
+        }
+    }
+
+    template<size_t M>
+    bool paretoCompare(const double* lhs, const double* rhs, size_t dim)
+    {
+        if constexpr (M != DYNAMIC_DIM)
+        {
+            assert(dim == M);
+
+            /* No early exit, so the loop can be vectorized. */
+            bool has_lower = false, has_higher = false;
+            for (size_t i = 0; i < M; i++)
+            {
+                has_lower |= (lhs[i] < rhs[i]);
+                has_higher |= (lhs[i] > rhs[i]);
+            }
+            return has_lower && !has_higher;
+        }
+        else
+        {
+            bool has_lower = false;
+            for (size_t i = 0; i < dim; i++)
+            {
+                if (lhs[i] > rhs[i]) return false;
+                if (lhs[i] < rhs[i]) has_lower = true;
+            }
+            return has_lower;
+        }
+    }
+
+    template<size_t M>
+    int paretoCompareThreeWay(const double* lhs, const double* rhs, size_t dim)
+    {
+        if constexpr (M != DYNAMIC_DIM) assert(dim == M);
+        const size_t len = (M != DYNAMIC_DIM) ? M : dim;
+
+        bool has_lower = false, has_higher = false;
+        for (size_t i = 0; i < len; i++)
+        {
+            has_lower |= (lhs[i] < rhs[i]);
+            has_higher |= (lhs[i] > rhs[i]);
+        }
+
+        return int(has_higher && !has_lower) - int(has_lower && !has_higher);
+    }
+
+    template<size_t M>
+    double euclideanDistanceSq(const double* v1, const double* v2, size_t dim)
+    {
+        if constexpr (M != DYNAMIC_DIM) assert(dim == M);
+        const size_t len = (M != DYNAMIC_DIM) ? M : dim;
 
         double d = 0.0;
-        for (size_t i = 0; i < v1.size(); i++)
+        for (size_t i = 0; i < len; i++)
         {
             d += (v1[i] - v2[i]) * (v1[i] - v2[i]);
         }
@@ -88,12 +213,14 @@ namespace genetic_algorithm::detail
         return d;
     }
 
-    double perpendicularDistanceSq(const std::vector<double>& ref, const std::vector<double>& p)
+    template<size_t M>
+    double perpendicularDistanceSq(const double* ref, const double* p, size_t dim)
     {
-        assert(ref.size() == p.size());
+        if constexpr (M != DYNAMIC_DIM) assert(dim == M);
+        const size_t len = (M != DYNAMIC_DIM) ? M : dim;
 
         double num = 0.0, den = 0.0;
-        for (size_t i = 0; i < ref.size(); i++)
+        for (size_t i = 0; i < len; i++)
         {
             num += ref[i] * p[i];
             den += ref[i] * ref[i];
@@ -101,7 +228,7 @@ namespace genetic_algorithm::detail
         double k = num / den;
 
         double dist = 0.0;
-        for (size_t i = 0; i < ref.size(); i++)
+        for (size_t i = 0; i < len; i++)
         {
             dist += (p[i] - k * ref[i]) * (p[i] - k * ref[i]);
         }
@@ -109,8 +236,68 @@ namespace genetic_algorithm::detail
         return dist;
     }
 
+    template<size_t M>
+    std::pair<size_t, double> findClosestRef(const ObjectiveMatrix& refs, const double* p)
+    {
+        assert(!refs.empty());
+        assert(M == DYNAMIC_DIM || refs.ncols() == M);
+
+        size_t argmin = 0;
+        double dmin = perpendicularDistanceSq<M>(refs[0], p, refs.ncols());
+        for (size_t i = 1; i < refs.nrows(); i++)
+        {
+            double d = perpendicularDistanceSq<M>(refs[i], p, refs.ncols());
+            if (d < dmin)
+            {
+                dmin = d;
+                argmin = i;
+            }
+        }
+
+        return std::make_pair(argmin, dmin);
+    }
+
+    template<size_t M>
+    double ASF(const double* f, const double* z, const double* w, size_t dim)
+    {
+        if constexpr (M != DYNAMIC_DIM) assert(dim == M);
+        const size_t len = (M != DYNAMIC_DIM) ? M : dim;
+        assert(len > 0);
+
+        double dmax = std::abs(f[0] - z[0]) / w[0];
+        for (size_t j = 1; j < len; j++)
+        {
+            dmax = std::max(dmax, std::abs(f[j] - z[j]) / w[j]);
+        }
+
+        return dmax;
+    }
+
+    bool paretoCompare(const std::vector<double>& lhs, const std::vector<double>& rhs)
+    {
+        assert(lhs.size() == rhs.size());
+
+        return paretoCompare<DYNAMIC_DIM>(lhs.data(), rhs.data(), lhs.size());
+    }
+
+    double euclideanDistanceSq(const std::vector<double>& v1, const std::vector<double>& v2)
+    {
+        assert(v1.size() == v2.size());
+
+        return euclideanDistanceSq<DYNAMIC_DIM>(v1.data(), v2.data(), v1.size());
+    }
+
+    double perpendicularDistanceSq(const std::vector<double>& ref, const std::vector<double>& p)
+    {
+        assert(ref.size() == p.size());
+
+        return perpendicularDistanceSq<DYNAMIC_DIM>(ref.data(), p.data(), ref.size());
+    }
+
     std::pair<size_t, double> findClosestRef(const std::vector<std::vector<double>>& refs, const std::vector<double>& p)
     {
+        assert(!refs.empty());
+
         size_t argmin = 0;
         double dmin = perpendicularDistanceSq(refs[0], p);
         for (size_t i = 1; i < refs.size(); i++)
@@ -131,13 +318,7 @@ namespace genetic_algorithm::detail
         assert(!f.empty());
         assert(f.size() == z.size() && f.size() == w.size());
 
-        double dmax = std::abs(f[0] - z[0]) / w[0];
-        for (size_t j = 1; j < f.size(); j++)
-        {
-            dmax = std::max(dmax, std::abs(f[j] - z[j]) / w[j]);
-        }
-
-        return dmax;
+        return ASF<DYNAMIC_DIM>(f.data(), z.data(), w.data(), f.size());
     }
 
 } // namespace genetic_algorithm::detail
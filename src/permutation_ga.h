@@ -116,15 +116,7 @@ namespace genetic_algorithm
         void mutation_method(MutationMethod method);
         [[nodiscard]] MutationMethod mutation_method() const;
 
-    private:
-
-        CrossoverMethod crossover_method_ = CrossoverMethod::order;
-        MutationMethod mutation_method_ = MutationMethod::inversion;
-
-        Candidate generateCandidate() const override;
-        CandidatePair crossover(const Candidate& parent1, const Candidate& parent2) const override;
-        void mutate(Candidate& child) const override;
-
+        /* The genetic operators of the PermutationGA. They can also be used on their own, eg. as the operators of a StaticGA. */
         static CandidatePair orderCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
         static CandidatePair cycleCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
         static CandidatePair edgeCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
@@ -133,6 +125,15 @@ namespace genetic_algorithm
         static void swapMutate(Candidate& child, double pm);
         static void scrambleMutate(Candidate& child, double pm);
         static void inversionMutate(Candidate& child, double pm);
+
+    private:
+
+        CrossoverMethod crossover_method_ = CrossoverMethod::order;
+        MutationMethod mutation_method_ = MutationMethod::inversion;
+
+        Candidate generateCandidate() const override;
+        CandidatePair crossover(const Candidate& parent1, const Candidate& parent2) const override;
+        void mutate(Candidate& child) const override;
     };
 
 } // namespace genetic_algorithm
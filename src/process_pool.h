@@ -0,0 +1,520 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/**
+* This file contains the process pool evaluator, an evaluation backend which evaluates the fitness
+* function in separate worker processes. It can be used with fitness functions that aren't thread-safe,
+* or that might crash or hang. Only available on POSIX systems.
+*
+* @file process_pool.h
+*/
+
+#ifndef GA_PROCESS_POOL_H
+#define GA_PROCESS_POOL_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <type_traits>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+namespace genetic_algorithm
+{
+    /**
+    * Evaluation backend that evaluates the fitness function in a pool of forked worker processes. \n
+    * The chromosomes and fitness vectors are exchanged through shared memory, only the indices of the jobs are
+    * sent to the workers. Workers that crash or exceed the timeout are killed and restarted automatically,
+    * and their evaluations are retried. \n
+    * Use it as the batch fitness function of a GA:
+    * @code
+    * ProcessPoolEvaluator<double> pool(fitness_function, chrom_len);
+    * GA.batchFitnessFunction = std::ref(pool);
+    * @endcode
+    * The workers are forked from the process when the evaluator is created (and when a worker is restarted),
+    * so the fitness function must be usable in a forked child process. The evaluator itself is not thread-safe.
+    */
+    template<typename geneType>
+    class ProcessPoolEvaluator
+    {
+    public:
+
+        using Chromosome = std::vector<geneType>;
+        using FitnessFunction = std::function<std::vector<double>(const Chromosome&)>;
+
+        /**
+        * Creates the evaluator and starts the worker processes.
+        *
+        * @param fitness_function The fitness function evaluated by the workers.
+        * @param chrom_len The length of the chromosomes evaluated.
+        * @param num_workers The number of worker processes. Uses the number of hardware threads if 0.
+        * @param max_objectives The maximum length of the fitness vectors returned by the fitness function.
+        * @param batch_capacity The number of chromosomes the shared memory buffers can hold at once. Larger batches are evaluated in parts.
+        */
+        ProcessPoolEvaluator(FitnessFunction fitness_function, size_t chrom_len, size_t num_workers = 0, size_t max_objectives = 16, size_t batch_capacity = 1024);
+
+        ProcessPoolEvaluator(const ProcessPoolEvaluator&) = delete;
+        ProcessPoolEvaluator& operator=(const ProcessPoolEvaluator&) = delete;
+
+        /** Stops the worker processes. */
+        ~ProcessPoolEvaluator();
+
+        /**
+        * Evaluates the chromosomes in the worker processes.
+        *
+        * @param chroms The chromosomes to evaluate, all of them must be chrom_len long.
+        * @returns The fitness vectors of the chromosomes.
+        * @throws std::runtime_error If an evaluation failed more times than allowed and no failure fitness was set.
+        */
+        std::vector<std::vector<double>> operator()(const std::vector<const Chromosome*>& chroms);
+
+        /**
+        * Sets the maximum time a single fitness evaluation can take to @p seconds. \n
+        * Workers exceeding it are killed and restarted, and the evaluation is considered failed. 0 means no timeout.
+        */
+        void timeout(double seconds);
+        [[nodiscard]] double timeout() const noexcept { return timeout_; }
+
+        /** Sets the number of times a failed evaluation (crash, timeout, or exception) is retried to @p count. */
+        void max_retries(size_t count) noexcept { max_retries_ = count; }
+        [[nodiscard]] size_t max_retries() const noexcept { return max_retries_; }
+
+        /**
+        * Sets the fitness vector assigned to chromosomes whose evaluation failed even after the retries to @p fitness. \n
+        * If it is empty, an exception is thrown instead when an evaluation fails.
+        */
+        void failure_fitness(std::vector<double> fitness);
+        [[nodiscard]] std::vector<double> failure_fitness() const { return failure_fitness_; }
+
+        /** @returns The number of worker processes. */
+        [[nodiscard]] size_t num_workers() const noexcept { return workers_.size(); }
+
+        /** @returns The number of times a worker process had to be restarted. */
+        [[nodiscard]] size_t num_restarts() const noexcept { return num_restarts_; }
+
+        /** @returns The number of evaluations that failed (including the ones that were retried). */
+        [[nodiscard]] size_t num_failures() const noexcept { return num_failures_; }
+
+    private:
+
+        using Clock = std::chrono::steady_clock;
+
+        struct Worker
+        {
+            pid_t pid = -1;
+            int fd = -1;                        /* The parent's end of the socket connected to the worker. */
+            std::deque<uint32_t> jobs;          /* The jobs sent to the worker, in order. */
+            Clock::time_point job_start;        /* The start time of the first job in jobs. */
+        };
+
+        /* The message sent back by the workers after an evaluation. */
+        struct Result
+        {
+            uint32_t job;
+            uint32_t num_objectives;    /* FAILED if the evaluation threw an exception or returned too many objectives. */
+        };
+
+        static constexpr uint32_t FAILED = UINT32_MAX;
+        static constexpr size_t JOBS_PER_WORKER = 2;    /* The number of jobs sent to a worker at once, so it doesn't wait for the next one. */
+
+        static_assert(std::is_trivially_copyable_v<geneType>, "The genes must be trivially copyable to be stored in shared memory.");
+
+        FitnessFunction fitness_function_;
+        size_t chrom_len_;
+        size_t max_objectives_;
+        size_t capacity_;
+
+        void* shared_mem_ = nullptr;
+        size_t shared_mem_size_ = 0;
+        geneType* genes_ = nullptr;     /* capacity_ x chrom_len_ gene matrix. */
+        double* fitness_ = nullptr;     /* capacity_ x max_objectives_ fitness matrix. */
+
+        std::vector<Worker> workers_;
+
+        double timeout_ = 0.0;
+        size_t max_retries_ = 1;
+        std::vector<double> failure_fitness_;
+
+        size_t num_restarts_ = 0;
+        size_t num_failures_ = 0;
+
+        void startWorker(size_t idx);
+        void stopWorker(Worker& worker, bool kill_now) noexcept;
+        [[noreturn]] void workerMain(int fd) noexcept;
+
+        /* Evaluates the jobs [0, num_jobs) of the shared memory buffers, writing the results into fitness_vecs[first_job + job]. */
+        void evaluateJobs(size_t num_jobs, size_t first_job, std::vector<std::vector<double>>& fitness_vecs);
+    };
+
+} // namespace genetic_algorithm
+
+
+/* IMPLEMENTATION */
+
+#include <algorithm>
+#include <thread>
+#include <stdexcept>
+#include <cmath>
+#include <cassert>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "ipc_detail.h"
+
+namespace genetic_algorithm
+{
+    template<typename geneType>
+    ProcessPoolEvaluator<geneType>::ProcessPoolEvaluator(FitnessFunction fitness_function, size_t chrom_len, size_t num_workers, size_t max_objectives, size_t batch_capacity)
+        : fitness_function_(std::move(fitness_function)), chrom_len_(chrom_len), max_objectives_(max_objectives), capacity_(batch_capacity)
+    {
+        if (fitness_function_ == nullptr) throw std::invalid_argument("The fitness function is a nullptr.");
+        if (chrom_len == 0) throw std::invalid_argument("The chromosome length must be at least 1.");
+        if (max_objectives == 0) throw std::invalid_argument("The maximum number of objectives must be at least 1.");
+        if (batch_capacity == 0) throw std::invalid_argument("The batch capacity must be at least 1.");
+
+        if (num_workers == 0) num_workers = std::max(size_t{ std::thread::hardware_concurrency() }, size_t{ 1 });
+
+        /* The shared memory is mapped before forking the workers, so every worker shares it with the parent. */
+        size_t genes_size = capacity_ * chrom_len_ * sizeof(geneType);
+        genes_size = (genes_size + alignof(double) - 1) / alignof(double) * alignof(double);
+        shared_mem_size_ = genes_size + capacity_ * max_objectives_ * sizeof(double);
+
+        shared_mem_ = ::mmap(nullptr, shared_mem_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shared_mem_ == MAP_FAILED)
+        {
+            shared_mem_ = nullptr;
+            throw std::runtime_error("Couldn't allocate the shared memory for the process pool.");
+        }
+        genes_ = static_cast<geneType*>(shared_mem_);
+        fitness_ = reinterpret_cast<double*>(static_cast<char*>(shared_mem_) + genes_size);
+
+        workers_.resize(num_workers);
+        try
+        {
+            for (size_t i = 0; i < num_workers; i++) startWorker(i);
+        }
+        catch (...)
+        {
+            for (auto& worker : workers_) stopWorker(worker, true);
+            ::munmap(shared_mem_, shared_mem_size_);
+            throw;
+        }
+    }
+
+    template<typename geneType>
+    ProcessPoolEvaluator<geneType>::~ProcessPoolEvaluator()
+    {
+        /* Closing the sockets makes the idle workers exit. */
+        for (auto& worker : workers_)
+        {
+            if (worker.fd >= 0) ::close(worker.fd);
+            worker.fd = -1;
+        }
+        for (auto& worker : workers_) stopWorker(worker, false);
+
+        if (shared_mem_ != nullptr) ::munmap(shared_mem_, shared_mem_size_);
+    }
+
+    template<typename geneType>
+    void ProcessPoolEvaluator<geneType>::timeout(double seconds)
+    {
+        if (!(seconds >= 0.0)) throw std::invalid_argument("The timeout can't be negative.");
+
+        timeout_ = seconds;
+    }
+
+    template<typename geneType>
+    void ProcessPoolEvaluator<geneType>::failure_fitness(std::vector<double> fitness)
+    {
+        if (fitness.size() > max_objectives_) throw std::invalid_argument("The failure fitness has more objectives than the maximum allowed.");
+
+        failure_fitness_ = std::move(fitness);
+    }
+
+    template<typename geneType>
+    void ProcessPoolEvaluator<geneType>::startWorker(size_t idx)
+    {
+        Worker& worker = workers_[idx];
+
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        {
+            throw std::runtime_error("Couldn't create the socket for a worker process.");
+        }
+        detail::disableSigPipe(fds[0]);
+
+        pid_t pid = ::fork();
+        if (pid < 0)
+        {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            throw std::runtime_error("Couldn't start a worker process.");
+        }
+        if (pid == 0)
+        {
+            /* The child must not keep the sockets of the other workers open, otherwise they wouldn't see them being closed. */
+            for (const auto& other : workers_)
+            {
+                if (other.fd >= 0) ::close(other.fd);
+            }
+            ::close(fds[0]);
+            workerMain(fds[1]);
+        }
+
+        ::close(fds[1]);
+        worker.pid = pid;
+        worker.fd = fds[0];
+        worker.jobs.clear();
+    }
+
+    template<typename geneType>
+    void ProcessPoolEvaluator<geneType>::stopWorker(Worker& worker, bool kill_now) noexcept
+    {
+        if (worker.fd >= 0) ::close(worker.fd);
+        worker.fd = -1;
+        if (worker.pid <= 0) return;
+
+        if (kill_now) ::kill(worker.pid, SIGKILL);
+
+        /* Give the worker some time to exit after its socket was closed, then kill it. */
+        auto deadline = Clock::now() + std::chrono::seconds(1);
+        while (::waitpid(worker.pid, nullptr, WNOHANG) == 0)
+        {
+            if (Clock::now() > deadline)
+            {
+                ::kill(worker.pid, SIGKILL);
+                ::waitpid(worker.pid, nullptr, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        worker.pid = -1;
+    }
+
+    template<typename geneType>
+    void ProcessPoolEvaluator<geneType>::workerMain(int fd) noexcept
+    {
+        uint32_t job;
+        while (detail::readAll(fd, &job, sizeof(job)))
+        {
+            Result result{ job, FAILED };
+            try
+            {
+                const geneType* genes = genes_ + size_t(job) * chrom_len_;
+                std::vector<double> fx = fitness_function_(Chromosome(genes, genes + chrom_len_));
+                if (fx.size() <= max_objectives_)
+                {
+                    std::copy(fx.begin(), fx.end(), fitness_ + size_t(job) * max_objectives_);
+                    result.num_objectives = uint32_t(fx.size());
+                }
+            }
+            catch (...) {}
+
+            if (!detail::sendAll(fd, &result, sizeof(result))) break;
+        }
+        ::_exit(0);    /* Don't run the destructors and exit handlers of the parent. */
+    }
+
+    template<typename geneType>
+    std::vector<std::vector<double>> ProcessPoolEvaluator<geneType>::operator()(const std::vector<const Chromosome*>& chroms)
+    {
+        std::vector<std::vector<double>> fitness_vecs(chroms.size());
+
+        /* Evaluate the chromosomes in parts that fit into the shared memory. */
+        for (size_t first = 0; first < chroms.size(); first += capacity_)
+        {
+            size_t num_jobs = std::min(capacity_, chroms.size() - first);
+            for (size_t job = 0; job < num_jobs; job++)
+            {
+                const Chromosome& chrom = *chroms[first + job];
+                if (chrom.size() != chrom_len_)
+                {
+                    throw std::invalid_argument("The length of a chromosome is different from the chromosome length of the process pool.");
+                }
+                std::copy(chrom.begin(), chrom.end(), genes_ + job * chrom_len_);
+            }
+            evaluateJobs(num_jobs, first, fitness_vecs);
+        }
+
+        return fitness_vecs;
+    }
+
+    template<typename geneType>
+    void ProcessPoolEvaluator<geneType>::evaluateJobs(size_t num_jobs, size_t first_job, std::vector<std::vector<double>>& fitness_vecs)
+    {
+        std::deque<uint32_t> pending(num_jobs);
+        for (size_t job = 0; job < num_jobs; job++) pending[job] = uint32_t(job);
+
+        std::vector<size_t> num_attempts(num_jobs, 0);
+        size_t num_done = 0;
+
+        /* Restart a worker after a crash or timeout. Its first job failed, the rest of its jobs are sent out again. */
+        auto restartWorker = [&](size_t idx)
+        {
+            Worker& worker = workers_[idx];
+            std::deque<uint32_t> jobs = std::move(worker.jobs);
+
+            stopWorker(worker, true);
+            startWorker(idx);
+            num_restarts_++;
+
+            pending.insert(pending.begin(), jobs.begin() + 1, jobs.end());
+            return jobs.front();
+        };
+
+        auto jobFailed = [&](uint32_t job)
+        {
+            num_failures_++;
+            if (++num_attempts[job] <= max_retries_)
+            {
+                pending.push_front(job);
+            }
+            else if (!failure_fitness_.empty())
+            {
+                fitness_vecs[first_job + job] = failure_fitness_;
+                num_done++;
+            }
+            else
+            {
+                /* The busy workers are restarted so no results are left over for the next batch. */
+                for (size_t idx = 0; idx < workers_.size(); idx++)
+                {
+                    if (!workers_[idx].jobs.empty()) restartWorker(idx);
+                }
+                throw std::runtime_error("A fitness evaluation failed in the process pool.");
+            }
+        };
+
+        auto dispatch = [&](size_t idx)
+        {
+            Worker& worker = workers_[idx];
+            while (worker.jobs.size() < JOBS_PER_WORKER && !pending.empty())
+            {
+                uint32_t job = pending.front();
+                if (!detail::sendAll(worker.fd, &job, sizeof(job)))
+                {
+                    /* The worker died. If it was busy, this is handled as a crash when polling, otherwise it is simply restarted. */
+                    if (!worker.jobs.empty()) break;
+                    stopWorker(worker, true);
+                    startWorker(idx);
+                    num_restarts_++;
+                    continue;
+                }
+
+                pending.pop_front();
+                if (worker.jobs.empty()) worker.job_start = Clock::now();
+                worker.jobs.push_back(job);
+            }
+        };
+
+        std::vector<pollfd> poll_fds(workers_.size());
+        while (num_done != num_jobs)
+        {
+            for (size_t idx = 0; idx < workers_.size(); idx++) dispatch(idx);
+
+            /* Wait until a worker finishes a job, or the first timeout. */
+            int wait_ms = -1;
+            if (timeout_ > 0.0)
+            {
+                auto now = Clock::now();
+                for (const auto& worker : workers_)
+                {
+                    if (worker.jobs.empty()) continue;
+                    double remaining = timeout_ - std::chrono::duration<double>(now - worker.job_start).count();
+                    int ms = std::max(int(std::ceil(remaining * 1000.0)), 0);
+                    wait_ms = (wait_ms < 0) ? ms : std::min(wait_ms, ms);
+                }
+            }
+            for (size_t idx = 0; idx < workers_.size(); idx++)
+            {
+                poll_fds[idx] = { workers_[idx].fd, POLLIN, 0 };
+            }
+            if (::poll(poll_fds.data(), poll_fds.size(), wait_ms) < 0 && errno != EINTR)
+            {
+                throw std::runtime_error("Error while waiting for the worker processes.");
+            }
+
+            auto now = Clock::now();
+            for (size_t idx = 0; idx < workers_.size(); idx++)
+            {
+                Worker& worker = workers_[idx];
+                if (worker.jobs.empty())
+                {
+                    /* An idle worker died. Restart it, otherwise its hung up socket would make every poll return immediately. */
+                    if (poll_fds[idx].revents & (POLLHUP | POLLERR | POLLNVAL))
+                    {
+                        stopWorker(worker, true);
+                        startWorker(idx);
+                        num_restarts_++;
+                    }
+                    continue;
+                }
+
+                if (poll_fds[idx].revents != 0)
+                {
+                    Result result;
+                    if (!detail::readAll(worker.fd, &result, sizeof(result)))
+                    {
+                        jobFailed(restartWorker(idx));    /* The worker crashed. */
+                        continue;
+                    }
+
+                    assert(result.job == worker.jobs.front());
+                    worker.jobs.pop_front();
+                    worker.job_start = now;
+
+                    if (result.num_objectives == FAILED)
+                    {
+                        jobFailed(result.job);
+                    }
+                    else
+                    {
+                        const double* fx = fitness_ + size_t(result.job) * max_objectives_;
+                        fitness_vecs[first_job + result.job].assign(fx, fx + result.num_objectives);
+                        num_done++;
+                    }
+                }
+                else if (timeout_ > 0.0 && std::chrono::duration<double>(now - worker.job_start).count() >= timeout_)
+                {
+                    jobFailed(restartWorker(idx));
+                }
+            }
+        }
+    }
+
+} // namespace genetic_algorithm
+
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#endif // !GA_PROCESS_POOL_H
\ No newline at end of file
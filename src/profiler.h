@@ -0,0 +1,451 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/*
+* This file contains the types used for measuring the time spent in the different
+* phases of the genetic algorithms. \n
+* The measurements are only made if GA_ENABLE_PROFILING is defined before including the library,
+* otherwise the profiler does nothing and is optimized out entirely. \n
+* The timeline of the phases and fitness evaluations can also be recorded at runtime using the tracer.
+*/
+
+#ifndef GA_PROFILER_H
+#define GA_PROFILER_H
+
+#include <array>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstddef>
+
+#include "tracer.h"
+
+namespace genetic_algorithm::detail
+{
+#ifdef GA_ENABLE_PROFILING
+    inline constexpr bool PROFILING_ENABLED = true;
+#else
+    inline constexpr bool PROFILING_ENABLED = false;
+#endif
+
+    /** The phases of a generation of the genetic algorithms that are measured separately. */
+    enum class Phase : size_t
+    {
+        prep_selections,            /**< Calculating the selection weights / non-dominated sorting etc. before the selections. */
+        selection,                  /**< Selecting the parents of the next generation. */
+        crossover,                  /**< Performing the crossovers. */
+        mutation,                   /**< Performing the mutations. */
+        custom_breeding,            /**< Creating the children with the custom breeding method of the algorithm instead of the genetic operators (e.g. differential evolution). */
+        repair,                     /**< Applying the repair function to the children. */
+        check_constraints,          /**< Checking the constraints of the candidates before their evaluation. */
+        surrogate_screening,        /**< Predicting the fitness of the children with the surrogate model and discarding the least promising ones. */
+        low_fidelity_evaluate,      /**< Evaluating the children with the low-fidelity functions and discarding the ones not promoted. */
+        evaluate,                   /**< Evaluating the fitness of the candidates. */
+        pipelined_breeding,         /**< Creating and evaluating the children in one pass, when GA::pipelined_breeding is set. */
+        update_population,          /**< Creating the population of the next generation. */
+        local_search,               /**< Improving the candidates of the population with a local search (RCGA memetic mode). */
+        update_optimal_solutions,   /**< Updating the set of optimal solutions found. */
+        update_stats,               /**< Updating the history of the fitness values. */
+        callback                    /**< Calling the end of generation callback. */
+    };
+
+    inline constexpr size_t NUM_PHASES = 16;
+
+    /* Returns the name of the phase as a string. */
+    inline const char* phaseName(Phase phase) noexcept;
+
+    /** The measurements made for a single phase of the algorithm. */
+    struct PhaseStats
+    {
+        double wall_time = 0.0;     /**< The wall-clock time spent in the phase (in seconds). */
+        double cpu_time = 0.0;      /**< The processor time used by the process in the phase, summed over all threads (in seconds). */
+        size_t calls = 0;           /**< The number of times the phase was executed. */
+        size_t candidates = 0;      /**< The number of candidates processed in the phase. */
+
+        PhaseStats& operator+=(const PhaseStats& rhs) noexcept;
+    };
+
+    /** The measurements of every phase of the algorithm. */
+    using PhaseStatsArray = std::array<PhaseStats, NUM_PHASES>;
+
+    /**
+    * Histogram of the fitness function evaluation latencies, with logarithmic bins. \n
+    * The bin i contains the latencies on the interval [2^i, 2^(i+1)) nanoseconds. \n
+    * Latencies can be added from multiple threads concurrently.
+    */
+    class LatencyHistogram
+    {
+    public:
+
+        static constexpr size_t NUM_BINS = 48;
+
+        LatencyHistogram() = default;
+        LatencyHistogram(const LatencyHistogram& other) noexcept;
+        LatencyHistogram& operator=(const LatencyHistogram& other) noexcept;
+
+        /* Add a latency of ns nanoseconds to the histogram. Thread-safe. */
+        void add(size_t ns) noexcept;
+        void clear() noexcept;
+
+        /** @returns The number of latencies in the bin @p idx. */
+        [[nodiscard]] size_t bin(size_t idx) const noexcept;
+
+        /** @returns The total number of latencies in the histogram. */
+        [[nodiscard]] size_t count() const noexcept;
+
+        /** @returns The mean of the latencies (in nanoseconds). */
+        [[nodiscard]] double mean() const noexcept;
+
+        /** @returns The largest latency (in nanoseconds). */
+        [[nodiscard]] size_t max() const noexcept;
+
+        /**
+        * @returns An estimate of the @p p quantile of the latencies (in nanoseconds), @p p must be on [0.0, 1.0]. \n
+        * The estimate is the upper bound of the bin the quantile falls in.
+        */
+        [[nodiscard]] double quantile(double p) const noexcept;
+
+    private:
+
+        std::array<std::atomic<size_t>, NUM_BINS> bins_ = {};
+        std::atomic<size_t> sum_ = 0;
+        std::atomic<size_t> max_ = 0;
+    };
+
+    /** The measurements made in a single generation of the algorithm. */
+    struct GenerationProfile
+    {
+        size_t generation = 0;      /**< The number of the generation. */
+        PhaseStatsArray phases;     /**< The measurements of each phase in the generation. @see Phase */
+
+        const PhaseStats& operator[](Phase phase) const noexcept { return phases[static_cast<size_t>(phase)]; }
+    };
+
+    /** The measurements made in a run of the algorithm. */
+    struct Profile
+    {
+        PhaseStatsArray phases;             /**< The total measurements of each phase. @see Phase */
+        LatencyHistogram eval_latency;      /**< The latencies of the fitness function evaluations. */
+        double wall_time = 0.0;             /**< The wall-clock time of the whole run (in seconds). */
+        double cpu_time = 0.0;              /**< The processor time used by the process in the whole run (in seconds). */
+
+        const PhaseStats& operator[](Phase phase) const noexcept { return phases[static_cast<size_t>(phase)]; }
+
+        void clear() noexcept;
+    };
+
+    /*
+    * Collects the measurements during a run of the algorithm. \n
+    * The member functions (except evalStart and addEvaluation) must only be called from the thread running the algorithm.
+    * All of them are no-ops if PROFILING_ENABLED is false, except for recording the trace events if the tracer is active.
+    */
+    class Profiler
+    {
+    public:
+
+        using Clock = std::chrono::steady_clock;
+
+        /* Measures the time spent in a phase from its construction until its destruction. */
+        class ScopedTimer
+        {
+        public:
+            ScopedTimer(Profiler& profiler, Phase phase, size_t candidates) noexcept;
+            ~ScopedTimer();
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        private:
+            Profiler& profiler_;
+            Phase phase_;
+            size_t candidates_;
+            Clock::time_point wall_start_;
+            std::clock_t cpu_start_;
+            bool tracing_;
+        };
+
+        /* Measures the time spent in the phase until the end of the scope. */
+        [[nodiscard]] ScopedTimer time(Phase phase, size_t candidates = 0) noexcept { return ScopedTimer(*this, phase, candidates); }
+
+        /* Starts a new run, clearing the previous measurements. */
+        void beginRun();
+        void endRun() noexcept;
+
+        /* Finishes the measurements of the current generation and starts the next one. */
+        void endGeneration(size_t generation);
+
+        /* Returns the start time of a fitness evaluation if it needs to be measured. Thread-safe. */
+        [[nodiscard]] Clock::time_point evalStart() const noexcept;
+
+        /* Add a fitness evaluation started at start (returned by evalStart) and ending now. Thread-safe. */
+        void addEvaluation(Clock::time_point start);
+
+        [[nodiscard]] const Profile& profile() const noexcept { return profile_; }
+        [[nodiscard]] const std::vector<GenerationProfile>& generations() const noexcept { return generations_; }
+
+        bool record_generations = false;    /* Store the measurements of each generation separately. */
+        Tracer tracer;                      /* Records the phases and evaluations as trace events when it is open. */
+
+    private:
+
+        Profile profile_;
+        PhaseStatsArray current_;
+        std::vector<GenerationProfile> generations_;
+        Clock::time_point run_wall_start_;
+        std::clock_t run_cpu_start_ = 0;
+
+        void add(Phase phase, const PhaseStats& stats) noexcept;
+    };
+
+} // namespace genetic_algorithm::detail
+
+
+/* IMPLEMENTATION */
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdlib>
+
+namespace genetic_algorithm::detail
+{
+    inline const char* phaseName(Phase phase) noexcept
+    {
+        switch (phase)
+        {
+            case Phase::prep_selections:            return "prep_selections";
+            case Phase::selection:                  return "selection";
+            case Phase::crossover:                  return "crossover";
+            case Phase::mutation:                   return "mutation";
+            case Phase::custom_breeding:            return "custom_breeding";
+            case Phase::repair:                     return "repair";
+            case Phase::check_constraints:          return "check_constraints";
+            case Phase::surrogate_screening:        return "surrogate_screening";
+            case Phase::low_fidelity_evaluate:      return "low_fidelity_evaluate";
+            case Phase::evaluate:                   return "evaluate";
+            case Phase::pipelined_breeding:         return "pipelined_breeding";
+            case Phase::update_population:          return "update_population";
+            case Phase::local_search:               return "local_search";
+            case Phase::update_optimal_solutions:   return "update_optimal_solutions";
+            case Phase::update_stats:               return "update_stats";
+            case Phase::callback:                   return "callback";
+            default:
+                assert(false);    /* Invalid phase, shouldn't get here. */
+                std::abort();
+        }
+    }
+
+    inline PhaseStats& PhaseStats::operator+=(const PhaseStats& rhs) noexcept
+    {
+        wall_time += rhs.wall_time;
+        cpu_time += rhs.cpu_time;
+        calls += rhs.calls;
+        candidates += rhs.candidates;
+
+        return *this;
+    }
+
+    inline LatencyHistogram::LatencyHistogram(const LatencyHistogram& other) noexcept
+    {
+        *this = other;
+    }
+
+    inline LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other) noexcept
+    {
+        for (size_t i = 0; i < NUM_BINS; i++)
+        {
+            bins_[i].store(other.bins_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        sum_.store(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        max_.store(other.max_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    inline void LatencyHistogram::add(size_t ns) noexcept
+    {
+        size_t idx = std::min(size_t(std::bit_width(ns)) - (ns != 0), NUM_BINS - 1);
+
+        bins_[idx].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+
+        size_t old_max = max_.load(std::memory_order_relaxed);
+        while (ns > old_max && !max_.compare_exchange_weak(old_max, ns, std::memory_order_relaxed)) {}
+    }
+
+    inline void LatencyHistogram::clear() noexcept
+    {
+        for (auto& bin : bins_) bin.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    inline size_t LatencyHistogram::bin(size_t idx) const noexcept
+    {
+        assert(idx < NUM_BINS);
+
+        return bins_[idx].load(std::memory_order_relaxed);
+    }
+
+    inline size_t LatencyHistogram::count() const noexcept
+    {
+        size_t total = 0;
+        for (const auto& bin : bins_) total += bin.load(std::memory_order_relaxed);
+
+        return total;
+    }
+
+    inline double LatencyHistogram::mean() const noexcept
+    {
+        size_t n = count();
+
+        return n ? double(sum_.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    inline size_t LatencyHistogram::max() const noexcept
+    {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    inline double LatencyHistogram::quantile(double p) const noexcept
+    {
+        assert(0.0 <= p && p <= 1.0);
+
+        size_t n = count();
+        if (n == 0) return 0.0;
+
+        size_t target = std::max(size_t(p * n + 0.5), size_t{ 1 });
+        size_t cumulative = 0;
+        for (size_t i = 0; i < NUM_BINS; i++)
+        {
+            cumulative += bin(i);
+            if (cumulative >= target) return std::min(double(size_t{ 1 } << (i + 1)), double(max()));
+        }
+
+        return double(max());
+    }
+
+    inline void Profile::clear() noexcept
+    {
+        phases = {};
+        eval_latency.clear();
+        wall_time = 0.0;
+        cpu_time = 0.0;
+    }
+
+    inline Profiler::ScopedTimer::ScopedTimer(Profiler& profiler, Phase phase, size_t candidates) noexcept
+        : profiler_(profiler), phase_(phase), candidates_(candidates), tracing_(profiler.tracer.active())
+    {
+        if constexpr (PROFILING_ENABLED)
+        {
+            cpu_start_ = std::clock();
+        }
+        if (PROFILING_ENABLED || tracing_)
+        {
+            wall_start_ = Clock::now();
+        }
+    }
+
+    inline Profiler::ScopedTimer::~ScopedTimer()
+    {
+        if (!PROFILING_ENABLED && !tracing_) return;
+
+        Clock::time_point wall_end = Clock::now();
+        if (tracing_)
+        {
+            profiler_.tracer.complete(phaseName(phase_), "phase", wall_start_, wall_end);
+        }
+        if constexpr (PROFILING_ENABLED)
+        {
+            PhaseStats stats;
+            stats.wall_time = std::chrono::duration<double>(wall_end - wall_start_).count();
+            stats.cpu_time = double(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+            stats.calls = 1;
+            stats.candidates = candidates_;
+
+            profiler_.add(phase_, stats);
+        }
+    }
+
+    inline void Profiler::beginRun()
+    {
+        if constexpr (PROFILING_ENABLED)
+        {
+            profile_.clear();
+            current_ = {};
+            generations_.clear();
+            run_wall_start_ = Clock::now();
+            run_cpu_start_ = std::clock();
+        }
+    }
+
+    inline void Profiler::endRun() noexcept
+    {
+        if constexpr (PROFILING_ENABLED)
+        {
+            profile_.wall_time = std::chrono::duration<double>(Clock::now() - run_wall_start_).count();
+            profile_.cpu_time = double(std::clock() - run_cpu_start_) / CLOCKS_PER_SEC;
+        }
+    }
+
+    inline void Profiler::endGeneration(size_t generation)
+    {
+        if constexpr (PROFILING_ENABLED)
+        {
+            if (record_generations) generations_.push_back({ generation, current_ });
+            current_ = {};
+        }
+    }
+
+    inline Profiler::Clock::time_point Profiler::evalStart() const noexcept
+    {
+        if (PROFILING_ENABLED || tracer.active()) return Clock::now();
+        else return {};
+    }
+
+    inline void Profiler::addEvaluation(Clock::time_point start)
+    {
+        if (!PROFILING_ENABLED && !tracer.active()) return;
+
+        Clock::time_point end = Clock::now();
+        if constexpr (PROFILING_ENABLED)
+        {
+            profile_.eval_latency.add(size_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+        if (tracer.active())
+        {
+            tracer.complete("fitness_evaluation", "evaluate", start, end);
+        }
+    }
+
+    inline void Profiler::add(Phase phase, const PhaseStats& stats) noexcept
+    {
+        profile_.phases[static_cast<size_t>(phase)] += stats;
+        current_[static_cast<size_t>(phase)] += stats;
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // !GA_PROFILER_H
\ No newline at end of file
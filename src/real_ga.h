@@ -32,9 +32,15 @@
 #define GA_RCGA_H
 
 #include <vector>
+#include <array>
+#include <atomic>
 #include <utility>
+#include <optional>
+#include <unordered_map>
+#include <span>
 
 #include "base_ga.h"
+#include "cma_es.h"
 
 namespace genetic_algorithm
 {
@@ -64,6 +70,8 @@ namespace genetic_algorithm
             blx_a,               /**< BLX-alpha (blend) crossover operator. @see blx_crossover_param */
             simulated_binary,    /**< Simulated binary crossover (SBX) operator. @see sim_binary_crossover_param */
             wright,              /**< Wright heuristic crossover (HX) operator. Uses no parameters. */
+            adaptive,            /**< Adaptive selection between the arithmetic, BLX-alpha, simulated binary, and Wright crossovers. The operators are chosen
+                                      with probabilities based on the improvements made by their children that survived to the next population. @see crossover_probabilities */
             custom               /**< Custom crossover operator defined by the user. @see setCrossoverFunction */
         };
 
@@ -80,9 +88,77 @@ namespace genetic_algorithm
             nonuniform,        /**<  Non-uniform mutation operator. @see nonuniform_mutation_param */
             boundary,          /**<  Boundary mutation operator. Uses no parameters. */
             gauss,             /**<  Gauss mutation operator. @see gauss_mutation_param */
+            self_adaptive,     /**<  Self-adaptive Gauss mutation operator, as in evolution strategies. Each candidate has its own step size for every gene,
+                                     which is adapted by log-normal self-adaptation before mutating the gene, and is recombined during the crossovers.
+                                     Every gene is mutated, the mutation rate isn't used. The initial step sizes are set by @ref gauss_mutation_param. */
             custom             /**<  Custom mutation operator defined by the user. Uses the @ref customMutate to perform the mutations. */
         };
 
+        /**
+        * The local search methods that can be used to refine the best candidates of the population in the
+        * memetic mode of the RCGA. The local searches are gradient-free, and only use the fitness function. \n
+        * Set the local search method used in the algorithm with @ref local_search_method.
+        */
+        enum class LocalSearchMethod
+        {
+            none,               /**< No local search is performed (default). */
+            nelder_mead,        /**< Nelder-Mead simplex method. */
+            pattern_search      /**< Coordinate (compass) pattern search, moving one gene at a time. */
+        };
+
+        /**
+        * The differential evolution (DE) strategies that can be used in the RCGA instead of the genetic operators. \n
+        * In differential evolution, a trial vector is created for every candidate of the population (the target vector)
+        * by adding scaled differences of other candidates to a base vector, and mixing the result with the target vector
+        * (binomial crossover). The trial vector replaces its target in the next population if it isn't worse. \n
+        * The selection, crossover, and mutation settings of the RCGA are not used when differential evolution is used.
+        * Set the strategy used with @ref de_strategy.
+        */
+        enum class DeStrategy
+        {
+            none,               /**< Use the genetic operators instead of differential evolution (default). */
+            rand_1_bin,         /**< DE/rand/1/bin: the base vector is a random candidate, using one difference vector. @see de_scale_factor @see de_crossover_rate */
+            best_1_bin,         /**< DE/best/1/bin: the base vector is the best candidate, using one difference vector. @see de_scale_factor @see de_crossover_rate */
+            current_to_pbest    /**< DE/current-to-pbest/1/bin with an external archive of the replaced candidates, and success-history based
+                                     adaptation of the scale factor and crossover rate (SHADE). @see de_pbest_fraction */
+        };
+
+        /**
+        * The covariance matrix adaptation evolution strategy (CMA-ES) variants that can be used in the RCGA instead of the genetic operators. \n
+        * CMA-ES samples the children from a multivariate normal distribution, and adapts the mean, step size, and covariance matrix
+        * of the distribution using the best children. The distribution is adapted in the search space normalized using the
+        * bounds of the genes, and the children outside the bounds are reflected back into them. \n
+        * The population size is used as the number of children sampled in each generation (lambda), the commonly recommended
+        * value is 4 + 3 * ln(chrom_len). The selection, crossover, and mutation settings of the RCGA are not used in this mode.
+        * Set the variant used with @ref cma_es.
+        */
+        enum class CmaEsMode
+        {
+            none,       /**< Use the genetic operators instead of CMA-ES (default). */
+            full,       /**< Adapt the full covariance matrix. The cost of a generation is quadratic in the number of genes, suitable for up to a few hundred genes. */
+            separable   /**< Only adapt the diagonal of the covariance matrix (sep-CMA-ES). The cost of a generation is linear in the number of genes, suitable for thousands of genes. */
+        };
+
+        /**
+        * The restart strategies of CMA-ES, used when the search has converged or the distribution became ill-conditioned. \n
+        * Each restart starts from a random point of the search space. Set the strategy used with @ref cma_es_restarts.
+        */
+        enum class CmaEsRestart
+        {
+            none,   /**< Never restart the search. */
+            ipop,   /**< Double the population size at each restart (IPOP-CMA-ES, default). */
+            bipop   /**< Alternate between restarts with doubled population sizes and restarts with small population sizes and step sizes,
+                         balancing the number of fitness evaluations used by the two regimes (BIPOP-CMA-ES). */
+        };
+
+        /**
+        * True if the results of the local searches should replace the candidates they were started from (Lamarckian learning),
+        * false if only their fitness values should be replaced (Baldwinian learning). \n
+        * In the Baldwinian case, the improved solutions found by the local searches are still added to the optimal solutions found.
+        * @see local_search_method
+        */
+        bool lamarckian_local_search = true;
+
         /**
         * Basic constructor for the RCGA.
         *
@@ -196,6 +272,143 @@ namespace genetic_algorithm
         void gauss_mutation_param(double sigmas);
         [[nodiscard]] double gauss_mutation_param() const;
 
+        /**
+        * @returns The current probabilities of choosing the arithmetic, BLX-alpha, simulated binary, and Wright crossovers
+        * (in this order) when the adaptive crossover method is used. @see CrossoverMethod
+        */
+        [[nodiscard]] std::vector<double> crossover_probabilities() const;
+
+        /**
+        * Sets the local search method used to refine the best candidates of the population (memetic mode) to @p method. \n
+        * The local searches are performed every @ref local_search_period generations on the @ref local_search_candidates
+        * best candidates, in parallel, with each search using at most @ref local_search_evals fitness evaluations.
+        * These evaluations are included in the number of fitness evaluations, and the searches are stopped early if the
+        * run is cancelled or the time/processor time budget of the stop condition is used up. \n
+        * If the batch fitness function is set, the searches are performed one after the other instead, calling the batch
+        * fitness function with a single chromosome for each evaluation. \n
+        * Only works in the single-objective mode. The default is LocalSearchMethod::none.
+        *
+        * @param method The local search method to use.
+        */
+        void local_search_method(LocalSearchMethod method);
+        [[nodiscard]] LocalSearchMethod local_search_method() const;
+
+        /**
+        * Sets the number of the best candidates refined by the local search to @p count. @see local_search_method \n
+        * Must be at least 1, the default is 2.
+        *
+        * @param count The number of candidates refined.
+        */
+        void local_search_candidates(size_t count);
+        [[nodiscard]] size_t local_search_candidates() const;
+
+        /**
+        * Sets the number of generations between the local searches to @p period. @see local_search_method \n
+        * Must be at least 1, the default is 10.
+        *
+        * @param period The number of generations between the local searches.
+        */
+        void local_search_period(size_t period);
+        [[nodiscard]] size_t local_search_period() const;
+
+        /**
+        * Sets the maximum number of fitness evaluations used by a single local search to @p max_evals. @see local_search_method \n
+        * The local searches also stop early if they have converged, and they never exceed the budget of the fitness_evals stop condition.
+        * Must be at least 1, the default is 1000.
+        *
+        * @param max_evals The maximum number of fitness evaluations of a local search.
+        */
+        void local_search_evals(size_t max_evals);
+        [[nodiscard]] size_t local_search_evals() const;
+
+        /**
+        * Sets the differential evolution strategy used to create the children to @p strategy. @see DeStrategy \n
+        * Differential evolution only works in the single-objective mode, with a population size of at least 4,
+        * and it can't be used together with pipelined breeding, surrogate screening, or multi-fidelity evaluation.
+        * The default is DeStrategy::none, which means that the genetic operators are used instead.
+        *
+        * @param strategy The differential evolution strategy to use.
+        */
+        void de_strategy(DeStrategy strategy);
+        [[nodiscard]] DeStrategy de_strategy() const;
+
+        /**
+        * Sets the scale factor (F) of the difference vectors in differential evolution to @p F. \n
+        * With the current_to_pbest strategy, this is only the initial value of the adapted scale factors.
+        * Must be in the range (0.0, 2.0], the default is 0.5.
+        *
+        * @param F The scale factor of the difference vectors.
+        */
+        void de_scale_factor(double F);
+        [[nodiscard]] double de_scale_factor() const;
+
+        /**
+        * Sets the crossover rate (CR) of the binomial crossover in differential evolution to @p CR. \n
+        * With the current_to_pbest strategy, this is only the initial value of the adapted crossover rates.
+        * Must be in the range [0.0, 1.0], the default is 0.9.
+        *
+        * @param CR The probability of taking a gene of the trial vector from the mutant vector.
+        */
+        void de_crossover_rate(double CR);
+        [[nodiscard]] double de_crossover_rate() const;
+
+        /**
+        * Sets the fraction of the best candidates the pbest vectors are chosen from in the current_to_pbest strategy to @p p. \n
+        * Must be in the range (0.0, 1.0], the default is 0.1.
+        *
+        * @param p The fraction of the best candidates used as pbest vectors.
+        */
+        void de_pbest_fraction(double p);
+        [[nodiscard]] double de_pbest_fraction() const;
+
+        /**
+        * Sets the CMA-ES variant used to create the children to @p mode. @see CmaEsMode \n
+        * CMA-ES only works in the single-objective mode, and it can't be used together with differential evolution,
+        * pipelined breeding, surrogate screening, or multi-fidelity evaluation. \n
+        * As CMA-ES isn't elitist, the best solutions found are always archived, even if archive_optimal_solutions is false.
+        * The default is CmaEsMode::none, which means that the genetic operators are used instead.
+        *
+        * @param mode The CMA-ES variant to use.
+        */
+        void cma_es(CmaEsMode mode);
+        [[nodiscard]] CmaEsMode cma_es() const;
+
+        /**
+        * Sets the restart strategy used by CMA-ES to @p strategy. @see CmaEsRestart \n
+        * The default is CmaEsRestart::ipop.
+        *
+        * @param strategy The restart strategy to use.
+        */
+        void cma_es_restarts(CmaEsRestart strategy);
+        [[nodiscard]] CmaEsRestart cma_es_restarts() const;
+
+        /**
+        * Sets the initial step size of CMA-ES to @p sigma, relative to the ranges of the bounds of the genes. \n
+        * Must be in the range (0.0, 1.0], the default is 0.3.
+        *
+        * @param sigma The initial step size.
+        */
+        void cma_es_sigma(double sigma);
+        [[nodiscard]] double cma_es_sigma() const;
+
+        /**
+        * @returns The number of times CMA-ES was restarted during the last run.
+        */
+        [[nodiscard]] size_t cma_es_num_restarts() const noexcept;
+
+        /* The genetic operators of the RCGA. They can also be used on their own, eg. as the operators of a StaticGA. */
+        static CandidatePair arithmeticCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
+        static CandidatePair blxAlphaCrossover(const Candidate& parent1, const Candidate& parent2, double pc, double alpha, const limits_t& bounds);
+        static CandidatePair simulatedBinaryCrossover(const Candidate& parent1, const Candidate& parent2, double pc, double b, const limits_t& bounds);
+        static CandidatePair wrightCrossover(const Candidate& parent1, const Candidate& parent2, double pc, const limits_t& bounds);
+
+        static void randomMutate(Candidate& child, double pm, const limits_t& bounds);
+        static void nonuniformMutate(Candidate& child, double pm, size_t time, size_t time_max, double b, const limits_t& bounds);
+        static void polynomialMutate(Candidate& child, double pm, double eta, const limits_t& bounds);
+        static void boundaryMutate(Candidate& child, double pm, const limits_t& bounds);
+        static void gaussMutate(Candidate& child, double pm, double scale, const limits_t& bounds);
+        static void selfAdaptiveMutate(Candidate& child, std::span<double> step_sizes, const limits_t& bounds);
+
     private:
 
         limits_t limits_;
@@ -209,20 +422,93 @@ namespace genetic_algorithm
         double polynomial_mutation_param_ = 40.0;
         double gauss_mutation_param_ = 6.0;
 
+        LocalSearchMethod local_search_method_ = LocalSearchMethod::none;
+        size_t local_search_candidates_ = 2;
+        size_t local_search_period_ = 10;
+        size_t local_search_evals_ = 1000;
+
+        /* Hasher for the chromosomes, used to associate state with the candidates of the population. */
+        struct ChromosomeHasher
+        {
+            size_t operator()(const Chromosome& chrom) const noexcept;
+        };
+
+        /* The chromosomes of the candidates whose fitness values were improved by a Baldwinian local search, and their learned fitness values. */
+        std::unordered_map<Chromosome, double, ChromosomeHasher> learned_fitness_;
+
+        DeStrategy de_strategy_ = DeStrategy::none;
+        double de_scale_factor_ = 0.5;
+        double de_crossover_rate_ = 0.9;
+        double de_pbest_fraction_ = 0.1;
+
+        /* The state of the differential evolution in the current run. */
+        std::vector<double> de_trial_F_;            /* The scale factors used for each trial vector. */
+        std::vector<double> de_trial_CR_;           /* The crossover rates used for each trial vector. */
+        std::vector<double> de_memory_F_;           /* The success-history memory of the scale factors (SHADE). */
+        std::vector<double> de_memory_CR_;          /* The success-history memory of the crossover rates (SHADE). */
+        size_t de_memory_pos_ = 0;
+        std::vector<double> de_archive_;            /* The chromosomes replaced by better trial vectors, stored contiguously (SHADE). */
+
+        /* The state of the adaptive crossover operator selection. */
+        static constexpr size_t NUM_ADAPTIVE_CROSSOVERS = 4;
+        std::array<double, NUM_ADAPTIVE_CROSSOVERS> crossover_quality_ = {};    /* The moving averages of the rewards of the crossovers. */
+        std::array<double, NUM_ADAPTIVE_CROSSOVERS> crossover_probs_ = { 0.25, 0.25, 0.25, 0.25 };
+        mutable std::array<std::atomic<size_t>, NUM_ADAPTIVE_CROSSOVERS> crossover_attempts_ = {};
+
+        /*
+        * The layout of the strategy parameters of the candidates (Candidate::strategy_params) used by the adaptive crossover selection
+        * and the self-adaptive mutation. The parameters are carried by the children copied from their parents in the crossovers.
+        */
+        static constexpr size_t STRATEGY_CROSSOVER_OP = 0;      /* The index + 1 of the crossover operator that created the candidate with adaptive selection, 0 if none. */
+        static constexpr size_t STRATEGY_PARENT_FITNESS = 1;    /* The fitness of the better parent of the candidate if it has a crossover operator (single-objective). */
+        static constexpr size_t STRATEGY_STEP_SIZES = 2;        /* The self-adapted mutation step sizes of the genes, relative to the ranges of the genes. */
+
+        CmaEsMode cma_es_mode_ = CmaEsMode::none;
+        CmaEsRestart cma_es_restarts_ = CmaEsRestart::ipop;
+        double cma_es_sigma_ = 0.3;
+
+        /* The state of CMA-ES in the current run. */
+        std::optional<detail::CmaEs> cma_es_;
+        size_t cma_es_num_restarts_ = 0;
+        size_t cma_es_large_lambda_ = 0;        /* The population size of the last restart in the large population regime. */
+        size_t cma_es_large_evals_ = 0;         /* The number of fitness evaluations used in the large population regime (BIPOP). */
+        size_t cma_es_small_evals_ = 0;         /* The number of fitness evaluations used in the small population regime (BIPOP). */
+        bool cma_es_large_regime_ = true;
+
         Candidate generateCandidate() const override;
         CandidatePair crossover(const Candidate& p1, const Candidate& p2) const override;
         void mutate(Candidate& child) const override;
-
-        static CandidatePair arithmeticCrossover(const Candidate& parent1, const Candidate& parent2, double pc);
-        static CandidatePair blxAlphaCrossover(const Candidate& parent1, const Candidate& parent2, double pc, double alpha, const limits_t& bounds);
-        static CandidatePair simulatedBinaryCrossover(const Candidate& parent1, const Candidate& parent2, double pc, double b, const limits_t& bounds);
-        static CandidatePair wrightCrossover(const Candidate& parent1, const Candidate& parent2, double pc, const limits_t& bounds);
-
-        static void randomMutate(Candidate& child, double pm, const limits_t& bounds);
-        static void nonuniformMutate(Candidate& child, double pm, size_t time, size_t time_max, double b, const limits_t& bounds);
-        static void polynomialMutate(Candidate& child, double pm, double eta, const limits_t& bounds);
-        static void boundaryMutate(Candidate& child, double pm, const limits_t& bounds);
-        static void gaussMutate(Candidate& child, double pm, double scale, const limits_t& bounds);
+        void improvePopulation(Population& pop) override;
+        void initAlgorithm() override;
+        bool hasLearnedFitness(const Candidate& sol) const override;
+
+        CandidatePair adaptiveCrossover(const Candidate& p1, const Candidate& p2, size_t& op) const;
+        void updateCrossoverProbabilities(const Population& pop);
+
+        bool usesStrategyParams() const noexcept;
+        void initStrategyParams(Candidate& sol) const;
+
+        bool usesCustomBreeding() const noexcept override { return de_strategy_ != DeStrategy::none || cma_es_mode_ != CmaEsMode::none; }
+        CandidateVec customBreed(const Population& pop) override;
+        Population customUpdatePopulation(Population& old_pop, CandidateVec& children) override;
+
+        CandidateVec deBreed(const Population& pop);
+        Population deUpdatePopulation(Population& old_pop, CandidateVec& children);
+        CandidateVec cmaEsBreed(const Population& pop);
+        Population cmaEsUpdatePopulation(Population& old_pop, CandidateVec& children);
+        void cmaEsRestart();
+
+        /* Convert between the chromosomes and the points of the search space normalized using the bounds (used by CMA-ES). */
+        std::vector<double> normalizedPoint(const Chromosome& chrom) const;
+        Chromosome denormalizedPoint(const double* y) const;
+
+        /*
+        * Creates the trial vector of differential evolution from the target vector: trial = base + F * (x1 - x2) + F * (x3 - x4), with
+        * the second difference only used if x3 isn't a nullptr, and binomial crossover with the target using the crossover rate CR.
+        * The genes outside the bounds are placed halfway between the target gene and the bound.
+        */
+        static void deTrialVector(double* trial, const double* target, const double* base, const double* x1, const double* x2,
+                                  const double* x3, const double* x4, double F, double CR, const limits_t& bounds);
     };
 
 } // namespace genetic_algorithm
@@ -231,7 +517,12 @@ namespace genetic_algorithm
 /* IMPLEMENTATION */
 
 #include <algorithm>
+#include <numeric>
+#include <numbers>
+#include <execution>
+#include <initializer_list>
 #include <limits>
+#include <functional>
 #include <stdexcept>
 #include <cmath>
 #include <cstddef>
@@ -239,6 +530,7 @@ namespace genetic_algorithm
 #include <cassert>
 
 #include "rng.h"
+#include "local_search.h"
 
 namespace genetic_algorithm
 {
@@ -287,7 +579,7 @@ namespace genetic_algorithm
 
     inline void RCGA::crossover_method(CrossoverMethod method)
     {
-        if (static_cast<size_t>(method) > 4) throw std::invalid_argument("Invalid crossover method selected.");
+        if (static_cast<size_t>(method) > 5) throw std::invalid_argument("Invalid crossover method selected.");
 
         crossover_method_ = method;
     }
@@ -307,7 +599,7 @@ namespace genetic_algorithm
 
     inline void RCGA::mutation_method(MutationMethod method)
     {
-        if (static_cast<size_t>(method) > 5) throw std::invalid_argument("Invalid mutation method selected.");
+        if (static_cast<size_t>(method) > 6) throw std::invalid_argument("Invalid mutation method selected.");
 
         mutation_method_ = method;
     }
@@ -411,6 +703,148 @@ namespace genetic_algorithm
         return gauss_mutation_param_;
     }
 
+    inline std::vector<double> RCGA::crossover_probabilities() const
+    {
+        return std::vector<double>(crossover_probs_.begin(), crossover_probs_.end());
+    }
+
+    inline void RCGA::local_search_method(LocalSearchMethod method)
+    {
+        if (static_cast<size_t>(method) > 2) throw std::invalid_argument("Invalid local search method selected.");
+
+        local_search_method_ = method;
+    }
+
+    inline RCGA::LocalSearchMethod RCGA::local_search_method() const
+    {
+        return local_search_method_;
+    }
+
+    inline void RCGA::local_search_candidates(size_t count)
+    {
+        if (count == 0) throw std::invalid_argument("The number of candidates refined by the local search must be at least 1.");
+
+        local_search_candidates_ = count;
+    }
+
+    inline size_t RCGA::local_search_candidates() const
+    {
+        return local_search_candidates_;
+    }
+
+    inline void RCGA::local_search_period(size_t period)
+    {
+        if (period == 0) throw std::invalid_argument("The local search period must be at least 1.");
+
+        local_search_period_ = period;
+    }
+
+    inline size_t RCGA::local_search_period() const
+    {
+        return local_search_period_;
+    }
+
+    inline void RCGA::local_search_evals(size_t max_evals)
+    {
+        if (max_evals == 0) throw std::invalid_argument("The number of fitness evaluations of a local search must be at least 1.");
+
+        local_search_evals_ = max_evals;
+    }
+
+    inline size_t RCGA::local_search_evals() const
+    {
+        return local_search_evals_;
+    }
+
+    inline void RCGA::de_strategy(DeStrategy strategy)
+    {
+        if (static_cast<size_t>(strategy) > 3) throw std::invalid_argument("Invalid differential evolution strategy selected.");
+
+        de_strategy_ = strategy;
+    }
+
+    inline RCGA::DeStrategy RCGA::de_strategy() const
+    {
+        return de_strategy_;
+    }
+
+    inline void RCGA::de_scale_factor(double F)
+    {
+        if (!(0.0 < F && F <= 2.0)) throw std::invalid_argument("The scale factor of differential evolution must be in the range (0.0, 2.0].");
+
+        de_scale_factor_ = F;
+    }
+
+    inline double RCGA::de_scale_factor() const
+    {
+        return de_scale_factor_;
+    }
+
+    inline void RCGA::de_crossover_rate(double CR)
+    {
+        if (!(0.0 <= CR && CR <= 1.0)) throw std::invalid_argument("The crossover rate of differential evolution must be in the range [0.0, 1.0].");
+
+        de_crossover_rate_ = CR;
+    }
+
+    inline double RCGA::de_crossover_rate() const
+    {
+        return de_crossover_rate_;
+    }
+
+    inline void RCGA::de_pbest_fraction(double p)
+    {
+        if (!(0.0 < p && p <= 1.0)) throw std::invalid_argument("The pbest fraction of differential evolution must be in the range (0.0, 1.0].");
+
+        de_pbest_fraction_ = p;
+    }
+
+    inline double RCGA::de_pbest_fraction() const
+    {
+        return de_pbest_fraction_;
+    }
+
+    inline void RCGA::cma_es(CmaEsMode mode)
+    {
+        if (static_cast<size_t>(mode) > 2) throw std::invalid_argument("Invalid CMA-ES mode selected.");
+
+        cma_es_mode_ = mode;
+    }
+
+    inline RCGA::CmaEsMode RCGA::cma_es() const
+    {
+        return cma_es_mode_;
+    }
+
+    inline void RCGA::cma_es_restarts(CmaEsRestart strategy)
+    {
+        if (static_cast<size_t>(strategy) > 2) throw std::invalid_argument("Invalid CMA-ES restart strategy selected.");
+
+        cma_es_restarts_ = strategy;
+    }
+
+    inline RCGA::CmaEsRestart RCGA::cma_es_restarts() const
+    {
+        return cma_es_restarts_;
+    }
+
+    inline void RCGA::cma_es_sigma(double sigma)
+    {
+        if (!(0.0 < sigma && sigma <= 1.0)) throw std::invalid_argument("The initial step size of CMA-ES must be in the range (0.0, 1.0].");
+
+        cma_es_sigma_ = sigma;
+    }
+
+    inline double RCGA::cma_es_sigma() const
+    {
+        return cma_es_sigma_;
+    }
+
+    inline size_t RCGA::cma_es_num_restarts() const noexcept
+    {
+        return cma_es_num_restarts_;
+    }
+
 
     inline RCGA::Candidate RCGA::generateCandidate() const
     {
@@ -429,26 +863,153 @@ namespace genetic_algorithm
 
     inline RCGA::CandidatePair RCGA::crossover(const Candidate& p1, const Candidate& p2) const
     {
+        CandidatePair children;
+        size_t op = 0;
         switch (crossover_method_)
         {
             case CrossoverMethod::arithmetic:
-                return arithmeticCrossover(p1, p2, crossover_rate_);
+                children = arithmeticCrossover(p1, p2, crossover_rate_);
+                break;
             case CrossoverMethod::blx_a:
-                return blxAlphaCrossover(p1, p2, crossover_rate_, blx_crossover_param_, limits_);
+                children = blxAlphaCrossover(p1, p2, crossover_rate_, blx_crossover_param_, limits_);
+                break;
             case CrossoverMethod::simulated_binary:
-                return simulatedBinaryCrossover(p1, p2, crossover_rate_, sim_binary_crossover_param_, limits_);
+                children = simulatedBinaryCrossover(p1, p2, crossover_rate_, sim_binary_crossover_param_, limits_);
+                break;
             case CrossoverMethod::wright:
-                return wrightCrossover(p1, p2, crossover_rate_, limits_);
+                children = wrightCrossover(p1, p2, crossover_rate_, limits_);
+                break;
+            case CrossoverMethod::adaptive:
+                children = adaptiveCrossover(p1, p2, op);
+                break;
             case CrossoverMethod::custom:
-                return customCrossover(p1, p2, crossover_rate_);
+                children = customCrossover(p1, p2, crossover_rate_);
+                break;
             default:
                 assert(false);    /* Invalid crossover method. Shouldn't get here. */
                 std::abort();
         }
+
+        if (!usesStrategyParams()) return children;
+
+        /* The children of the skipped crossovers are just the parents, and they keep the strategy parameters of the parents. */
+        for (Candidate* child : { &children.first, &children.second })
+        {
+            if (child->is_evaluated) continue;
+
+            initStrategyParams(*child);
+            if (mutation_method_ == MutationMethod::self_adaptive && p1.strategy_params.size() == p2.strategy_params.size() &&
+                p1.strategy_params.size() == child->strategy_params.size())
+            {
+                /* Intermediate (geometric mean) recombination of the step sizes of the parents. */
+                for (size_t i = STRATEGY_STEP_SIZES; i < child->strategy_params.size(); i++)
+                {
+                    child->strategy_params[i] = std::sqrt(p1.strategy_params[i] * p2.strategy_params[i]);
+                }
+            }
+            if (crossover_method_ == CrossoverMethod::adaptive)
+            {
+                /* Tag the children so the operator can be credited if they survive. */
+                crossover_attempts_[op].fetch_add(1, std::memory_order_relaxed);
+                child->strategy_params[STRATEGY_CROSSOVER_OP] = double(op + 1);
+                child->strategy_params[STRATEGY_PARENT_FITNESS] = (mode_ == Mode::single_objective) ? std::max(p1.fitness[0], p2.fitness[0]) : 0.0;
+            }
+        }
+
+        return children;
+    }
+
+    inline RCGA::CandidatePair RCGA::adaptiveCrossover(const Candidate& p1, const Candidate& p2, size_t& op) const
+    {
+        /* Roulette wheel selection of the operator. */
+        op = NUM_ADAPTIVE_CROSSOVERS - 1;
+        double threshold = rng::randomReal();
+        double cdf = 0.0;
+        for (size_t i = 0; i < NUM_ADAPTIVE_CROSSOVERS; i++)
+        {
+            cdf += crossover_probs_[i];
+            if (threshold < cdf)
+            {
+                op = i;
+                break;
+            }
+        }
+
+        CandidatePair children;
+        switch (op)
+        {
+            case 0:
+                children = arithmeticCrossover(p1, p2, crossover_rate_);
+                break;
+            case 1:
+                children = blxAlphaCrossover(p1, p2, crossover_rate_, blx_crossover_param_, limits_);
+                break;
+            case 2:
+                children = simulatedBinaryCrossover(p1, p2, crossover_rate_, sim_binary_crossover_param_, limits_);
+                break;
+            case 3:
+                children = wrightCrossover(p1, p2, crossover_rate_, limits_);
+                break;
+            default:
+                assert(false);    /* Invalid crossover operator. Shouldn't get here. */
+                std::abort();
+        }
+
+        return children;
+    }
+
+    inline void RCGA::updateCrossoverProbabilities(const Population& pop)
+    {
+        using namespace std;
+
+        /* Probability matching: each operator gets a minimum probability, and the rest is distributed proportionally to their qualities. */
+        constexpr double adaptation_rate = 0.3;
+        constexpr double min_prob = 0.05;
+
+        /*
+        * Only the children that survived to the next population are credited. In the single-objective mode, the reward of an operator
+        * is the largest improvement of its children over their parents (extreme value based credit, which doesn't favor the operators
+        * that only make many small improvements), normalized by the largest reward. In the multi-objective modes, the reward is the
+        * survival rate of the children of the operator.
+        */
+        array<double, NUM_ADAPTIVE_CROSSOVERS> rewards = {};
+        array<size_t, NUM_ADAPTIVE_CROSSOVERS> attempts = {};
+        for (size_t i = 0; i < NUM_ADAPTIVE_CROSSOVERS; i++) attempts[i] = crossover_attempts_[i].exchange(0);
+
+        for (const auto& sol : pop)
+        {
+            if (sol.strategy_params.empty() || sol.strategy_params[STRATEGY_CROSSOVER_OP] == 0.0) continue;
+
+            size_t op = size_t(sol.strategy_params[STRATEGY_CROSSOVER_OP]) - 1;
+            if (mode_ == Mode::single_objective)
+            {
+                rewards[op] = max(rewards[op], sol.fitness[0] - sol.strategy_params[STRATEGY_PARENT_FITNESS]);
+            }
+            else if (attempts[op] != 0)
+            {
+                rewards[op] += 1.0 / attempts[op];
+            }
+        }
+        double max_reward = *max_element(rewards.begin(), rewards.end());
+        for (size_t i = 0; i < NUM_ADAPTIVE_CROSSOVERS; i++)
+        {
+            if (attempts[i] == 0) continue;
+            double reward = (mode_ == Mode::single_objective) ? ((max_reward > 0.0) ? rewards[i] / max_reward : 0.0) : rewards[i];
+            crossover_quality_[i] = (1.0 - adaptation_rate) * crossover_quality_[i] + adaptation_rate * reward;
+        }
+
+        double quality_sum = accumulate(crossover_quality_.begin(), crossover_quality_.end(), 0.0);
+        for (size_t i = 0; i < NUM_ADAPTIVE_CROSSOVERS; i++)
+        {
+            crossover_probs_[i] = (quality_sum > 0.0)
+                ? min_prob + (1.0 - NUM_ADAPTIVE_CROSSOVERS * min_prob) * crossover_quality_[i] / quality_sum
+                : 1.0 / NUM_ADAPTIVE_CROSSOVERS;
+        }
     }
 
     inline void RCGA::mutate(Candidate& child) const
     {
+
         switch (mutation_method_)
         {
             case MutationMethod::random:
@@ -466,6 +1027,10 @@ namespace genetic_algorithm
             case MutationMethod::gauss:
                 gaussMutate(child, mutation_rate_, gauss_mutation_param_, limits_);
                 break;
+            case MutationMethod::self_adaptive:
+                initStrategyParams(child);
+                selfAdaptiveMutate(child, std::span(child.strategy_params).subspan(STRATEGY_STEP_SIZES), limits_);
+                break;
             case MutationMethod::custom:
                 customMutate(child, mutation_rate_);
                 break;
@@ -475,6 +1040,541 @@ namespace genetic_algorithm
         }
     }
 
+    inline void RCGA::improvePopulation(Population& pop)
+    {
+        using namespace std;
+
+        if (usesStrategyParams() && crossover_method_ == CrossoverMethod::adaptive)
+        {
+            updateCrossoverProbabilities(pop);
+
+            /* The crossover operators are only credited once for each child. */
+            for (auto& sol : pop)
+            {
+                if (!sol.strategy_params.empty()) sol.strategy_params[STRATEGY_CROSSOVER_OP] = 0.0;
+            }
+        }
+
+        if (local_search_method_ == LocalSearchMethod::none) return;
+
+        /* Forget the learned fitness values of the candidates that are no longer in the population. */
+        if (!learned_fitness_.empty())
+        {
+            unordered_map<Chromosome, double, ChromosomeHasher> learned_fitness;
+            for (const auto& sol : pop)
+            {
+                if (hasLearnedFitness(sol)) learned_fitness.emplace(sol.chromosome, sol.fitness[0]);
+            }
+            learned_fitness_ = move(learned_fitness);
+        }
+
+        if ((generation_cntr_ + 1) % local_search_period_ != 0 || cancellation_token_.cancelled()) return;
+
+        /* Refine the best feasible candidates. The candidates with learned fitness values were already refined. */
+        vector<size_t> indices;
+        for (size_t i = 0; i < pop.size(); i++)
+        {
+            if (pop[i].constraint_violation == 0.0 && !hasLearnedFitness(pop[i])) indices.push_back(i);
+        }
+        size_t num_searches = min(local_search_candidates_, indices.size());
+        if (num_searches == 0) return;
+
+        partial_sort(indices.begin(), indices.begin() + num_searches, indices.end(),
+        [&pop](size_t lidx, size_t ridx)
+        {
+            return pop[lidx].fitness[0] > pop[ridx].fitness[0];
+        });
+        indices.resize(num_searches);
+
+        /* Don't exceed the fitness evaluation budget. */
+        size_t max_evals = local_search_evals_;
+        if (stop_condition_ == StopCondition::fitness_evals)
+        {
+            size_t remaining = (max_fitness_evals_ > num_fitness_evals_) ? max_fitness_evals_ - num_fitness_evals_ : 0;
+            max_evals = min(max_evals, remaining / num_searches);
+        }
+        if (max_evals == 0) return;
+
+        /*
+        * The infeasible points are worse than any feasible one. The points aren't evaluated after the run was cancelled
+        * or the budget of the stop condition was used up, so the searches finish without using more evaluations.
+        */
+        auto objective = [this](const vector<double>& x) -> double
+        {
+            if (cancellation_token_.cancelled() || budgetExhausted()) return -numeric_limits<double>::infinity();
+            if (constraintFunction != nullptr && constraintFunction(x) > 0.0) return -numeric_limits<double>::infinity();
+
+            auto eval_start = profiler_.evalStart();
+            double fx;
+            if (batchFitnessFunction != nullptr)
+            {
+                auto fitness_vecs = batchFitnessFunction({ &x });
+                if (fitness_vecs.size() != 1) throw domain_error("The batch fitness function must return a fitness vector for every chromosome.");
+                fx = fitness_vecs[0].at(0);
+            }
+            else
+            {
+                fx = fitnessFunction(x).at(0);
+            }
+            profiler_.addEvaluation(eval_start);
+            num_fitness_evals_++;
+
+            return isfinite(fx) ? fx : -numeric_limits<double>::infinity();
+        };
+
+        vector<detail::LocalSearchResult> results(num_searches);
+        auto search = [&, this](size_t idx)
+        {
+            const Candidate& sol = pop[indices[idx]];
+            switch (local_search_method_)
+            {
+                case LocalSearchMethod::nelder_mead:
+                    results[idx] = detail::nelderMead(objective, sol.chromosome, sol.fitness[0], limits_, max_evals);
+                    break;
+                case LocalSearchMethod::pattern_search:
+                    results[idx] = detail::patternSearch(objective, sol.chromosome, sol.fitness[0], limits_, max_evals);
+                    break;
+                default:
+                    assert(false);    /* Invalid local search method. Shouldn't get here. */
+                    std::abort();
+            }
+        };
+
+        vector<size_t> search_indices(num_searches);
+        iota(search_indices.begin(), search_indices.end(), size_t{ 0 });
+        if (batchFitnessFunction != nullptr)
+        {
+            /* The batch fitness function is only called from the thread running the algorithm, like when evaluating the children. */
+            for_each(search_indices.begin(), search_indices.end(), search);
+        }
+        else
+        {
+            for_each(execution::par_unseq, search_indices.begin(), search_indices.end(), search);
+        }
+
+        /* Lamarckian: replace the candidates with the refined solutions. Baldwinian: only replace their fitness values. */
+        CandidateVec refined_sols;
+        for (size_t i = 0; i < num_searches; i++)
+        {
+            Candidate& sol = pop[indices[i]];
+            if (!(results[i].fx > sol.fitness[0])) continue;
+
+            if (lamarckian_local_search)
+            {
+                sol.chromosome = move(results[i].x);
+                sol.fitness[0] = results[i].fx;
+            }
+            else
+            {
+                Candidate refined(move(results[i].x));
+                refined.fitness.resize(1, results[i].fx);
+                refined.is_evaluated = true;
+                refined_sols.push_back(move(refined));
+
+                sol.fitness[0] = results[i].fx;
+                learned_fitness_[sol.chromosome] = results[i].fx;
+            }
+        }
+        if (!refined_sols.empty()) updateOptimalSolutions(solutions_, refined_sols);
+    }
+
+    inline void RCGA::initAlgorithm()
+    {
+        if (local_search_method_ != LocalSearchMethod::none && mode_ != Mode::single_objective)
+        {
+            throw std::invalid_argument("The local search can only be used in the single-objective mode.");
+        }
+
+        learned_fitness_.clear();
+
+        crossover_quality_.fill(0.0);
+        crossover_probs_.fill(1.0 / NUM_ADAPTIVE_CROSSOVERS);
+        for (auto& attempts : crossover_attempts_) attempts = 0;
+    }
+
+    inline bool RCGA::usesStrategyParams() const noexcept
+    {
+        return (crossover_method_ == CrossoverMethod::adaptive || mutation_method_ == MutationMethod::self_adaptive) && !usesCustomBreeding();
+    }
+
+    inline void RCGA::initStrategyParams(Candidate& sol) const
+    {
+        /* The candidates of the initial population and the children of custom crossovers don't have strategy parameters yet. */
+        const size_t num_params = STRATEGY_STEP_SIZES + ((mutation_method_ == MutationMethod::self_adaptive) ? chrom_len_ : 0);
+        if (sol.strategy_params.size() == num_params) return;
+
+        sol.strategy_params.assign(num_params, 1.0 / gauss_mutation_param_);
+        sol.strategy_params[STRATEGY_CROSSOVER_OP] = 0.0;
+        sol.strategy_params[STRATEGY_PARENT_FITNESS] = 0.0;
+    }
+
+    inline bool RCGA::hasLearnedFitness(const Candidate& sol) const
+    {
+        if (learned_fitness_.empty() || sol.fitness.empty()) return false;
+
+        /* The fitness value is only learned if it wasn't recomputed since, e.g. with a changing fitness function. */
+        auto found = learned_fitness_.find(sol.chromosome);
+        return found != learned_fitness_.end() && found->second == sol.fitness[0];
+    }
+
+    inline size_t RCGA::ChromosomeHasher::operator()(const Chromosome& chrom) const noexcept
+    {
+        size_t seed = chrom.size();
+        for (double gene : chrom)
+        {
+            seed ^= std::hash<double>()(gene) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+
+    inline RCGA::CandidateVec RCGA::customBreed(const Population& pop)
+    {
+        if (de_strategy_ != DeStrategy::none && cma_es_mode_ != CmaEsMode::none)
+        {
+            throw std::invalid_argument("Differential evolution and CMA-ES can't be used at the same time.");
+        }
+
+        return (cma_es_mode_ != CmaEsMode::none) ? cmaEsBreed(pop) : deBreed(pop);
+    }
+
+    inline RCGA::Population RCGA::customUpdatePopulation(Population& old_pop, CandidateVec& children)
+    {
+        return (cma_es_mode_ != CmaEsMode::none) ? cmaEsUpdatePopulation(old_pop, children) : deUpdatePopulation(old_pop, children);
+    }
+
+    inline RCGA::CandidateVec RCGA::deBreed(const Population& pop)
+    {
+        using namespace std;
+        assert(de_strategy_ != DeStrategy::none);
+
+        if (mode_ != Mode::single_objective)
+        {
+            throw invalid_argument("Differential evolution can only be used in the single-objective mode.");
+        }
+        if (pop.size() < 4)
+        {
+            throw invalid_argument("The population size must be at least 4 for differential evolution.");
+        }
+
+        const size_t pop_size = pop.size();
+        const size_t dim = chrom_len_;
+        const bool adaptive = (de_strategy_ == DeStrategy::current_to_pbest);
+
+        /* Reset the adapted parameters and the archive at the start of a run. The memory size is the population size, as in SHADE. */
+        if (generation_cntr_ == 0)
+        {
+            de_memory_F_.assign(pop_size, de_scale_factor_);
+            de_memory_CR_.assign(pop_size, de_crossover_rate_);
+            de_memory_pos_ = 0;
+            de_archive_.clear();
+        }
+
+        /* The population and the trial vectors are stored in contiguous matrices (one row for each candidate). */
+        vector<double> xmat(pop_size * dim);
+        for (size_t i = 0; i < pop_size; i++) copy(pop[i].chromosome.begin(), pop[i].chromosome.end(), xmat.begin() + i * dim);
+        vector<double> tmat(pop_size * dim);
+
+        auto row = [&](size_t idx) -> const double*
+        {
+            /* The rows after the population are the archive (only used by current_to_pbest). */
+            return (idx < pop_size) ? &xmat[idx * dim] : &de_archive_[(idx - pop_size) * dim];
+        };
+
+        vector<size_t> order(pop_size);
+        iota(order.begin(), order.end(), size_t{ 0 });
+        sort(order.begin(), order.end(), [&pop](size_t lidx, size_t ridx) { return pop[lidx].fitness[0] > pop[ridx].fitness[0]; });
+        const size_t best = order[0];
+        const size_t num_pbest = clamp(size_t(round(de_pbest_fraction_ * pop_size)), size_t{ 1 }, pop_size);
+        const size_t archive_size = de_archive_.size() / dim;
+
+        /* Generate the scale factors and crossover rates of the trial vectors (from the success-history memory when adaptive). */
+        de_trial_F_.resize(pop_size);
+        de_trial_CR_.resize(pop_size);
+        for (size_t i = 0; i < pop_size; i++)
+        {
+            if (!adaptive)
+            {
+                de_trial_F_[i] = de_scale_factor_;
+                de_trial_CR_[i] = de_crossover_rate_;
+                continue;
+            }
+            size_t mem_idx = rng::randomIdx(de_memory_F_.size());
+            double F = 0.0;
+            while (F <= 0.0) F = de_memory_F_[mem_idx] + 0.1 * tan(numbers::pi * (rng::randomReal() - 0.5));    /* Cauchy distribution. */
+            de_trial_F_[i] = min(F, 1.0);
+            de_trial_CR_[i] = clamp(rng::randomNormal(de_memory_CR_[mem_idx], 0.1), 0.0, 1.0);
+        }
+
+        vector<size_t> indices(pop_size);
+        iota(indices.begin(), indices.end(), size_t{ 0 });
+        for_each(execution::par_unseq, indices.begin(), indices.end(),
+        [&, this](size_t i)
+        {
+            /* Random index in [0, range) different from the ones in excluded. */
+            auto distinctIdx = [i](size_t range, initializer_list<size_t> excluded)
+            {
+                size_t idx = rng::randomIdx(range);
+                while (idx == i || find(excluded.begin(), excluded.end(), idx) != excluded.end()) idx = rng::randomIdx(range);
+                return idx;
+            };
+
+            const double* target = row(i);
+            double* trial = &tmat[i * dim];
+            switch (de_strategy_)
+            {
+                case DeStrategy::rand_1_bin:
+                {
+                    size_t r1 = distinctIdx(pop_size, {});
+                    size_t r2 = distinctIdx(pop_size, { r1 });
+                    size_t r3 = distinctIdx(pop_size, { r1, r2 });
+                    deTrialVector(trial, target, row(r1), row(r2), row(r3), nullptr, nullptr, de_trial_F_[i], de_trial_CR_[i], limits_);
+                    break;
+                }
+                case DeStrategy::best_1_bin:
+                {
+                    size_t r1 = distinctIdx(pop_size, { best });
+                    size_t r2 = distinctIdx(pop_size, { best, r1 });
+                    deTrialVector(trial, target, row(best), row(r1), row(r2), nullptr, nullptr, de_trial_F_[i], de_trial_CR_[i], limits_);
+                    break;
+                }
+                case DeStrategy::current_to_pbest:
+                {
+                    size_t pbest = order[rng::randomIdx(num_pbest)];
+                    size_t r1 = distinctIdx(pop_size, {});
+                    size_t r2 = distinctIdx(pop_size + archive_size, { r1 });
+                    deTrialVector(trial, target, target, row(pbest), target, row(r1), row(r2), de_trial_F_[i], de_trial_CR_[i], limits_);
+                    break;
+                }
+                default:
+                    assert(false);    /* Invalid DE strategy. Shouldn't get here. */
+                    std::abort();
+            }
+        });
+
+        CandidateVec children(pop_size);
+        for (size_t i = 0; i < pop_size; i++) children[i].chromosome.assign(tmat.begin() + i * dim, tmat.begin() + (i + 1) * dim);
+
+        return children;
+    }
+
+    inline RCGA::Population RCGA::deUpdatePopulation(Population& old_pop, CandidateVec& children)
+    {
+        using namespace std;
+        assert(children.size() == old_pop.size());
+
+        const size_t dim = chrom_len_;
+        const bool adaptive = (de_strategy_ == DeStrategy::current_to_pbest);
+
+        /* The successful scale factors and crossover rates, weighted by the fitness improvements (SHADE). */
+        vector<double> good_F, good_CR, weights;
+
+        /* Each trial vector replaces its target if it isn't worse. */
+        for (size_t i = 0; i < old_pop.size(); i++)
+        {
+            if (!children[i].is_evaluated || children[i].fitness[0] < old_pop[i].fitness[0]) continue;
+
+            if (adaptive && children[i].fitness[0] > old_pop[i].fitness[0])
+            {
+                good_F.push_back(de_trial_F_[i]);
+                good_CR.push_back(de_trial_CR_[i]);
+                weights.push_back(children[i].fitness[0] - old_pop[i].fitness[0]);
+                de_archive_.insert(de_archive_.end(), old_pop[i].chromosome.begin(), old_pop[i].chromosome.end());
+            }
+            old_pop[i] = move(children[i]);
+        }
+        if (!adaptive) return old_pop;
+
+        /* Keep the size of the archive below the population size by removing random chromosomes. */
+        while (de_archive_.size() / dim > old_pop.size())
+        {
+            size_t idx = rng::randomIdx(de_archive_.size() / dim);
+            copy(de_archive_.end() - dim, de_archive_.end(), de_archive_.begin() + idx * dim);
+            de_archive_.resize(de_archive_.size() - dim);
+        }
+
+        /* Update the memory with the weighted (Lehmer) means of the successful parameters. */
+        if (!weights.empty())
+        {
+            double weight_sum = accumulate(weights.begin(), weights.end(), 0.0);
+            double mean_CR = 0.0, sum_F2 = 0.0, sum_F = 0.0;
+            for (size_t i = 0; i < weights.size(); i++)
+            {
+                double w = weights[i] / weight_sum;
+                mean_CR += w * good_CR[i];
+                sum_F2 += w * good_F[i] * good_F[i];
+                sum_F += w * good_F[i];
+            }
+            de_memory_CR_[de_memory_pos_] = mean_CR;
+            de_memory_F_[de_memory_pos_] = sum_F2 / sum_F;
+            de_memory_pos_ = (de_memory_pos_ + 1) % de_memory_F_.size();
+        }
+
+        return old_pop;
+    }
+
+    inline RCGA::CandidateVec RCGA::cmaEsBreed(const Population& pop)
+    {
+        using namespace std;
+        assert(cma_es_mode_ != CmaEsMode::none);
+
+        if (mode_ != Mode::single_objective)
+        {
+            throw invalid_argument("CMA-ES can only be used in the single-objective mode.");
+        }
+
+        if (generation_cntr_ == 0)
+        {
+            if (pop.empty()) throw invalid_argument("The population size must be at least 2 for CMA-ES.");
+
+            /* Start from the best candidate of the initial population. */
+            auto best = max_element(pop.begin(), pop.end(), [](const Candidate& lhs, const Candidate& rhs) { return lhs.fitness[0] < rhs.fitness[0]; });
+            size_t lambda = max(population_size_, size_t{ 2 });
+            cma_es_.emplace(normalizedPoint(best->chromosome), cma_es_sigma_, lambda, cma_es_mode_ == CmaEsMode::separable);
+            cma_es_num_restarts_ = 0;
+            cma_es_large_lambda_ = lambda;
+            cma_es_large_evals_ = 0;
+            cma_es_small_evals_ = 0;
+            cma_es_large_regime_ = true;
+        }
+        else if (cma_es_restarts_ != CmaEsRestart::none && cma_es_->shouldRestart())
+        {
+            cmaEsRestart();
+        }
+
+        vector<double> points;
+        cma_es_->sample(points);
+
+        const size_t dim = chrom_len_;
+        CandidateVec children(cma_es_->lambda());
+        for (size_t k = 0; k < children.size(); k++)
+        {
+            /* Reflect the points outside the bounds back into the normalized search space. */
+            double* y = &points[k * dim];
+            for (size_t i = 0; i < dim; i++)
+            {
+                if (0.0 <= y[i] && y[i] <= 1.0) continue;
+                y[i] = fmod(abs(y[i]), 2.0);
+                if (y[i] > 1.0) y[i] = 2.0 - y[i];
+            }
+            children[k].chromosome = denormalizedPoint(y);
+        }
+
+        return children;
+    }
+
+    inline RCGA::Population RCGA::cmaEsUpdatePopulation(Population& old_pop, CandidateVec& children)
+    {
+        using namespace std;
+
+        /* The distribution can only be updated using a complete generation (the run was cancelled if it isn't). */
+        if (any_of(children.begin(), children.end(), [](const Candidate& sol) { return !sol.is_evaluated; }))
+        {
+            eraseUnevaluated(children);
+            return children.empty() ? old_pop : children;
+        }
+        assert(children.size() == cma_es_->lambda());
+
+        const size_t dim = chrom_len_;
+        vector<double> points(children.size() * dim);
+        vector<double> fvals(children.size());
+        for (size_t k = 0; k < children.size(); k++)
+        {
+            /* The chromosomes may have been changed by a repair function, so the update uses the actual chromosomes. */
+            vector<double> y = normalizedPoint(children[k].chromosome);
+            copy(y.begin(), y.end(), points.begin() + k * dim);
+            fvals[k] = children[k].fitness[0];
+        }
+        cma_es_->update(points, fvals);
+
+        (cma_es_large_regime_ ? cma_es_large_evals_ : cma_es_small_evals_) += children.size();
+
+        /* The best solutions would be lost without archiving them, as the population is replaced by the children. */
+        if (!archive_optimal_solutions) updateOptimalSolutions(solutions_, children);
+
+        return children;
+    }
+
+    inline void RCGA::cmaEsRestart()
+    {
+        using namespace std;
+
+        cma_es_num_restarts_++;
+
+        const size_t base_lambda = max(population_size_, size_t{ 2 });
+        const size_t max_lambda = base_lambda << 9;
+
+        size_t lambda;
+        double sigma = cma_es_sigma_;
+        if (cma_es_restarts_ == CmaEsRestart::ipop || cma_es_large_evals_ <= cma_es_small_evals_)
+        {
+            cma_es_large_lambda_ = min(2 * cma_es_large_lambda_, max_lambda);
+            lambda = cma_es_large_lambda_;
+            cma_es_large_regime_ = true;
+        }
+        else
+        {
+            double u = rng::randomReal();
+            lambda = max(size_t(base_lambda * pow(0.5 * cma_es_large_lambda_ / base_lambda, u * u)), size_t{ 2 });
+            sigma *= pow(10.0, -2.0 * u);
+            cma_es_large_regime_ = false;
+        }
+
+        vector<double> mean(chrom_len_);
+        for (auto& m : mean) m = rng::randomReal();
+
+        cma_es_.emplace(move(mean), sigma, lambda, cma_es_mode_ == CmaEsMode::separable);
+    }
+
+    inline std::vector<double> RCGA::normalizedPoint(const Chromosome& chrom) const
+    {
+        std::vector<double> y(chrom.size());
+        for (size_t i = 0; i < chrom.size(); i++)
+        {
+            double range = limits_[i].second - limits_[i].first;
+            y[i] = (range > 0.0) ? (chrom[i] - limits_[i].first) / range : 0.0;
+        }
+
+        return y;
+    }
+
+    inline RCGA::Chromosome RCGA::denormalizedPoint(const double* y) const
+    {
+        Chromosome chrom(chrom_len_);
+        for (size_t i = 0; i < chrom_len_; i++)
+        {
+            chrom[i] = std::clamp(limits_[i].first + y[i] * (limits_[i].second - limits_[i].first), limits_[i].first, limits_[i].second);
+        }
+
+        return chrom;
+    }
+
+    inline void RCGA::deTrialVector(double* trial, const double* target, const double* base, const double* x1, const double* x2,
+                                    const double* x3, const double* x4, double F, double CR, const limits_t& bounds)
+    {
+        const size_t dim = bounds.size();
+
+        /* Mutant vector. These loops don't depend on each other's iterations, so they can be vectorized. */
+        for (size_t j = 0; j < dim; j++) trial[j] = base[j] + F * (x1[j] - x2[j]);
+        if (x3 != nullptr)
+        {
+            for (size_t j = 0; j < dim; j++) trial[j] += F * (x3[j] - x4[j]);
+        }
+
+        /* Binomial crossover, at least one gene is always taken from the mutant. */
+        size_t jrand = rng::randomIdx(dim);
+        for (size_t j = 0; j < dim; j++)
+        {
+            if (j != jrand && rng::randomReal() >= CR) trial[j] = target[j];
+        }
+
+        /* Bound constraint handling. */
+        for (size_t j = 0; j < dim; j++)
+        {
+            if (trial[j] < bounds[j].first) trial[j] = (target[j] + bounds[j].first) / 2.0;
+            else if (trial[j] > bounds[j].second) trial[j] = (target[j] + bounds[j].second) / 2.0;
+        }
+    }
+
     inline RCGA::CandidatePair RCGA::arithmeticCrossover(const Candidate& parent1, const Candidate& parent2, double pc)
     {
         assert(parent1.chromosome.size() == parent2.chromosome.size());
@@ -573,8 +1673,9 @@ namespace genetic_algorithm
         if (rng::randomReal() <= pc)
         {
             /* p1 is always the better parent. */
-            const Candidate* p1 = detail::paretoCompare(parent1.fitness, parent2.fitness) ? &parent2 : &parent1;
-            const Candidate* p2 = detail::paretoCompare(parent1.fitness, parent2.fitness) ? &parent1 : &parent2;
+            bool p2_is_better = detail::paretoCompare(parent1.fitness.data(), parent2.fitness.data(), parent1.fitness.size());
+            const Candidate* p1 = p2_is_better ? &parent2 : &parent1;
+            const Candidate* p2 = p2_is_better ? &parent1 : &parent2;
             /* Get random weights. */
             double w1 = rng::randomReal();
             double w2 = rng::randomReal();
@@ -698,6 +1799,30 @@ namespace genetic_algorithm
         }
     }
 
+    inline void RCGA::selfAdaptiveMutate(Candidate& child, std::span<double> step_sizes, const limits_t& bounds)
+    {
+        assert(child.chromosome.size() == bounds.size());
+        assert(step_sizes.size() == child.chromosome.size());
+
+        const size_t chrom_len = child.chromosome.size();
+
+        /* Log-normal self-adaptation, with a component common to every gene, and one for each gene. */
+        const double tau_common = 1.0 / std::sqrt(2.0 * chrom_len);
+        const double tau_gene = 1.0 / std::sqrt(2.0 * std::sqrt(double(chrom_len)));
+        const double common = tau_common * rng::randomNormal();
+
+        for (size_t i = 0; i < chrom_len; i++)
+        {
+            step_sizes[i] = std::clamp(step_sizes[i] * std::exp(common + tau_gene * rng::randomNormal()), 1e-12, 1.0);
+
+            double SD = step_sizes[i] * (bounds[i].second - bounds[i].first);
+            child.chromosome[i] += rng::randomNormal(0.0, SD);
+            /* The mutated gene might be outside the allowed range. */
+            child.chromosome[i] = std::clamp(child.chromosome[i], bounds[i].first, bounds[i].second);
+        }
+        child.is_evaluated = false;
+    }
+
 } // namespace genetic_algorithm
 
 #endif // !GA_RCGA_H
\ No newline at end of file
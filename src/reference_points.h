@@ -31,15 +31,45 @@
 #define GA_REFERENCE_POINTS_H
 
 #include <vector>
+#include <string>
 #include <cstddef>
 
 namespace genetic_algorithm::detail
 {
+    /** The possible methods used for generating the reference points of the NSGA-III algorithm. */
+    enum class RefPointMethod
+    {
+        das_dennis,    /**< Structured points on the unit simplex (Das-Dennis), using 2 layers of points for many objectives. Deterministic. */
+        random         /**< Points picked from a set of random points on the unit simplex with greedy max-min selection. Slow for many objectives. */
+    };
+
     /* Sample a point from a uniform distribution on a unit simplex in dim dimensions. */
     inline std::vector<double> randomSimplexPoint(size_t dim);
 
-    /* Generate n reference points on the unit simplex in dim dimensions (for the NSGA-III algorithm). */
-    inline std::vector<std::vector<double>> generateRefPoints(size_t n, size_t dim);
+    /* Generate n reference points on the unit simplex in dim dimensions by picking them from a larger set of random points. */
+    inline std::vector<std::vector<double>> generateRandomRefPoints(size_t n, size_t dim);
+
+    /* Generate all of the points on the unit simplex in dim dimensions with the given number of divisions along each objective (Das-Dennis). */
+    inline std::vector<std::vector<double>> generateDasDennisRefPoints(size_t divisions, size_t dim);
+
+    /*
+    * Generate at most n (but at least dim) structured reference points on the unit simplex in dim dimensions. \n
+    * A single layer of Das-Dennis points is used if it has points inside the simplex, otherwise two layers are used:
+    * a boundary layer, and an inner layer which is shrunk towards the center of the simplex.
+    */
+    inline std::vector<std::vector<double>> generateStructuredRefPoints(size_t n, size_t dim);
+
+    /*
+    * Generate the reference points for the NSGA-III algorithm using the given method. \n
+    * The generated reference points are cached, so they are only generated once for each (n, dim, method).
+    */
+    inline std::vector<std::vector<double>> generateRefPoints(size_t n, size_t dim, RefPointMethod method);
+
+    /* Write the reference points to a binary file. Throws std::runtime_error if the file couldn't be written. */
+    inline void writeRefPoints(const std::string& fname, const std::vector<std::vector<double>>& refs);
+
+    /* Read the reference points from a binary file written by writeRefPoints. Throws std::runtime_error if the file couldn't be read. */
+    inline std::vector<std::vector<double>> readRefPoints(const std::string& fname);
 
 } // namespace genetic_algorithm::detail
 
@@ -49,7 +79,14 @@ namespace genetic_algorithm::detail
 #include <algorithm>
 #include <execution>
 #include <random>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <fstream>
+#include <stdexcept>
 #include <limits>
+#include <cstdint>
+#include <cstdlib>
 #include <cmath>
 #include <cassert>
 
@@ -81,7 +118,7 @@ namespace genetic_algorithm::detail
         return point;
     }
 
-    std::vector<std::vector<double>> generateRefPoints(size_t n, size_t dim)
+    std::vector<std::vector<double>> generateRandomRefPoints(size_t n, size_t dim)
     {
         using namespace std;
         assert(n > 0);
@@ -123,6 +160,226 @@ namespace genetic_algorithm::detail
         return refs;
     }
 
+    /* The number of Das-Dennis points with the given number of divisions in dim dimensions, saturated at SIZE_MAX. */
+    inline size_t numDasDennisPoints(size_t divisions, size_t dim)
+    {
+        assert(dim > 0);
+
+        /* binom(divisions + dim - 1, dim - 1) */
+        size_t k = std::min(divisions, dim - 1);
+        size_t count = 1;
+        for (size_t i = 1; i <= k; i++)
+        {
+            size_t num = divisions + dim - 1 - k + i;
+            if (count > std::numeric_limits<size_t>::max() / num) return std::numeric_limits<size_t>::max();
+            count = count * num / i;
+        }
+
+        return count;
+    }
+
+    std::vector<std::vector<double>> generateDasDennisRefPoints(size_t divisions, size_t dim)
+    {
+        using namespace std;
+        assert(divisions > 0);
+        assert(dim > 1);
+
+        vector<vector<double>> refs;
+        refs.reserve(numDasDennisPoints(divisions, dim));
+
+        /* Enumerate the compositions of divisions into dim parts, the last part is always the remainder. */
+        vector<size_t> parts(dim - 1, 0);
+        size_t sum = 0;
+        while (true)
+        {
+            vector<double> point(dim);
+            for (size_t i = 0; i < parts.size(); i++)
+            {
+                point[i] = double(parts[i]) / divisions;
+            }
+            point.back() = double(divisions - sum) / divisions;
+            refs.push_back(move(point));
+
+            /* Increment the parts like an odometer, with the constraint that their sum can't exceed divisions. */
+            bool done = true;
+            for (size_t i = parts.size(); i-- > 0; )
+            {
+                if (sum < divisions)
+                {
+                    parts[i]++;
+                    sum++;
+                    done = false;
+                    break;
+                }
+                sum -= parts[i];
+                parts[i] = 0;
+            }
+            if (done) break;
+        }
+
+        assert(refs.size() == numDasDennisPoints(divisions, dim));
+
+        return refs;
+    }
+
+    std::vector<std::vector<double>> generateStructuredRefPoints(size_t n, size_t dim)
+    {
+        using namespace std;
+        assert(n > 0);
+        assert(dim > 1);
+
+        /* The simplex vertices are always used, even if n < dim. */
+        if (n <= dim) return generateDasDennisRefPoints(1, dim);
+
+        /* Find the highest number of divisions for a single layer with at most n points. */
+        size_t divisions = 1;
+        while (numDasDennisPoints(divisions + 1, dim) <= n) divisions++;
+
+        /* A single layer has points inside the simplex if divisions >= dim, in which case it is enough. */
+        if (divisions >= dim) return generateDasDennisRefPoints(divisions, dim);
+
+        /* Otherwise use two layers, picking the divisions which give the most points in total. */
+        size_t outer_div = divisions, inner_div = 0, best_count = numDasDennisPoints(divisions, dim);
+        for (size_t outer = 1; outer <= divisions; outer++)
+        {
+            size_t outer_count = numDasDennisPoints(outer, dim);
+            for (size_t inner = 1; inner <= outer && outer_count + numDasDennisPoints(inner, dim) <= n; inner++)
+            {
+                size_t count = outer_count + numDasDennisPoints(inner, dim);
+                if (count > best_count)
+                {
+                    best_count = count;
+                    outer_div = outer;
+                    inner_div = inner;
+                }
+            }
+        }
+
+        vector<vector<double>> refs = generateDasDennisRefPoints(outer_div, dim);
+        if (inner_div == 0) return refs;
+
+        /* The points of the inner layer are shrunk halfway towards the center of the simplex. */
+        vector<vector<double>> inner_refs = generateDasDennisRefPoints(inner_div, dim);
+        for (auto& ref : inner_refs)
+        {
+            for (auto& r : ref)
+            {
+                r = 0.5 * r + 0.5 / dim;
+            }
+        }
+        refs.insert(refs.end(), make_move_iterator(inner_refs.begin()), make_move_iterator(inner_refs.end()));
+
+        return refs;
+    }
+
+    std::vector<std::vector<double>> generateRefPoints(size_t n, size_t dim, RefPointMethod method)
+    {
+        using namespace std;
+        assert(n > 0);
+        assert(dim > 1);
+
+        using Key = tuple<size_t, size_t, RefPointMethod>;
+
+        static mutex cache_mutex;
+        static map<Key, vector<vector<double>>> cache;
+
+        Key key = { n, dim, method };
+        {
+            lock_guard<mutex> lock(cache_mutex);
+            if (auto it = cache.find(key); it != cache.end()) return it->second;
+        }
+
+        vector<vector<double>> refs;
+        switch (method)
+        {
+            case RefPointMethod::das_dennis:
+                refs = generateStructuredRefPoints(n, dim);
+                break;
+            case RefPointMethod::random:
+                refs = generateRandomRefPoints(n, dim);
+                break;
+            default:
+                assert(false);    /* Invalid method. Shouldn't get here. */
+                std::abort();
+        }
+
+        lock_guard<mutex> lock(cache_mutex);
+        cache.emplace(key, refs);
+
+        return refs;
+    }
+
+    /* Identifies the binary reference point files. */
+    inline constexpr char REF_POINTS_FILE_MAGIC[8] = { 'G', 'A', 'R', 'E', 'F', 'P', 'T', '1' };
+
+    void writeRefPoints(const std::string& fname, const std::vector<std::vector<double>>& refs)
+    {
+        using namespace std;
+        assert(!refs.empty());
+        assert(all_of(refs.begin(), refs.end(), [&refs](const vector<double>& ref) { return ref.size() == refs[0].size(); }));
+
+        ofstream file(fname, ios::binary | ios::trunc);
+        if (!file) throw runtime_error("Couldn't open the reference point file for writing: " + fname);
+
+        uint64_t count = refs.size();
+        uint64_t dim = refs[0].size();
+
+        file.write(REF_POINTS_FILE_MAGIC, sizeof(REF_POINTS_FILE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+        for (const auto& ref : refs)
+        {
+            file.write(reinterpret_cast<const char*>(ref.data()), streamsize(dim * sizeof(double)));
+        }
+
+        if (!file) throw runtime_error("Couldn't write the reference point file: " + fname);
+    }
+
+    std::vector<std::vector<double>> readRefPoints(const std::string& fname)
+    {
+        using namespace std;
+
+        ifstream file(fname, ios::binary);
+        if (!file) throw runtime_error("Couldn't open the reference point file for reading: " + fname);
+
+        char magic[sizeof(REF_POINTS_FILE_MAGIC)];
+        uint64_t count = 0, dim = 0;
+
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+        file.read(reinterpret_cast<char*>(&dim), sizeof(dim));
+
+        if (!file || !equal(begin(magic), end(magic), begin(REF_POINTS_FILE_MAGIC)))
+        {
+            throw runtime_error("Invalid reference point file: " + fname);
+        }
+        if (count == 0 || dim < 2)
+        {
+            throw runtime_error("The reference point file contains no valid reference points: " + fname);
+        }
+
+        /* Don't trust the header with the allocation, the points must fit in the rest of the file. */
+        const auto data_start = file.tellg();
+        file.seekg(0, ios::end);
+        const uint64_t remaining = uint64_t(file.tellg() - data_start);
+        file.seekg(data_start);
+
+        if (!file || dim > remaining / sizeof(double) || count > remaining / (dim * sizeof(double)))
+        {
+            throw runtime_error("The reference point file is truncated: " + fname);
+        }
+
+        vector<vector<double>> refs(count, vector<double>(dim));
+        for (auto& ref : refs)
+        {
+            file.read(reinterpret_cast<char*>(ref.data()), streamsize(dim * sizeof(double)));
+        }
+
+        if (!file) throw runtime_error("The reference point file is truncated: " + fname);
+
+        return refs;
+    }
+
 } // namespace genetic_algorithm::detail
 
 #endif // !GA_REFERENCE_POINTS_H
\ No newline at end of file
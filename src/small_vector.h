@@ -0,0 +1,273 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/**
+* This file contains a vector class with a small inline buffer, used to store the fitness vectors of the candidates
+* without a heap allocation for the typical number of objectives.
+*
+* @file small_vector.h
+*/
+
+#ifndef GA_SMALL_VECTOR_H
+#define GA_SMALL_VECTOR_H
+
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <compare>
+#include <type_traits>
+#include <cstddef>
+
+namespace genetic_algorithm::detail
+{
+    /**
+    * Contiguous container with a similar interface to std::vector, which stores up to N elements
+    * inline, and only allocates memory on the heap if it has to store more elements. \n
+    * Only supports trivially copyable types. Implicitly convertible from/to std::vector<T>.
+    */
+    template<typename T, size_t N>
+    class SmallVector
+    {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "The elements of a SmallVector must be trivially copyable.");
+        static_assert(N > 0, "The inline capacity of a SmallVector must be at least 1.");
+
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        SmallVector() noexcept = default;
+        explicit SmallVector(size_t count, const T& value = T());
+        SmallVector(std::initializer_list<T> init);
+        SmallVector(const std::vector<T>& vec);
+
+        template<std::input_iterator InputIt>
+        SmallVector(InputIt first, InputIt last);
+
+        SmallVector(const SmallVector& other);
+        SmallVector(SmallVector&& other) noexcept;
+        SmallVector& operator=(const SmallVector& other);
+        SmallVector& operator=(SmallVector&& other) noexcept;
+
+        ~SmallVector();
+
+        operator std::vector<T>() const { return std::vector<T>(begin(), end()); }
+
+        [[nodiscard]] T& operator[](size_t idx) noexcept { return data_[idx]; }
+        [[nodiscard]] const T& operator[](size_t idx) const noexcept { return data_[idx]; }
+
+        [[nodiscard]] T& front() noexcept { return data_[0]; }
+        [[nodiscard]] const T& front() const noexcept { return data_[0]; }
+        [[nodiscard]] T& back() noexcept { return data_[size_ - 1]; }
+        [[nodiscard]] const T& back() const noexcept { return data_[size_ - 1]; }
+
+        [[nodiscard]] T* data() noexcept { return data_; }
+        [[nodiscard]] const T* data() const noexcept { return data_; }
+
+        [[nodiscard]] iterator begin() noexcept { return data_; }
+        [[nodiscard]] const_iterator begin() const noexcept { return data_; }
+        [[nodiscard]] const_iterator cbegin() const noexcept { return data_; }
+        [[nodiscard]] iterator end() noexcept { return data_ + size_; }
+        [[nodiscard]] const_iterator end() const noexcept { return data_ + size_; }
+        [[nodiscard]] const_iterator cend() const noexcept { return data_ + size_; }
+
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+        [[nodiscard]] bool is_inline() const noexcept { return data_ == buffer_; }
+
+        void reserve(size_t new_capacity);
+        void resize(size_t new_size, const T& value = T());
+        void clear() noexcept { size_ = 0; }
+        void push_back(const T& value);
+
+        template<std::input_iterator InputIt>
+        void assign(InputIt first, InputIt last);
+
+        friend bool operator==(const SmallVector& lhs, const SmallVector& rhs)
+        {
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend auto operator<=>(const SmallVector& lhs, const SmallVector& rhs)
+        {
+            return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+    private:
+        T* data_ = buffer_;
+        size_t size_ = 0;
+        size_t capacity_ = N;
+        T buffer_[N];
+    };
+
+} // namespace genetic_algorithm::detail
+
+
+/* IMPLEMENTATION */
+
+#include <utility>
+#include <cassert>
+
+namespace genetic_algorithm::detail
+{
+    template<typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(size_t count, const T& value)
+    {
+        resize(count, value);
+    }
+
+    template<typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+    }
+
+    template<typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(const std::vector<T>& vec)
+    {
+        assign(vec.begin(), vec.end());
+    }
+
+    template<typename T, size_t N>
+    template<std::input_iterator InputIt>
+    inline SmallVector<T, N>::SmallVector(InputIt first, InputIt last)
+    {
+        assign(first, last);
+    }
+
+    template<typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(const SmallVector& other)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    template<typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(SmallVector&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    template<typename T, size_t N>
+    inline SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+
+        return *this;
+    }
+
+    template<typename T, size_t N>
+    inline SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& other) noexcept
+    {
+        if (this == &other) return *this;
+
+        if (other.is_inline())
+        {
+            /* The inline elements have to be copied, and any heap storage of this can be reused. */
+            std::copy(other.begin(), other.end(), data_);
+            size_ = other.size_;
+        }
+        else
+        {
+            /* Steal the heap storage of other. */
+            if (!is_inline()) delete[] data_;
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+
+            other.data_ = other.buffer_;
+            other.capacity_ = N;
+        }
+        other.size_ = 0;
+
+        return *this;
+    }
+
+    template<typename T, size_t N>
+    inline SmallVector<T, N>::~SmallVector()
+    {
+        if (!is_inline()) delete[] data_;
+    }
+
+    template<typename T, size_t N>
+    inline void SmallVector<T, N>::reserve(size_t new_capacity)
+    {
+        if (new_capacity <= capacity_) return;
+
+        T* new_data = new T[new_capacity];
+        std::copy(begin(), end(), new_data);
+        if (!is_inline()) delete[] data_;
+
+        data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    template<typename T, size_t N>
+    inline void SmallVector<T, N>::resize(size_t new_size, const T& value)
+    {
+        reserve(new_size);
+        if (new_size > size_) std::fill(data_ + size_, data_ + new_size, value);
+        size_ = new_size;
+    }
+
+    template<typename T, size_t N>
+    inline void SmallVector<T, N>::push_back(const T& value)
+    {
+        if (size_ == capacity_)
+        {
+            T temp = value;    /* value might refer to an element of this. */
+            reserve(2 * capacity_);
+            data_[size_++] = temp;
+        }
+        else data_[size_++] = value;
+    }
+
+    template<typename T, size_t N>
+    template<std::input_iterator InputIt>
+    inline void SmallVector<T, N>::assign(InputIt first, InputIt last)
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+        {
+            size_t count = size_t(std::distance(first, last));
+            reserve(count);
+            std::copy(first, last, data_);
+            size_ = count;
+        }
+        else
+        {
+            clear();
+            for (; first != last; ++first) push_back(*first);
+        }
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // !GA_SMALL_VECTOR_H
\ No newline at end of file
@@ -0,0 +1,694 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/**
+* This file contains the socket evaluator, an evaluation backend which sends the fitness evaluations
+* to worker processes connected over TCP or Unix domain sockets, which can run on other machines.
+* Only available on POSIX systems.
+*
+* @file socket_evaluator.h
+*/
+
+#ifndef GA_SOCKET_EVALUATOR_H
+#define GA_SOCKET_EVALUATOR_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <type_traits>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace genetic_algorithm
+{
+    /**
+    * Evaluation backend that sends the chromosomes to worker processes connected over sockets,
+    * and receives the fitness vectors from them (master-worker model). \n
+    * The chromosomes are sent in batches, with multiple batches in flight for each worker, so the workers
+    * don't have to wait for the next batch. The batches of a worker that disconnects, or that exceeds the batch timeout,
+    * are redistributed to the other workers. Workers can connect at any time. \n
+    * The workers are started separately, by calling runSocketWorker in each of them with the same address. \n
+    * The address is either "unix:<path>" for a Unix domain socket, or "<host>:<port>" for TCP
+    * (the host can be "*" for listening on every interface). \n
+    * The genes and fitness values are sent in the byte order of the machines, so the master and
+    * the workers must have the same architecture. Use it as the batch fitness function of a GA:
+    * @code
+    * SocketEvaluator<double> master("*:5555");
+    * GA.batchFitnessFunction = std::ref(master);
+    * @endcode
+    */
+    template<typename geneType>
+    class SocketEvaluator
+    {
+    public:
+
+        using Chromosome = std::vector<geneType>;
+
+        /**
+        * Creates the evaluator and starts listening for the workers on @p address.
+        *
+        * @param address The address to listen on.
+        * @param batch_size The maximum number of chromosomes sent to a worker in a single message.
+        * @param batches_per_worker The maximum number of batches sent to a worker before receiving the results of the first one.
+        */
+        explicit SocketEvaluator(const std::string& address, size_t batch_size = 8, size_t batches_per_worker = 2);
+
+        SocketEvaluator(const SocketEvaluator&) = delete;
+        SocketEvaluator& operator=(const SocketEvaluator&) = delete;
+
+        /** Disconnects the workers and stops listening. */
+        ~SocketEvaluator();
+
+        /**
+        * Evaluates the chromosomes on the connected workers.
+        *
+        * @param chroms The chromosomes to evaluate, all of them must have the same length.
+        * @returns The fitness vectors of the chromosomes.
+        * @throws std::runtime_error If a worker reported an error, or there were no workers for longer than the worker timeout.
+        */
+        std::vector<std::vector<double>> operator()(const std::vector<const Chromosome*>& chroms);
+
+        /**
+        * Waits until at least @p count workers are connected, or @p timeout seconds have passed.
+        * @returns The number of connected workers.
+        */
+        size_t wait_for_workers(size_t count, double timeout);
+
+        /**
+        * Sets the maximum time to wait for a worker to connect during an evaluation if there are no workers to @p seconds. \n
+        * An exception is thrown if no worker connects in this time.
+        */
+        void worker_timeout(double seconds);
+        [[nodiscard]] double worker_timeout() const noexcept { return worker_timeout_; }
+
+        /**
+        * Sets the maximum time a worker can take to return the results of a batch to @p seconds. \n
+        * Workers exceeding it are disconnected, and their batches are redistributed to the other workers. 0 means no timeout.
+        */
+        void batch_timeout(double seconds);
+        [[nodiscard]] double batch_timeout() const noexcept { return batch_timeout_; }
+
+        /** @returns The number of connected workers. */
+        [[nodiscard]] size_t num_workers() const noexcept { return workers_.size(); }
+
+        /** @returns The number of workers that disconnected or timed out during an evaluation. */
+        [[nodiscard]] size_t num_disconnects() const noexcept { return num_disconnects_; }
+
+        /** @returns The port the evaluator listens on if it uses TCP, 0 otherwise. Useful if it was created with port 0. */
+        [[nodiscard]] uint16_t port() const noexcept { return port_; }
+
+    private:
+
+        using Clock = std::chrono::steady_clock;
+
+        struct Worker
+        {
+            int fd = -1;
+            std::deque<size_t> batches;     /* The batches sent to the worker, in order. */
+            size_t num_stale = 0;           /* The number of results of earlier evaluations the worker will send before the batches. */
+            std::vector<char> outbuf;       /* The messages not sent to the worker yet, starting at out_pos. */
+            size_t out_pos = 0;
+            std::vector<char> inbuf;        /* The data received from the worker, not processed yet. */
+            Clock::time_point batch_start;  /* The time the worker started working on its oldest batch. */
+        };
+
+        size_t batch_size_;
+        size_t batches_per_worker_;
+        double worker_timeout_ = 60.0;
+        double batch_timeout_ = 0.0;
+
+        int listen_fd_ = -1;
+        std::string unix_path_;
+        uint16_t port_ = 0;
+
+        std::vector<Worker> workers_;
+        size_t num_disconnects_ = 0;
+
+        void acceptWorker();
+        void disconnectWorker(size_t idx, std::deque<size_t>& pending);
+        void discardResults();
+
+        static bool sendPending(Worker& worker);
+        static bool receiveInput(Worker& worker);
+    };
+
+    /**
+    * Runs a worker process of a SocketEvaluator. Connects to the master at @p address, evaluates the chromosomes
+    * received from it using @p fitness_function, and returns when the master closes the connection.
+    *
+    * @param address The address of the master, in the same format as for the SocketEvaluator.
+    * @param fitness_function The fitness function used to evaluate the chromosomes.
+    * @param connect_timeout The maximum time in seconds to keep trying to connect to the master if it isn't available yet.
+    * @throws std::runtime_error If the worker couldn't connect to the master.
+    */
+    template<typename geneType>
+    void runSocketWorker(const std::string& address, const std::function<std::vector<double>(const std::vector<geneType>&)>& fitness_function,
+                         double connect_timeout = 10.0);
+
+} // namespace genetic_algorithm
+
+
+/* IMPLEMENTATION */
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "ipc_detail.h"
+
+namespace genetic_algorithm::detail
+{
+    /* The header of the messages between the master and the workers, followed by the payload. */
+    struct MessageHeader
+    {
+        uint32_t magic;
+        uint32_t type;
+        uint32_t id;        /* The id of the batch. */
+        uint32_t count;     /* The number of chromosomes / fitness vectors in the payload. */
+        uint32_t width;     /* The length of the chromosomes / fitness vectors, or the size of a gene for the hello message. */
+    };
+
+    inline constexpr uint32_t MESSAGE_MAGIC = 0x47414D57;  /* "GAMW" */
+
+    enum class MessageType : uint32_t
+    {
+        hello,      /* Worker -> master after connecting. */
+        batch,      /* Master -> worker, payload: count * width genes. */
+        result,     /* Worker -> master, payload: count * width doubles. */
+        error       /* Worker -> master, the fitness function threw an exception. */
+    };
+
+    struct SocketAddress
+    {
+        int family;
+        std::string path;   /* For Unix domain sockets. */
+        std::string host;   /* For TCP. */
+        std::string port;
+    };
+
+    inline SocketAddress parseSocketAddress(const std::string& address)
+    {
+        if (address.rfind("unix:", 0) == 0)
+        {
+            std::string path = address.substr(5);
+            if (path.empty() || path.size() >= sizeof(sockaddr_un::sun_path)) throw std::invalid_argument("Invalid Unix domain socket path: " + address);
+
+            return { AF_UNIX, path, {}, {} };
+        }
+
+        size_t sep = address.rfind(':');
+        if (sep == std::string::npos || sep + 1 == address.size()) throw std::invalid_argument("Invalid socket address: " + address);
+
+        return { AF_INET, {}, address.substr(0, sep), address.substr(sep + 1) };
+    }
+
+    /* Creates a socket bound to the address (if listen is true) or connected to it. Returns -1 on error. */
+    inline int openSocket(const SocketAddress& address, bool listen)
+    {
+        if (address.family == AF_UNIX)
+        {
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0) return -1;
+
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, address.path.c_str(), sizeof(addr.sun_path) - 1);
+
+            if (listen) ::unlink(address.path.c_str());
+            int ret = listen ? ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))
+                             : ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            if (ret != 0 || (listen && ::listen(fd, SOMAXCONN) != 0))
+            {
+                ::close(fd);
+                return -1;
+            }
+            disableSigPipe(fd);
+            return fd;
+        }
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (listen) hints.ai_flags = AI_PASSIVE;
+
+        const char* host = (address.host.empty() || address.host == "*") ? nullptr : address.host.c_str();
+        addrinfo* results = nullptr;
+        if (::getaddrinfo(host, address.port.c_str(), &hints, &results) != 0) return -1;
+
+        int fd = -1;
+        for (addrinfo* ai = results; ai != nullptr; ai = ai->ai_next)
+        {
+            fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+
+            int on = 1;
+            if (listen) ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+            int ret = listen ? ::bind(fd, ai->ai_addr, ai->ai_addrlen) : ::connect(fd, ai->ai_addr, ai->ai_addrlen);
+            if (ret == 0 && (!listen || ::listen(fd, SOMAXCONN) == 0))
+            {
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                disableSigPipe(fd);
+                break;
+            }
+            ::close(fd);
+            fd = -1;
+        }
+        ::freeaddrinfo(results);
+
+        return fd;
+    }
+
+} // namespace genetic_algorithm::detail
+
+namespace genetic_algorithm
+{
+    template<typename geneType>
+    SocketEvaluator<geneType>::SocketEvaluator(const std::string& address, size_t batch_size, size_t batches_per_worker)
+        : batch_size_(batch_size), batches_per_worker_(batches_per_worker)
+    {
+        static_assert(std::is_trivially_copyable_v<geneType>, "The genes must be trivially copyable to be sent over the sockets.");
+
+        if (batch_size == 0) throw std::invalid_argument("The batch size must be at least 1.");
+        if (batches_per_worker == 0) throw std::invalid_argument("The number of batches per worker must be at least 1.");
+
+        detail::SocketAddress addr = detail::parseSocketAddress(address);
+
+        listen_fd_ = detail::openSocket(addr, true);
+        if (listen_fd_ < 0) throw std::runtime_error("Couldn't listen on " + address + ".");
+
+        if (addr.family == AF_UNIX)
+        {
+            unix_path_ = addr.path;
+        }
+        else
+        {
+            sockaddr_storage bound{};
+            socklen_t len = sizeof(bound);
+            ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&bound), &len);
+            if (bound.ss_family == AF_INET) port_ = ntohs(reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+            if (bound.ss_family == AF_INET6) port_ = ntohs(reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port);
+        }
+    }
+
+    template<typename geneType>
+    SocketEvaluator<geneType>::~SocketEvaluator()
+    {
+        for (auto& worker : workers_) ::close(worker.fd);
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+        if (!unix_path_.empty()) ::unlink(unix_path_.c_str());
+    }
+
+    template<typename geneType>
+    void SocketEvaluator<geneType>::worker_timeout(double seconds)
+    {
+        if (!(seconds >= 0.0)) throw std::invalid_argument("The worker timeout can't be negative.");
+
+        worker_timeout_ = seconds;
+    }
+
+    template<typename geneType>
+    void SocketEvaluator<geneType>::batch_timeout(double seconds)
+    {
+        if (!(seconds >= 0.0)) throw std::invalid_argument("The batch timeout can't be negative.");
+
+        batch_timeout_ = seconds;
+    }
+
+    template<typename geneType>
+    void SocketEvaluator<geneType>::acceptWorker()
+    {
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) return;
+
+        int on = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));   /* Fails harmlessly for Unix domain sockets. */
+        detail::disableSigPipe(fd);
+
+        /* The worker must use the same gene type. */
+        detail::MessageHeader hello;
+        pollfd pfd = { fd, POLLIN, 0 };
+        if (::poll(&pfd, 1, 5000) != 1 || !detail::readAll(fd, &hello, sizeof(hello)) || hello.magic != detail::MESSAGE_MAGIC ||
+            hello.type != uint32_t(detail::MessageType::hello) || hello.width != sizeof(geneType))
+        {
+            ::close(fd);
+            return;
+        }
+
+        Worker worker;
+        worker.fd = fd;
+        workers_.push_back(std::move(worker));
+    }
+
+    template<typename geneType>
+    void SocketEvaluator<geneType>::disconnectWorker(size_t idx, std::deque<size_t>& pending)
+    {
+        ::close(workers_[idx].fd);
+        pending.insert(pending.begin(), workers_[idx].batches.begin(), workers_[idx].batches.end());
+
+        workers_.erase(workers_.begin() + idx);
+        num_disconnects_++;
+    }
+
+    template<typename geneType>
+    void SocketEvaluator<geneType>::discardResults()
+    {
+        /* The results of the batches still in flight are discarded when they are received, so they aren't mistaken for the results of the next evaluation. */
+        for (auto& worker : workers_)
+        {
+            worker.num_stale += worker.batches.size();
+            worker.batches.clear();
+        }
+    }
+
+    template<typename geneType>
+    bool SocketEvaluator<geneType>::sendPending(Worker& worker)
+    {
+        /* Only write as much as the socket accepts, so the master never blocks while the worker is blocked sending its results. */
+        while (worker.out_pos != worker.outbuf.size())
+        {
+            ssize_t n = detail::sendSome(worker.fd, worker.outbuf.data() + worker.out_pos, worker.outbuf.size() - worker.out_pos);
+            if (n < 0) return false;
+            if (n == 0) return true;
+            worker.out_pos += size_t(n);
+        }
+        worker.outbuf.clear();
+        worker.out_pos = 0;
+
+        return true;
+    }
+
+    template<typename geneType>
+    bool SocketEvaluator<geneType>::receiveInput(Worker& worker)
+    {
+        constexpr size_t chunk_size = 65536;
+        while (true)
+        {
+            size_t old_size = worker.inbuf.size();
+            worker.inbuf.resize(old_size + chunk_size);
+            ssize_t n = detail::readSome(worker.fd, worker.inbuf.data() + old_size, chunk_size);
+            worker.inbuf.resize(old_size + size_t(std::max(n, ssize_t(0))));
+
+            if (n < 0) return false;
+            if (size_t(n) < chunk_size) return true;
+        }
+    }
+
+    template<typename geneType>
+    size_t SocketEvaluator<geneType>::wait_for_workers(size_t count, double timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+        while (workers_.size() < count)
+        {
+            double remaining = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0.0) break;
+
+            pollfd pfd = { listen_fd_, POLLIN, 0 };
+            if (::poll(&pfd, 1, int(std::ceil(remaining * 1000.0))) > 0) acceptWorker();
+        }
+
+        return workers_.size();
+    }
+
+    template<typename geneType>
+    std::vector<std::vector<double>> SocketEvaluator<geneType>::operator()(const std::vector<const Chromosome*>& chroms)
+    {
+        using namespace std;
+
+        vector<vector<double>> fitness_vecs(chroms.size());
+        if (chroms.empty()) return fitness_vecs;
+
+        const size_t chrom_len = chroms[0]->size();
+        if (!all_of(chroms.begin(), chroms.end(), [chrom_len](const Chromosome* chrom) { return chrom->size() == chrom_len; }))
+        {
+            throw invalid_argument("The chromosomes evaluated by the socket evaluator must have the same length.");
+        }
+
+        const size_t num_batches = (chroms.size() + batch_size_ - 1) / batch_size_;
+        deque<size_t> pending(num_batches);
+        for (size_t i = 0; i < num_batches; i++) pending[i] = i;
+        size_t num_done = 0;
+
+        /* Add a batch to the messages sent to a worker. */
+        auto queueBatch = [&](Worker& worker, size_t batch)
+        {
+            size_t first = batch * batch_size_;
+            size_t count = min(batch_size_, chroms.size() - first);
+
+            detail::MessageHeader header = { detail::MESSAGE_MAGIC, uint32_t(detail::MessageType::batch), uint32_t(batch), uint32_t(count), uint32_t(chrom_len) };
+
+            const char* header_bytes = reinterpret_cast<const char*>(&header);
+            worker.outbuf.insert(worker.outbuf.end(), header_bytes, header_bytes + sizeof(header));
+            for (size_t i = first; i < first + count; i++)
+            {
+                const char* gene_bytes = reinterpret_cast<const char*>(chroms[i]->data());
+                worker.outbuf.insert(worker.outbuf.end(), gene_bytes, gene_bytes + chrom_len * sizeof(geneType));
+            }
+
+            if (worker.batches.empty() && worker.num_stale == 0) worker.batch_start = Clock::now();
+            worker.batches.push_back(batch);
+        };
+
+        /* Process the complete messages received from a worker. Returns false if the worker sent an invalid message. */
+        auto processMessages = [&](Worker& worker)
+        {
+            size_t pos = 0;
+            bool valid = true;
+            while (valid && worker.inbuf.size() - pos >= sizeof(detail::MessageHeader))
+            {
+                detail::MessageHeader header;
+                memcpy(&header, worker.inbuf.data() + pos, sizeof(header));
+
+                const bool is_error = header.type == uint32_t(detail::MessageType::error);
+                if (header.magic != detail::MESSAGE_MAGIC || (!is_error && header.type != uint32_t(detail::MessageType::result)))
+                {
+                    valid = false;
+                    break;
+                }
+
+                const size_t payload_size = is_error ? 0 : size_t(header.count) * header.width * sizeof(double);
+                if (worker.inbuf.size() - pos - sizeof(header) < payload_size) break;
+
+                const char* payload = worker.inbuf.data() + pos + sizeof(header);
+                pos += sizeof(header) + payload_size;
+                worker.batch_start = Clock::now();
+
+                /* The result of an earlier, failed evaluation. */
+                if (worker.num_stale != 0)
+                {
+                    worker.num_stale--;
+                    continue;
+                }
+                if (worker.batches.empty())
+                {
+                    valid = false;
+                    break;
+                }
+                if (is_error)
+                {
+                    worker.batches.pop_front();
+                    worker.inbuf.erase(worker.inbuf.begin(), worker.inbuf.begin() + pos);
+                    discardResults();
+                    throw runtime_error("A fitness evaluation failed on a worker of the socket evaluator.");
+                }
+
+                size_t batch = worker.batches.front();
+                size_t first = batch * batch_size_;
+                size_t count = min(batch_size_, chroms.size() - first);
+                if (header.id != batch || header.count != count)
+                {
+                    valid = false;
+                    break;
+                }
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    fitness_vecs[first + i].resize(header.width);
+                    memcpy(fitness_vecs[first + i].data(), payload + i * header.width * sizeof(double), header.width * sizeof(double));
+                }
+                worker.batches.pop_front();
+                num_done++;
+            }
+            worker.inbuf.erase(worker.inbuf.begin(), worker.inbuf.begin() + pos);
+
+            return valid;
+        };
+
+        auto isBusy = [](const Worker& worker) { return !worker.batches.empty() || worker.num_stale != 0; };
+
+        vector<pollfd> poll_fds;
+        while (num_done != num_batches)
+        {
+            /* Keep every worker busy with batches_per_worker batches. The ones returned by a disconnected worker go to the workers before it. */
+            for (size_t idx = workers_.size(); idx-- > 0;)
+            {
+                Worker& worker = workers_[idx];
+                while (worker.batches.size() + worker.num_stale < batches_per_worker_ && !pending.empty())
+                {
+                    queueBatch(worker, pending.front());
+                    pending.pop_front();
+                }
+                if (!sendPending(worker)) disconnectWorker(idx, pending);
+            }
+
+            if (workers_.empty() && wait_for_workers(1, worker_timeout_) == 0)
+            {
+                throw runtime_error("There are no workers connected to the socket evaluator.");
+            }
+
+            /* Wait for results, new workers, the sockets becoming writable, or the first batch timeout. */
+            int wait_ms = -1;
+            if (batch_timeout_ > 0.0)
+            {
+                auto now = Clock::now();
+                for (const auto& worker : workers_)
+                {
+                    if (!isBusy(worker)) continue;
+                    double remaining = batch_timeout_ - chrono::duration<double>(now - worker.batch_start).count();
+                    int ms = max(int(ceil(remaining * 1000.0)), 0);
+                    wait_ms = (wait_ms < 0) ? ms : min(wait_ms, ms);
+                }
+            }
+            poll_fds.assign(1, { listen_fd_, POLLIN, 0 });
+            for (const auto& worker : workers_)
+            {
+                short events = (worker.out_pos != worker.outbuf.size()) ? (POLLIN | POLLOUT) : POLLIN;
+                poll_fds.push_back({ worker.fd, events, 0 });
+            }
+
+            if (::poll(poll_fds.data(), poll_fds.size(), wait_ms) < 0)
+            {
+                if (errno == EINTR) continue;
+                discardResults();
+                throw runtime_error("Error while waiting for the workers of the socket evaluator.");
+            }
+
+            /* Process the workers in reverse order, so disconnecting one doesn't change the indices of the rest. */
+            auto now = Clock::now();
+            for (size_t idx = workers_.size(); idx-- > 0;)
+            {
+                Worker& worker = workers_[idx];
+                const short revents = poll_fds[idx + 1].revents;
+
+                bool connected = true;
+                if (revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL))
+                {
+                    bool open = receiveInput(worker);
+                    connected = processMessages(worker) && open;
+                }
+                if (connected && (revents & POLLOUT)) connected = sendPending(worker);
+
+                /* A hung worker is handled like one that disconnected. */
+                bool timed_out = batch_timeout_ > 0.0 && isBusy(worker) && chrono::duration<double>(now - worker.batch_start).count() >= batch_timeout_;
+
+                if (!connected || timed_out) disconnectWorker(idx, pending);
+            }
+            if (poll_fds[0].revents & POLLIN) acceptWorker();
+        }
+
+        return fitness_vecs;
+    }
+
+    template<typename geneType>
+    void runSocketWorker(const std::string& address, const std::function<std::vector<double>(const std::vector<geneType>&)>& fitness_function,
+                         double connect_timeout)
+    {
+        static_assert(std::is_trivially_copyable_v<geneType>, "The genes must be trivially copyable to be sent over the sockets.");
+
+        detail::SocketAddress addr = detail::parseSocketAddress(address);
+
+        /* The master might not be listening yet. */
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(connect_timeout);
+        int fd = detail::openSocket(addr, false);
+        while (fd < 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            fd = detail::openSocket(addr, false);
+        }
+        if (fd < 0) throw std::runtime_error("Couldn't connect to the master at " + address + ".");
+
+        detail::MessageHeader hello = { detail::MESSAGE_MAGIC, uint32_t(detail::MessageType::hello), 0, 0, uint32_t(sizeof(geneType)) };
+        if (!detail::sendAll(fd, &hello, sizeof(hello)))
+        {
+            ::close(fd);
+            throw std::runtime_error("Couldn't connect to the master at " + address + ".");
+        }
+
+        std::vector<geneType> genes;
+        std::vector<double> fitness_buf;
+        detail::MessageHeader header;
+        while (detail::readAll(fd, &header, sizeof(header)) && header.magic == detail::MESSAGE_MAGIC &&
+               header.type == uint32_t(detail::MessageType::batch))
+        {
+            genes.resize(size_t(header.count) * header.width);
+            if (!detail::readAll(fd, genes.data(), genes.size() * sizeof(geneType))) break;
+
+            detail::MessageHeader reply = { detail::MESSAGE_MAGIC, uint32_t(detail::MessageType::result), header.id, header.count, 0 };
+            fitness_buf.clear();
+            try
+            {
+                std::vector<geneType> chrom(header.width);
+                for (size_t i = 0; i < header.count; i++)
+                {
+                    std::copy_n(genes.begin() + i * header.width, header.width, chrom.begin());
+                    std::vector<double> fx = fitness_function(chrom);
+
+                    if (i == 0) reply.width = uint32_t(fx.size());
+                    if (fx.size() != reply.width) throw std::domain_error("The fitness vectors have different sizes.");
+                    fitness_buf.insert(fitness_buf.end(), fx.begin(), fx.end());
+                }
+            }
+            catch (...)
+            {
+                reply = { detail::MESSAGE_MAGIC, uint32_t(detail::MessageType::error), header.id, 0, 0 };
+                fitness_buf.clear();
+            }
+
+            if (!detail::sendAll(fd, &reply, sizeof(reply)) ||
+                !detail::sendAll(fd, fitness_buf.data(), fitness_buf.size() * sizeof(double))) break;
+        }
+
+        ::close(fd);
+    }
+
+} // namespace genetic_algorithm
+
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#endif // !GA_SOCKET_EVALUATOR_H
\ No newline at end of file
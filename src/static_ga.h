@@ -0,0 +1,320 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/**
+* This file contains the statically configured genetic algorithm class template, and
+* some policies that can be used with it.
+*
+* @file static_ga.h
+*/
+
+#ifndef GA_STATIC_GA_H
+#define GA_STATIC_GA_H
+
+#include <vector>
+#include <utility>
+#include <concepts>
+#include <cstddef>
+
+#include "base_ga.h"
+
+namespace genetic_algorithm
+{
+    /**
+    * Genetic algorithm with the encoding and the genetic operators specified as template parameters (policies). \n
+    * The operators are called directly in the main loop of the algorithm instead of through std::function objects or switch statements,
+    * so they can be inlined by the compiler. All of the other settings of the GA (mode, population size, stop conditions, etc.) are
+    * the same as in the runtime configurable GAs. \n
+    * The operators of the BinaryGA, RCGA, IntegerGA and PermutationGA classes can be used as the policies, see the static_ga example.
+    *
+    * @tparam Encoding The policy used to generate the chromosomes of the initial population. Must define a gene_type, and be callable
+    *   as std::vector<gene_type>(size_t chrom_len). @see policy::BinaryEncoding @see policy::RealEncoding
+    * @tparam Selection The selection operator used in the single-objective algorithm, callable as Candidate(const Population&).
+    *   It may also have a prepare(Population&) member function, which is called once in every generation before the selections.
+    *   The NSGA-II and NSGA-III always use their own selection operators. @see policy::TournamentSelection
+    * @tparam Crossover The crossover operator, callable as CandidatePair(const Candidate&, const Candidate&, double crossover_rate).
+    * @tparam Mutation The mutation operator, callable as void(Candidate&, double mutation_rate).
+    * @tparam Fitness The fitness function, callable as std::vector<double>(const std::vector<gene_type>&). Must be copyable.
+    *   It is stored as the fitness function of the GA, and it is only called directly while it isn't replaced by another one.
+    */
+    template<typename Encoding, typename Selection, typename Crossover, typename Mutation, typename Fitness>
+    class StaticGA final : public GA<typename Encoding::gene_type>
+    {
+    public:
+
+        using Base = GA<typename Encoding::gene_type>;
+        using typename Base::Candidate;
+        using typename Base::CandidatePair;
+        using typename Base::CandidateVec;
+        using typename Base::Population;
+        using typename Base::Chromosome;
+
+        /**
+        * Basic constructor for the StaticGA.
+        *
+        * @param chrom_len The length of the chromosomes.
+        * @param encoding The encoding policy.
+        * @param selection The selection operator used in the single-objective algorithm.
+        * @param crossover The crossover operator.
+        * @param mutation The mutation operator.
+        * @param fitness_function The fitness function to find the maximum of.
+        */
+        StaticGA(size_t chrom_len, Encoding encoding, Selection selection, Crossover crossover, Mutation mutation, Fitness fitness_function);
+
+        /**
+        * Runs the genetic algorithm with the selected settings, using the operator policies of the StaticGA.
+        * This is also used when the run is started through a reference to the base GA class.
+        *
+        * @returns The optimal solutions.
+        */
+        [[maybe_unused]] CandidateVec run() override;
+
+        /** @returns The policies used in the algorithm, so their parameters can be changed between runs. */
+        [[nodiscard]] Encoding& encoding_policy() noexcept { return encoding_; }
+        [[nodiscard]] Selection& selection_policy() noexcept { return selection_; }
+        [[nodiscard]] Crossover& crossover_policy() noexcept { return crossover_; }
+        [[nodiscard]] Mutation& mutation_policy() noexcept { return mutation_; }
+
+    private:
+
+        Encoding encoding_;
+        Selection selection_;
+        Crossover crossover_;
+        Mutation mutation_;
+
+        Candidate generateCandidate() const override;
+        CandidatePair crossover(const Candidate& parent1, const Candidate& parent2) const override;
+        void mutate(Candidate& child) const override;
+    };
+
+    /** Some commonly used policies for the StaticGA. */
+    namespace policy
+    {
+        /** Binary encoding, each gene is either 0 or 1 (stored as char types). */
+        struct BinaryEncoding
+        {
+            using gene_type = char;
+
+            std::vector<char> operator()(size_t chrom_len) const;
+        };
+
+        /** Real encoding, each gene is a real value between the limits of the gene. */
+        struct RealEncoding
+        {
+            using gene_type = double;
+
+            std::vector<std::pair<double, double>> limits;    /**< The lower and upper bounds of each gene. */
+
+            std::vector<double> operator()(size_t chrom_len) const;
+        };
+
+        /** Integer encoding, each gene is an integer on [0, base-1]. */
+        struct IntegerEncoding
+        {
+            using gene_type = size_t;
+
+            size_t base = 4;    /**< The number of values a gene can take. */
+
+            std::vector<size_t> operator()(size_t chrom_len) const;
+        };
+
+        /** Permutation encoding, the genes are all unique integers on [0, chrom_len-1]. */
+        struct PermutationEncoding
+        {
+            using gene_type = size_t;
+
+            std::vector<size_t> operator()(size_t chrom_len) const;
+        };
+
+        /** Tournament selection for the single-objective algorithm. */
+        struct TournamentSelection
+        {
+            size_t size = 2;    /**< The number of candidates in each tournament. Must be at least 2. */
+
+            template<typename Population>
+            typename Population::value_type operator()(const Population& pop) const;
+        };
+
+    } // namespace policy
+
+    template<typename Encoding, typename Selection, typename Crossover, typename Mutation, typename Fitness>
+    StaticGA(size_t, Encoding, Selection, Crossover, Mutation, Fitness) -> StaticGA<Encoding, Selection, Crossover, Mutation, Fitness>;
+
+} // namespace genetic_algorithm
+
+
+/* IMPLEMENTATION */
+
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+
+#include "rng.h"
+
+namespace genetic_algorithm
+{
+    template<typename Encoding, typename Selection, typename Crossover, typename Mutation, typename Fitness>
+    inline StaticGA<Encoding, Selection, Crossover, Mutation, Fitness>::StaticGA(size_t chrom_len, Encoding encoding, Selection selection,
+                                                                                 Crossover crossover, Mutation mutation, Fitness fitness_function)
+        : Base(chrom_len, std::move(fitness_function)), encoding_(std::move(encoding)), selection_(std::move(selection)), crossover_(std::move(crossover)),
+          mutation_(std::move(mutation))
+    {
+    }
+
+    template<typename Encoding, typename Selection, typename Crossover, typename Mutation, typename Fitness>
+    inline auto StaticGA<Encoding, Selection, Crossover, Mutation, Fitness>::run() -> CandidateVec
+    {
+        using Mode = typename Base::Mode;
+
+        auto prep_f = [this](Population& pop)
+        {
+            if constexpr (requires { selection_.prepare(pop); })
+            {
+                if (this->mode_ == Mode::single_objective) selection_.prepare(pop);
+            }
+        };
+        auto select_f = [this](const Population& pop) -> Candidate
+        {
+            switch (this->mode_)
+            {
+                case Mode::single_objective:
+                    return selection_(pop);
+                case Mode::multi_objective_sorting:
+                    return Base::nsga2Select(pop);
+                default:
+                    return Base::nsga3Select(pop);
+            }
+        };
+        auto crossover_f = [this](const Candidate& parent1, const Candidate& parent2) -> CandidatePair
+        {
+            return crossover_(parent1, parent2, this->crossover_rate_);
+        };
+        auto mutate_f = [this](Candidate& child)
+        {
+            mutation_(child, this->mutation_rate_);
+        };
+
+        /* The fitness policy is stored in the fitness function of the GA, call it directly unless it was replaced. */
+        if (Fitness* fitness = this->fitnessFunction.template target<Fitness>())
+        {
+            return this->runGenerations(prep_f, select_f, crossover_f, mutate_f,
+            [fitness](const Chromosome& chrom) -> std::vector<double>
+            {
+                return (*fitness)(chrom);
+            });
+        }
+
+        return this->runGenerations(prep_f, select_f, crossover_f, mutate_f, this->fitnessFunction);
+    }
+
+    template<typename Encoding, typename Selection, typename Crossover, typename Mutation, typename Fitness>
+    inline auto StaticGA<Encoding, Selection, Crossover, Mutation, Fitness>::generateCandidate() const -> Candidate
+    {
+        assert(this->chrom_len_ > 0);
+
+        return Candidate(encoding_(this->chrom_len_));
+    }
+
+    template<typename Encoding, typename Selection, typename Crossover, typename Mutation, typename Fitness>
+    inline auto StaticGA<Encoding, Selection, Crossover, Mutation, Fitness>::crossover(const Candidate& parent1, const Candidate& parent2) const -> CandidatePair
+    {
+        return crossover_(parent1, parent2, this->crossover_rate_);
+    }
+
+    template<typename Encoding, typename Selection, typename Crossover, typename Mutation, typename Fitness>
+    inline void StaticGA<Encoding, Selection, Crossover, Mutation, Fitness>::mutate(Candidate& child) const
+    {
+        mutation_(child, this->mutation_rate_);
+    }
+
+
+    inline std::vector<char> policy::BinaryEncoding::operator()(size_t chrom_len) const
+    {
+        std::vector<char> chrom;
+        chrom.reserve(chrom_len);
+        for (size_t i = 0; i < chrom_len; i++)
+        {
+            chrom.push_back(char(rng::randomBool()));
+        }
+
+        return chrom;
+    }
+
+    inline std::vector<double> policy::RealEncoding::operator()(size_t chrom_len) const
+    {
+        assert(limits.size() == chrom_len);
+
+        std::vector<double> chrom;
+        chrom.reserve(chrom_len);
+        for (size_t i = 0; i < chrom_len; i++)
+        {
+            chrom.push_back(rng::randomReal(limits[i].first, limits[i].second));
+        }
+
+        return chrom;
+    }
+
+    inline std::vector<size_t> policy::IntegerEncoding::operator()(size_t chrom_len) const
+    {
+        assert(base > 1);
+
+        std::vector<size_t> chrom;
+        chrom.reserve(chrom_len);
+        for (size_t i = 0; i < chrom_len; i++)
+        {
+            chrom.push_back(rng::randomInt(size_t{ 0 }, base - 1));
+        }
+
+        return chrom;
+    }
+
+    inline std::vector<size_t> policy::PermutationEncoding::operator()(size_t chrom_len) const
+    {
+        std::vector<size_t> chrom(chrom_len);
+        std::iota(chrom.begin(), chrom.end(), size_t{ 0 });
+        std::shuffle(chrom.begin(), chrom.end(), rng::prng);
+
+        return chrom;
+    }
+
+    template<typename Population>
+    inline typename Population::value_type policy::TournamentSelection::operator()(const Population& pop) const
+    {
+        assert(!pop.empty());
+        assert(size > 1);
+
+        /* Randomly pick size candidates and return the best one. Indices may repeat. */
+        size_t best = rng::randomIdx(pop.size());
+        for (size_t i = 1; i < size; i++)
+        {
+            size_t idx = rng::randomIdx(pop.size());
+            if (pop[idx].fitness[0] > pop[best].fitness[0]) best = idx;
+        }
+
+        return pop[best];
+    }
+
+} // namespace genetic_algorithm
+
+#endif // !GA_STATIC_GA_H
\ No newline at end of file
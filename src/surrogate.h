@@ -0,0 +1,228 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/*
+* This file contains the surrogate model used for predicting the fitness of the children
+* before evaluating them, and the statistics of its predictions.
+*/
+
+#ifndef GA_SURROGATE_H
+#define GA_SURROGATE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace genetic_algorithm::detail
+{
+    /**
+    * The accuracy of the fitness predictions of the surrogate model in a run. \n
+    * The accuracy is measured in each generation on the children that were evaluated with the fitness function.
+    */
+    struct SurrogateStats
+    {
+        std::vector<double> rank_correlation;   /**< The Spearman rank correlation of the predicted and real fitness values in each generation (averaged over the objectives). */
+        std::vector<double> rmse;               /**< The root mean square error of the predicted fitness values in each generation (averaged over the objectives). */
+        size_t num_predictions = 0;             /**< The number of children whose fitness was predicted. */
+        size_t num_skipped_evals = 0;           /**< The number of children discarded without evaluating them. */
+
+        void clear() noexcept;
+    };
+
+    /*
+    * Online k-nearest neighbours regression model for the fitness function, using inverse distance weighting. \n
+    * The model stores the last capacity samples added to it, older samples are overwritten.
+    */
+    class KnnSurrogate
+    {
+    public:
+
+        explicit KnnSurrogate(size_t num_neighbours = 5, size_t capacity = 4096);
+
+        /* Add an evaluated point to the model. */
+        template<typename geneType, typename FitnessVec>
+        void add(const std::vector<geneType>& x, const FitnessVec& fx);
+
+        /* Predict the fitness vector of the point x. There must be at least 1 sample in the model. */
+        template<typename geneType>
+        [[nodiscard]] std::vector<double> predict(const std::vector<geneType>& x) const;
+
+        void clear() noexcept;
+        [[nodiscard]] size_t size() const noexcept { return xs_.size(); }
+
+        size_t num_neighbours;
+
+    private:
+
+        std::vector<std::vector<double>> xs_;
+        std::vector<std::vector<double>> fxs_;
+        size_t capacity_;
+        size_t next_ = 0;   /* The index of the next sample to overwrite once the model is full. */
+    };
+
+    /* The Spearman rank correlation of x and y. Returns 0 if either of them is constant. */
+    inline double rankCorrelation(const std::vector<double>& x, const std::vector<double>& y);
+
+} // namespace genetic_algorithm::detail
+
+
+/* IMPLEMENTATION */
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+namespace genetic_algorithm::detail
+{
+    inline void SurrogateStats::clear() noexcept
+    {
+        rank_correlation.clear();
+        rmse.clear();
+        num_predictions = 0;
+        num_skipped_evals = 0;
+    }
+
+    inline KnnSurrogate::KnnSurrogate(size_t num_neighbours, size_t capacity)
+        : num_neighbours(num_neighbours), capacity_(capacity)
+    {
+        assert(num_neighbours > 0);
+        assert(capacity > 0);
+    }
+
+    template<typename geneType, typename FitnessVec>
+    void KnnSurrogate::add(const std::vector<geneType>& x, const FitnessVec& fx)
+    {
+        std::vector<double> point(x.begin(), x.end());
+        std::vector<double> fpoint(fx.begin(), fx.end());
+
+        if (xs_.size() < capacity_)
+        {
+            xs_.push_back(std::move(point));
+            fxs_.push_back(std::move(fpoint));
+        }
+        else
+        {
+            xs_[next_] = std::move(point);
+            fxs_[next_] = std::move(fpoint);
+            next_ = (next_ + 1) % capacity_;
+        }
+    }
+
+    template<typename geneType>
+    std::vector<double> KnnSurrogate::predict(const std::vector<geneType>& x) const
+    {
+        assert(!xs_.empty());
+
+        /* Find the nearest neighbours using their squared distances. */
+        std::vector<std::pair<double, size_t>> distances(xs_.size());
+        for (size_t i = 0; i < xs_.size(); i++)
+        {
+            assert(xs_[i].size() == x.size());
+
+            double d = 0.0;
+            for (size_t j = 0; j < x.size(); j++)
+            {
+                double diff = double(x[j]) - xs_[i][j];
+                d += diff * diff;
+            }
+            distances[i] = { d, i };
+        }
+
+        size_t k = std::min(num_neighbours, distances.size());
+        std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+
+        /* Exact match with a sample. */
+        if (distances[0].first == 0.0) return fxs_[distances[0].second];
+
+        std::vector<double> fx(fxs_[0].size(), 0.0);
+        double weight_sum = 0.0;
+        for (size_t i = 0; i < k; i++)
+        {
+            double weight = 1.0 / std::sqrt(distances[i].first);
+            const auto& fneighbour = fxs_[distances[i].second];
+            for (size_t j = 0; j < fx.size(); j++) fx[j] += weight * fneighbour[j];
+            weight_sum += weight;
+        }
+        for (auto& f : fx) f /= weight_sum;
+
+        return fx;
+    }
+
+    inline void KnnSurrogate::clear() noexcept
+    {
+        xs_.clear();
+        fxs_.clear();
+        next_ = 0;
+    }
+
+    /* The ranks of the values of x, with the average rank used for ties. */
+    inline std::vector<double> ranks(const std::vector<double>& x)
+    {
+        std::vector<size_t> indices(x.size());
+        std::iota(indices.begin(), indices.end(), size_t{ 0 });
+        std::sort(indices.begin(), indices.end(), [&x](size_t lidx, size_t ridx) { return x[lidx] < x[ridx]; });
+
+        std::vector<double> rank(x.size());
+        for (size_t first = 0; first < indices.size();)
+        {
+            size_t last = first + 1;
+            while (last < indices.size() && x[indices[last]] == x[indices[first]]) last++;
+
+            double avg_rank = (first + last - 1) / 2.0;
+            for (size_t i = first; i < last; i++) rank[indices[i]] = avg_rank;
+
+            first = last;
+        }
+
+        return rank;
+    }
+
+    inline double rankCorrelation(const std::vector<double>& x, const std::vector<double>& y)
+    {
+        assert(x.size() == y.size());
+
+        if (x.size() < 2) return 0.0;
+
+        std::vector<double> rx = ranks(x);
+        std::vector<double> ry = ranks(y);
+
+        double mean = (x.size() - 1) / 2.0;
+        double cov = 0.0, var_x = 0.0, var_y = 0.0;
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            cov += (rx[i] - mean) * (ry[i] - mean);
+            var_x += (rx[i] - mean) * (rx[i] - mean);
+            var_y += (ry[i] - mean) * (ry[i] - mean);
+        }
+
+        if (var_x == 0.0 || var_y == 0.0) return 0.0;
+
+        return cov / std::sqrt(var_x * var_y);
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // !GA_SURROGATE_H
\ No newline at end of file
@@ -0,0 +1,201 @@
+/*
+*  MIT License
+*
+*  Copyright (c) 2021 Krisztin Rugsi
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this softwareand associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright noticeand this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*/
+
+/*
+* This file contains the tracer used for recording the timeline of a run of the genetic algorithms
+* in the Chrome trace event format, which can be viewed in Perfetto or chrome://tracing.
+*/
+
+#ifndef GA_TRACER_H
+#define GA_TRACER_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace genetic_algorithm::detail
+{
+    /*
+    * Records events with a start time and a duration from any thread, and writes them to a
+    * file in the Chrome trace JSON format. \n
+    * The events are buffered and written to the file by a background thread, so recording an event
+    * only requires appending it to a buffer. The event names must be string literals.
+    */
+    class Tracer
+    {
+    public:
+
+        using Clock = std::chrono::steady_clock;
+
+        Tracer() = default;
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+        ~Tracer();
+
+        /* Start writing the events to the file fname. Throws std::runtime_error if the file can't be opened. */
+        void open(const std::string& fname);
+
+        /* Write the remaining events and close the file. Does nothing if the tracer isn't open. */
+        void close();
+
+        /* Returns true if the events are being recorded. */
+        [[nodiscard]] bool active() const noexcept { return active_.load(std::memory_order_relaxed); }
+
+        /* Record an event which started at start and ended at end on the calling thread. Thread-safe. */
+        void complete(const char* name, const char* category, Clock::time_point start, Clock::time_point end);
+
+    private:
+
+        struct Event
+        {
+            const char* name;
+            const char* category;
+            std::uint64_t tid;
+            Clock::duration start;
+            Clock::duration duration;
+        };
+
+        std::ofstream file_;
+        std::thread writer_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::vector<Event> pending_;
+        std::atomic<bool> active_ = false;
+        bool stop_ = false;
+        Clock::time_point epoch_;
+
+        void writeEvents();
+
+        /* Returns a small integer identifying the calling thread. */
+        static std::uint64_t threadId() noexcept;
+    };
+
+} // namespace genetic_algorithm::detail
+
+
+/* IMPLEMENTATION */
+
+#include <iomanip>
+#include <stdexcept>
+
+namespace genetic_algorithm::detail
+{
+    inline Tracer::~Tracer()
+    {
+        close();
+    }
+
+    inline void Tracer::open(const std::string& fname)
+    {
+        close();
+
+        file_.open(fname, std::ios::out | std::ios::trunc);
+        if (!file_.is_open())
+        {
+            throw std::runtime_error("Couldn't open the trace file " + fname + ".");
+        }
+        file_ << std::fixed << std::setprecision(3);
+        file_ << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file_ << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"genetic_algorithm\"}}";
+
+        stop_ = false;
+        epoch_ = Clock::now();
+        writer_ = std::thread(&Tracer::writeEvents, this);
+        active_.store(true, std::memory_order_relaxed);
+    }
+
+    inline void Tracer::close()
+    {
+        if (!writer_.joinable()) return;
+
+        active_.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        writer_.join();
+
+        file_ << "\n]}\n";
+        file_.close();
+    }
+
+    inline void Tracer::complete(const char* name, const char* category, Clock::time_point start, Clock::time_point end)
+    {
+        Event event = { name, category, threadId(), start - epoch_, end - start };
+
+        bool was_empty;
+        {
+            std::lock_guard lock(mutex_);
+            was_empty = pending_.empty();
+            pending_.push_back(event);
+        }
+        if (was_empty) cv_.notify_one();
+    }
+
+    inline void Tracer::writeEvents()
+    {
+        using std::chrono::duration;
+        using micros = duration<double, std::micro>;
+
+        std::vector<Event> events;
+        std::unique_lock lock(mutex_);
+        while (true)
+        {
+            cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+            if (pending_.empty() && stop_) break;
+
+            events.swap(pending_);
+            lock.unlock();
+
+            for (const Event& event : events)
+            {
+                file_ << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                      << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.tid
+                      << ",\"ts\":" << micros(event.start).count() << ",\"dur\":" << micros(event.duration).count() << "}";
+            }
+            events.clear();
+
+            lock.lock();
+        }
+        file_.flush();
+    }
+
+    inline std::uint64_t Tracer::threadId() noexcept
+    {
+        static std::atomic<std::uint64_t> next_id = 1;
+        thread_local const std::uint64_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+
+        return id;
+    }
+
+} // namespace genetic_algorithm::detail
+
+#endif // !GA_TRACER_H
\ No newline at end of file
@@ -0,0 +1,155 @@
+/* Machine-readable records of the results of the benchmarks, written as JSON or CSV. */
+
+#ifndef BENCH_RECORD_H
+#define BENCH_RECORD_H
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+/* The results of a single run of a benchmark. */
+struct BenchRecord
+{
+    string problem;
+    string algorithm;
+    string config;
+    size_t run = 0;                                             /* The index of the repetition of the benchmark. */
+    double wall_time = 0.0;                                     /* In seconds. */
+    size_t fitness_evals = 0;
+    double evals_per_sec = 0.0;
+    size_t num_solutions = 0;
+    double best_fitness = numeric_limits<double>::quiet_NaN();  /* Single-objective problems only. */
+    double igd = numeric_limits<double>::quiet_NaN();           /* Multi-objective problems with a known optimal front only. */
+    size_t peak_rss_kb = 0;                                     /* The peak resident set size of the process so far. */
+};
+
+inline vector<BenchRecord> bench_records;
+inline size_t bench_run_idx = 0;
+
+/* Returns the peak resident set size of the process in kilobytes, or 0 if it can't be determined. */
+size_t peakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.PeakWorkingSetSize / 1024;
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return size_t(usage.ru_maxrss) / 1024;      /* In bytes on macOS. */
+#else
+    return size_t(usage.ru_maxrss);
+#endif
+#endif
+}
+
+/* Describes the general settings of the GA. */
+template<typename GA>
+string gaConfigString(const GA& ga)
+{
+    ostringstream config;
+    config << "pop=" << ga.population_size() << " max_gen=" << ga.max_gen()
+           << " pc=" << ga.crossover_rate() << " pm=" << ga.mutation_rate();
+
+    return config.str();
+}
+
+/* Record the results of a run of the GA on the problem. */
+template<typename GA, typename CandidateVec>
+void recordResult(const string& problem, const string& algorithm, const GA& ga, const CandidateVec& sols, double time_spent,
+                  double igd = numeric_limits<double>::quiet_NaN())
+{
+    BenchRecord record;
+    record.problem = problem;
+    record.algorithm = algorithm;
+    record.config = gaConfigString(ga);
+    record.run = bench_run_idx;
+    record.wall_time = time_spent;
+    record.fitness_evals = ga.num_fitness_evals();
+    record.evals_per_sec = time_spent > 0.0 ? record.fitness_evals / time_spent : 0.0;
+    record.num_solutions = sols.size();
+    if (!sols.empty() && sols[0].fitness.size() == 1) record.best_fitness = sols[0].fitness[0];
+    record.igd = igd;
+    record.peak_rss_kb = peakRssKb();
+
+    bench_records.push_back(record);
+}
+
+/* Writes a double value as a JSON number, or null if it isn't finite. */
+string jsonNumber(double value)
+{
+    if (!isfinite(value)) return "null";
+
+    ostringstream str;
+    str << setprecision(10) << value;
+
+    return str.str();
+}
+
+/* Writes a string as a JSON string. The strings used in the records don't contain characters that need escaping other than these. */
+string jsonString(const string& str)
+{
+    string escaped = "\"";
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped + "\"";
+}
+
+void writeRecordsJson(const vector<BenchRecord>& records, const string& fname)
+{
+    ofstream file(fname);
+    file << "[\n";
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const BenchRecord& r = records[i];
+        file << "  {\"problem\": " << jsonString(r.problem)
+             << ", \"algorithm\": " << jsonString(r.algorithm)
+             << ", \"config\": " << jsonString(r.config)
+             << ", \"run\": " << r.run
+             << ", \"wall_time\": " << jsonNumber(r.wall_time)
+             << ", \"fitness_evals\": " << r.fitness_evals
+             << ", \"evals_per_sec\": " << jsonNumber(r.evals_per_sec)
+             << ", \"num_solutions\": " << r.num_solutions
+             << ", \"best_fitness\": " << jsonNumber(r.best_fitness)
+             << ", \"igd\": " << jsonNumber(r.igd)
+             << ", \"peak_rss_kb\": " << r.peak_rss_kb << "}"
+             << (i + 1 < records.size() ? ",\n" : "\n");
+    }
+    file << "]\n";
+}
+
+void writeRecordsCsv(const vector<BenchRecord>& records, const string& fname)
+{
+    auto number = [](double value) { return isfinite(value) ? jsonNumber(value) : string(); };
+
+    ofstream file(fname);
+    file << "problem,algorithm,config,run,wall_time,fitness_evals,evals_per_sec,num_solutions,best_fitness,igd,peak_rss_kb\n";
+    for (const BenchRecord& r : records)
+    {
+        file << r.problem << "," << r.algorithm << ",\"" << r.config << "\"," << r.run << "," << number(r.wall_time) << ","
+             << r.fitness_evals << "," << number(r.evals_per_sec) << "," << r.num_solutions << ","
+             << number(r.best_fitness) << "," << number(r.igd) << "," << r.peak_rss_kb << "\n";
+    }
+}
+
+#endif // !BENCH_RECORD_H
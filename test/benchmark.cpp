@@ -1,4 +1,14 @@
+/*
+* Runs the benchmarks of the genetic algorithms. \n
+* Usage: benchmark [--json file] [--csv file] [--runs n] [--quality] \n
+* The results of each run are written to the JSON/CSV files if they are specified. The benchmarks are repeated n times (default 1).
+* With --quality, only the quality-versus-time benchmarks of the multi-objective algorithms are run, and the other arguments
+* can't be used, as these benchmarks write their results to their own CSV files. @see mo_quality_tests.h
+* When no arguments are given, the program waits for a key press before exiting.
+*/
+
 #include "time_test.h"
+#include "mo_time_test.h"
 
 #include "binary_tests.h"
 #include "real_tests.h"
@@ -7,10 +17,15 @@
 
 #include "nsga2_tests.h"
 #include "nsga3_tests.h"
+#include "mo_quality_tests.h"
+
+#include "bench_record.h"
 
+#include <string>
 #include <cstdio>
+#include <cstdlib>
 
-int main()
+void runBenchmarks()
 {
     binaryRastriginTest();
     binaryRosenbrockTest();
@@ -24,6 +39,21 @@ int main()
     realGriewankTest();
     realAckleyTest();
 
+    realRastriginSurrogateTest();
+    realRastriginMultiFidelityTest();
+    realRosenbrockMemeticTest(/* lamarckian */ true);
+    realRosenbrockMemeticTest(/* lamarckian */ false);
+    realRastriginDeTest(RCGA::DeStrategy::rand_1_bin);
+    realRastriginDeTest(RCGA::DeStrategy::current_to_pbest);
+    realRastriginCmaEsTest(RCGA::CmaEsMode::full, RCGA::CmaEsRestart::ipop);
+    realRastriginCmaEsTest(RCGA::CmaEsMode::full, RCGA::CmaEsRestart::bipop);
+    realRastriginCmaEsTest(RCGA::CmaEsMode::separable, RCGA::CmaEsRestart::ipop);
+    realRastriginCmaEsTest(RCGA::CmaEsMode::separable, RCGA::CmaEsRestart::bipop);
+    realSphereMutationTest(RCGA::MutationMethod::gauss);
+    realSphereMutationTest(RCGA::MutationMethod::self_adaptive);
+    realRastriginCrossoverTest(RCGA::CrossoverMethod::simulated_binary);
+    realRastriginCrossoverTest(RCGA::CrossoverMethod::adaptive);
+
     perm52Test();
     perm124Test();
     perm226Test();
@@ -44,13 +74,81 @@ int main()
 
     nsga2Dtlz1Test();
     nsga2Dtlz2Test();
+    nsga2C1Dtlz1Test();
 
     nsga3Dtlz1Test();
     nsga3Dtlz2Test();
+    nsga3C1Dtlz1Test();
+}
+
+int main(int argc, char* argv[])
+{
+    std::string json_fname, csv_fname;
+    size_t num_runs = 1;
+    bool quality = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quality")
+        {
+            quality = true;
+            continue;
+        }
+        if (arg != "--json" && arg != "--csv" && arg != "--runs")
+        {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+        if (i + 1 == argc)
+        {
+            std::fprintf(stderr, "Missing value for argument: %s\n", argv[i]);
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        if (arg == "--json") json_fname = value;
+        else if (arg == "--csv") csv_fname = value;
+        else
+        {
+            char* end = nullptr;
+            long runs = std::strtol(value, &end, 10);
+            if (end == value || *end != '\0' || runs < 1)
+            {
+                std::fprintf(stderr, "The number of runs must be a positive integer: %s\n", value);
+                return 1;
+            }
+            num_runs = size_t(runs);
+        }
+    }
+
+    if (quality)
+    {
+        /* The quality benchmarks always write their own CSV files, and they are only run once. */
+        if (!json_fname.empty() || !csv_fname.empty() || num_runs != 1)
+        {
+            std::fprintf(stderr, "The --json, --csv and --runs arguments can't be used with --quality.\n");
+            return 1;
+        }
+        moQualityTests();
+        return 0;
+    }
+
+    for (bench_run_idx = 0; bench_run_idx < num_runs; bench_run_idx++)
+    {
+        runBenchmarks();
+    }
+
+    if (!json_fname.empty()) writeRecordsJson(bench_records, json_fname);
+    if (!csv_fname.empty()) writeRecordsCsv(bench_records, csv_fname);
 
-    timeGA();
+    if (argc == 1)
+    {
+        timeMoKernels();
+        timeGA();
 
-    std::getchar();
+        std::getchar();
+    }
 
     return 0;
-}
\ No newline at end of file
+}
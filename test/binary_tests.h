@@ -43,6 +43,8 @@ void binaryRastriginTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Rastrigin", "BinaryGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Rastrigin function is at (best is all " << rastriginFunction.optimal_x() << "): \n";
@@ -89,6 +91,8 @@ void binaryRosenbrockTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Rosenbrock", "BinaryGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Rosenbrock function is at (best is all " << rosenbrockFunction.optimal_x() << "): \n";
@@ -137,6 +141,8 @@ void binarySchwefelTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Schwefel", "BinaryGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Schwefel function is at (best is all " << schwefelFunction.optimal_x() << "): \n";
@@ -186,6 +192,8 @@ void binaryGriewankTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Griewank", "BinaryGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Griewank function is at (best is all " << griewankFunction.optimal_x() << "): \n";
@@ -235,6 +243,8 @@ void binaryAckleyTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Ackley", "BinaryGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Ackley function is at (best is all " << ackleyFunction.optimal_x() << "): \n";
@@ -0,0 +1,119 @@
+# Script for comparing two result files written by the benchmark (benchmark --json/--csv).
+#
+# Usage: python compare_bench.py baseline.json new.json [--threshold 0.05]
+#
+# The runs of the same benchmark (problem, algorithm, config) are grouped together, and the mean of each
+# metric is compared between the two files, along with the 95% confidence interval of the difference
+# (Welch's t-interval over the repeated runs). A change is flagged as a regression if it is worse than the
+# threshold (relative to the baseline mean), and the confidence interval doesn't contain 0.
+# The exit code is 1 if any regressions were found.
+
+import argparse
+import csv
+import json
+import math
+import statistics
+import sys
+
+# The metrics compared, and whether higher values are better
+METRICS = {
+    "wall_time": False,
+    "evals_per_sec": True,
+    "best_fitness": True,
+    "igd": False,
+    "peak_rss_kb": False,
+}
+
+# Two-sided 95% critical values of the t-distribution for 1-30 degrees of freedom
+T_CRIT_95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+             2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+             2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042]
+
+def tCritical(df):
+    if df < 1:
+        return math.inf
+    if df > len(T_CRIT_95):
+        return 1.960
+    return T_CRIT_95[int(df) - 1]
+
+# Read the records from a JSON or CSV file written by the benchmark
+def readRecords(fname):
+    if fname.endswith(".csv"):
+        with open(fname, newline = "") as f:
+            records = list(csv.DictReader(f))
+        for r in records:
+            for metric in METRICS:
+                r[metric] = float(r[metric]) if r.get(metric, "") != "" else None
+        return records
+
+    with open(fname) as f:
+        return json.load(f)
+
+# Group the values of each metric by benchmark
+def groupRecords(records):
+    groups = {}
+    for r in records:
+        key = (r["problem"], r["algorithm"], r["config"])
+        group = groups.setdefault(key, {metric: [] for metric in METRICS})
+        for metric in METRICS:
+            if r.get(metric) is not None:
+                group[metric].append(float(r[metric]))
+    return groups
+
+# Returns the difference of the means (new - base) and the half-width of its 95% confidence interval
+def meanDiffCI(base, new):
+    diff = statistics.mean(new) - statistics.mean(base)
+    if len(base) < 2 or len(new) < 2:
+        return diff, math.inf
+
+    vb = statistics.variance(base) / len(base)
+    vn = statistics.variance(new) / len(new)
+    se = math.sqrt(vb + vn)
+    if se == 0.0:
+        return diff, 0.0
+
+    # Welch-Satterthwaite degrees of freedom
+    df = (vb + vn) ** 2 / (vb ** 2 / (len(base) - 1) + vn ** 2 / (len(new) - 1))
+    return diff, tCritical(df) * se
+
+def main():
+    parser = argparse.ArgumentParser(description = "Compare two benchmark result files.")
+    parser.add_argument("baseline")
+    parser.add_argument("new")
+    parser.add_argument("--threshold", type = float, default = 0.05, help = "relative change flagged as a regression (default: 0.05)")
+    args = parser.parse_args()
+
+    base_groups = groupRecords(readRecords(args.baseline))
+    new_groups = groupRecords(readRecords(args.new))
+
+    num_regressions = 0
+    print(f"{'benchmark':<40} {'metric':<14} {'baseline':>12} {'new':>12} {'change':>9} {'95% CI':>18}")
+    for key in sorted(base_groups.keys() & new_groups.keys()):
+        name = f"{key[0]} {key[1]}"
+        for metric, higher_is_better in METRICS.items():
+            base = base_groups[key][metric]
+            new = new_groups[key][metric]
+            if not base or not new:
+                continue
+
+            base_mean = statistics.mean(base)
+            diff, ci = meanDiffCI(base, new)
+            scale = abs(base_mean) if base_mean != 0.0 else 1.0
+            rel_change = diff / scale
+            rel_ci = ci / scale
+
+            worse = -rel_change if higher_is_better else rel_change
+            is_regression = worse > args.threshold and abs(diff) > ci
+            num_regressions += is_regression
+
+            print(f"{name:<40} {metric:<14} {base_mean:>12.4g} {statistics.mean(new):>12.4g} {rel_change:>+8.1%} "
+                  f"{'+/- ' + format(rel_ci, '.1%'):>18}{'  REGRESSION' if is_regression else ''}")
+
+    for key in sorted(base_groups.keys() ^ new_groups.keys()):
+        print(f"{key[0]} {key[1]} ({key[2]}) is only present in one of the files.")
+
+    print(f"\n{num_regressions} regression(s) found (threshold: {args.threshold:.1%}).")
+    return 1 if num_regressions else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
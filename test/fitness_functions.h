@@ -15,6 +15,7 @@
 #include <string>
 #include <numeric>
 #include <algorithm>
+#include <chrono>
 #include <cassert>
 
 using namespace std;
@@ -301,6 +302,40 @@ public:
 };
 
 
+/*
+* Implementation of the sphere function for any number of dimensions.
+* Evaluated on x_i = [-5.12, 5.12].
+* The global optimum of the function is f(x) = 0, at x = (0, 0, ... , 0).
+*/
+class Sphere
+{
+public:
+
+    explicit Sphere(size_t num_vars = 10) : num_vars(num_vars) {}
+
+    /* For real chromosomes. */
+    vector<double> operator()(const vector<double>& x) const
+    {
+        assert(x.size() == num_vars);
+        assert(all_of(x.begin(), x.end(), [](double val) { return lbound() <= val && val <= ubound(); }));
+
+        double fx = 0.0;
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            fx += pow(x[i], 2);
+        }
+
+        return { -fx };	/* For maximization. */
+    }
+
+    size_t num_vars = 10;
+    constexpr static size_t num_obj() noexcept { return 1; }
+    constexpr static double lbound() noexcept { return -5.12; }
+    constexpr static double ubound() noexcept { return 5.12; }
+    constexpr static double optimal_value() noexcept { return 0.0; }
+    constexpr static double optimal_x() noexcept { return 0.0; }
+};
+
 /* Multi-objective fitness functions. */
 
 /*
@@ -580,6 +615,37 @@ private:
     }
 };
 
+/*
+* Implementation of the constraint of the C1-DTLZ1 problem, which is the DTLZ1 function with a linear constraint
+* that makes most of the objective space infeasible, except for a narrow region above the optimal front.
+* Returns the constraint violation of a solution, to be used with the DTLZ1 fitness function.
+* The optimal solutions are the same as for the DTLZ1 function: sum(f) = 0.5
+*/
+class C1DTLZ1Constraint
+{
+public:
+
+    explicit C1DTLZ1Constraint(size_t num_vars = 7, size_t num_obj = 3) : dtlz1(num_vars, num_obj) {}
+
+    double operator()(const vector<double>& x) const
+    {
+        /* The fitness values of the DTLZ1 function are negated for maximization. */
+        vector<double> fx = dtlz1(x);
+
+        double c = 1.0 + fx.back() / 0.6;
+        for (size_t i = 0; i < fx.size() - 1; i++)
+        {
+            c += fx[i] / 0.5;
+        }
+
+        return max(0.0, -c);
+    }
+
+private:
+
+    DTLZ1 dtlz1;
+};
+
 /*
 * Implementation of the DTLZ2 function for any number of dimensions and objectives.
 * Evaluated on x_i = [0.0, 1.0].
@@ -772,4 +838,32 @@ private:
     size_t num_vars_;
 };
 
+/* Wrappers. */
+
+/*
+* Wrapper around any of the fitness functions above, which busy-waits for a set amount of time in each evaluation
+* before calling the wrapped function. Used to simulate expensive fitness functions in the benchmarks.
+*/
+template<typename F>
+class SpinWork
+{
+public:
+
+    SpinWork(F f, double work_us) : f(std::move(f)), work_us(work_us) {}
+
+    template<typename T>
+    vector<double> operator()(const vector<T>& x) const
+    {
+        using Clock = chrono::steady_clock;
+
+        auto end = Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double, micro>(work_us));
+        while (Clock::now() < end) {}
+
+        return f(x);
+    }
+
+    F f;
+    double work_us;     /* The time spent in each evaluation in addition to the wrapped function (in microseconds). */
+};
+
 #endif // !FITNESS_FUNCTIONS_H
\ No newline at end of file
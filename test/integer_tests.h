@@ -38,6 +38,8 @@ void integerTest1()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = (double)duration / 1E+6;
 
+    recordResult("MatchString12", "IntegerGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << "\n\nThe best strings found are (expected: " << match.optimal_x() << "): \n";
     for (const auto& sol : sols)
@@ -80,6 +82,8 @@ void integerTest2()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = (double)duration / 1E+6;
 
+    recordResult("MatchString100", "IntegerGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << "\n\nThe best strings found are (expected: " << match.optimal_x() << "): \n";
     for (const auto& sol : sols)
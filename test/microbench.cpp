@@ -0,0 +1,292 @@
+/*
+* Micro-benchmarks of the genetic operators of each GA class, the selection methods,
+* and the utility functions of the multi-objective algorithms. \n
+* Usage: microbench [filter] [repetitions]
+*/
+
+#include "microbench.h"
+
+#include "../src/binary_ga.h"
+#include "../src/real_ga.h"
+#include "../src/integer_ga.h"
+#include "../src/permutation_ga.h"
+#include "../src/reference_points.h"
+#include "../src/rng.h"
+
+#include <vector>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <utility>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+/* Count the heap allocations. */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"    /* False positive, new uses malloc and delete uses free. */
+#endif
+
+void* operator new(size_t size)
+{
+    alloc_count.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+using namespace genetic_algorithm;
+
+/* Exposes the protected functions of the GA class used in the benchmarks. */
+struct GaInternals : public RCGA
+{
+    using RCGA::RCGA;
+
+    using RCGA::sogaCalcRouletteWeights;
+    using RCGA::sogaCalcRankWeights;
+    using RCGA::sogaCalcSigmaWeights;
+    using RCGA::sogaCalcBoltzmannWeights;
+    using RCGA::sogaWeightProportionalSelect;
+    using RCGA::sogaTournamentSelect;
+    using RCGA::nonDominatedSort;
+    using RCGA::calcCrowdingDistances;
+    using RCGA::nsga2Select;
+    using RCGA::nsga3Select;
+    using RCGA::associatePopToRefs;
+
+    /* Reset the state used by associatePopToRefs for dim objectives. */
+    void resetNsga3State(size_t dim)
+    {
+        generation_cntr_ = 0;
+        ideal_point_ = vector<double>(dim, -numeric_limits<double>::max());
+        nadir_point_ = vector<double>(dim);
+        extreme_points_ = vector<vector<double>>(dim, vector<double>(dim));
+    }
+};
+
+template<typename Candidate, typename Gen>
+Candidate randomCandidate(size_t chrom_len, Gen&& gen)
+{
+    vector<typename decltype(Candidate::chromosome)::value_type> chrom(chrom_len);
+    for (auto& gene : chrom) gene = gen();
+
+    return Candidate(move(chrom));
+}
+
+PermutationGA::Candidate randomPermutation(size_t chrom_len)
+{
+    PermutationGA::Candidate sol;
+    sol.chromosome.resize(chrom_len);
+    iota(sol.chromosome.begin(), sol.chromosome.end(), size_t{ 0 });
+    shuffle(sol.chromosome.begin(), sol.chromosome.end(), rng::prng);
+
+    return sol;
+}
+
+/* Random population with fitness vectors of size dim. */
+GaInternals::Population randomPopulation(size_t pop_size, size_t dim)
+{
+    GaInternals::Population pop(pop_size);
+    for (auto& sol : pop)
+    {
+        sol.chromosome = { 0.0 };
+        sol.fitness = vector<double>(dim);
+        for (auto& f : sol.fitness) f = rng::randomReal();
+        sol.is_evaluated = true;
+    }
+
+    return pop;
+}
+
+/* Benchmark a crossover operator with the signature CandidatePair(const Candidate&, const Candidate&). */
+template<typename Candidate, typename F>
+void benchCrossover(const string& name, size_t chrom_len, const Candidate& parent1, const Candidate& parent2, F&& crossover)
+{
+    bench(name, "len=" + to_string(chrom_len), [&]()
+    {
+        auto children = crossover(parent1, parent2);
+        bench_sink = bench_sink + children.first.chromosome.size();
+    });
+}
+
+/* Benchmark a mutation operator with the signature void(Candidate&). The same candidate is mutated repeatedly. */
+template<typename Candidate, typename F>
+void benchMutation(const string& name, size_t chrom_len, Candidate child, F&& mutate)
+{
+    bench(name, "len=" + to_string(chrom_len), [&]()
+    {
+        mutate(child);
+        bench_sink = bench_sink + child.chromosome.size();
+    });
+}
+
+void benchBinaryOperators(size_t chrom_len)
+{
+    using Candidate = BinaryGA::Candidate;
+
+    auto gen = []() { return char(rng::randomBool()); };
+    Candidate parent1 = randomCandidate<Candidate>(chrom_len, gen);
+    Candidate parent2 = randomCandidate<Candidate>(chrom_len, gen);
+    double pm = 1.0 / chrom_len;
+
+    benchCrossover("BinaryGA::single_point", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return BinaryGA::nPointCrossover(p1, p2, 1.0, 1); });
+    benchCrossover("BinaryGA::two_point", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return BinaryGA::nPointCrossover(p1, p2, 1.0, 2); });
+    benchCrossover("BinaryGA::n_point(3)", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return BinaryGA::nPointCrossover(p1, p2, 1.0, 3); });
+    benchCrossover("BinaryGA::uniform", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return BinaryGA::uniformCrossover(p1, p2, 1.0); });
+
+    benchMutation("BinaryGA::standard_mutation", chrom_len, parent1, [pm](Candidate& c) { BinaryGA::standardMutate(c, pm); });
+}
+
+void benchRealOperators(size_t chrom_len)
+{
+    using Candidate = RCGA::Candidate;
+
+    RCGA::limits_t bounds(chrom_len, { -5.0, 5.0 });
+    auto gen = []() { return rng::randomReal(-5.0, 5.0); };
+    Candidate parent1 = randomCandidate<Candidate>(chrom_len, gen);
+    Candidate parent2 = randomCandidate<Candidate>(chrom_len, gen);
+    double pm = 1.0 / chrom_len;
+
+    benchCrossover("RCGA::arithmetic", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return RCGA::arithmeticCrossover(p1, p2, 1.0); });
+    benchCrossover("RCGA::blx_a", chrom_len, parent1, parent2, [&](const Candidate& p1, const Candidate& p2) { return RCGA::blxAlphaCrossover(p1, p2, 1.0, 0.5, bounds); });
+    benchCrossover("RCGA::simulated_binary", chrom_len, parent1, parent2, [&](const Candidate& p1, const Candidate& p2) { return RCGA::simulatedBinaryCrossover(p1, p2, 1.0, 4.0, bounds); });
+    benchCrossover("RCGA::wright", chrom_len, parent1, parent2, [&](const Candidate& p1, const Candidate& p2) { return RCGA::wrightCrossover(p1, p2, 1.0, bounds); });
+
+    benchMutation("RCGA::random_mutation", chrom_len, parent1, [&](Candidate& c) { RCGA::randomMutate(c, pm, bounds); });
+    benchMutation("RCGA::nonuniform_mutation", chrom_len, parent1, [&](Candidate& c) { RCGA::nonuniformMutate(c, pm, 100, 500, 2.0, bounds); });
+    benchMutation("RCGA::polynomial_mutation", chrom_len, parent1, [&](Candidate& c) { RCGA::polynomialMutate(c, pm, 40.0, bounds); });
+    benchMutation("RCGA::boundary_mutation", chrom_len, parent1, [&](Candidate& c) { RCGA::boundaryMutate(c, pm, bounds); });
+    benchMutation("RCGA::gauss_mutation", chrom_len, parent1, [&](Candidate& c) { RCGA::gaussMutate(c, pm, 6.0, bounds); });
+}
+
+void benchIntegerOperators(size_t chrom_len)
+{
+    using Candidate = IntegerGA::Candidate;
+
+    size_t base = 26;
+    auto gen = [base]() { return rng::randomInt(size_t{ 0 }, base - 1); };
+    Candidate parent1 = randomCandidate<Candidate>(chrom_len, gen);
+    Candidate parent2 = randomCandidate<Candidate>(chrom_len, gen);
+    double pm = 1.0 / chrom_len;
+
+    benchCrossover("IntegerGA::single_point", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return IntegerGA::nPointCrossover(p1, p2, 1.0, 1); });
+    benchCrossover("IntegerGA::two_point", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return IntegerGA::nPointCrossover(p1, p2, 1.0, 2); });
+    benchCrossover("IntegerGA::n_point(3)", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return IntegerGA::nPointCrossover(p1, p2, 1.0, 3); });
+    benchCrossover("IntegerGA::uniform", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return IntegerGA::uniformCrossover(p1, p2, 1.0); });
+
+    benchMutation("IntegerGA::standard_mutation", chrom_len, parent1, [pm, base](Candidate& c) { IntegerGA::standardMutate(c, pm, 0.1, 0.1, base); });
+}
+
+void benchPermutationOperators(size_t chrom_len)
+{
+    using Candidate = PermutationGA::Candidate;
+
+    Candidate parent1 = randomPermutation(chrom_len);
+    Candidate parent2 = randomPermutation(chrom_len);
+
+    benchCrossover("PermutationGA::order", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return PermutationGA::orderCrossover(p1, p2, 1.0); });
+    benchCrossover("PermutationGA::cycle", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return PermutationGA::cycleCrossover(p1, p2, 1.0); });
+    benchCrossover("PermutationGA::edge", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return PermutationGA::edgeCrossover(p1, p2, 1.0); });
+    benchCrossover("PermutationGA::pmx", chrom_len, parent1, parent2, [](const Candidate& p1, const Candidate& p2) { return PermutationGA::pmxCrossover(p1, p2, 1.0); });
+
+    benchMutation("PermutationGA::swap_mutation", chrom_len, parent1, [](Candidate& c) { PermutationGA::swapMutate(c, 1.0); });
+    benchMutation("PermutationGA::scramble_mutation", chrom_len, parent1, [](Candidate& c) { PermutationGA::scrambleMutate(c, 1.0); });
+    benchMutation("PermutationGA::inversion_mutation", chrom_len, parent1, [](Candidate& c) { PermutationGA::inversionMutate(c, 1.0); });
+}
+
+void benchSelections(size_t pop_size)
+{
+    using Population = GaInternals::Population;
+
+    string params = "pop=" + to_string(pop_size);
+    Population pop = randomPopulation(pop_size, 1);
+
+    /* The selection weights are calculated once per generation, the selections are made pop_size times per generation. */
+    bench("soga::roulette_weights", params, [&]() { GaInternals::sogaCalcRouletteWeights(pop); });
+    bench("soga::rank_weights", params, [&]() { GaInternals::sogaCalcRankWeights(pop); });
+    bench("soga::sigma_weights", params, [&]() { GaInternals::sogaCalcSigmaWeights(pop); });
+    bench("soga::boltzmann_weights", params, [&]() { GaInternals::sogaCalcBoltzmannWeights(pop, 10, 100, 0.25, 4.0); });
+
+    GaInternals::sogaCalcRankWeights(pop);
+    bench("soga::weight_proportional_select", params, [&]()
+    {
+        bench_sink = bench_sink + GaInternals::sogaWeightProportionalSelect(pop).chromosome.size();
+    });
+    bench("soga::tournament_select(2)", params, [&]()
+    {
+        bench_sink = bench_sink + GaInternals::sogaTournamentSelect(pop, 2).chromosome.size();
+    });
+
+    Population mo_pop = randomPopulation(pop_size, 3);
+    GaInternals::nonDominatedSort(mo_pop);
+    bench("nsga2::select", params, [&]()
+    {
+        bench_sink = bench_sink + GaInternals::nsga2Select(mo_pop).chromosome.size();
+    });
+    bench("nsga3::select", params, [&]()
+    {
+        bench_sink = bench_sink + GaInternals::nsga3Select(mo_pop).chromosome.size();
+    });
+}
+
+void benchMoUtils(size_t pop_size, size_t dim)
+{
+    using Population = GaInternals::Population;
+
+    string params = "pop=" + to_string(pop_size) + " M=" + to_string(dim);
+    Population pop = randomPopulation(pop_size, dim);
+
+    bench("nonDominatedSort", params, [&]()
+    {
+        bench_sink = bench_sink + GaInternals::nonDominatedSort(pop).size();
+    });
+
+    auto pfronts = GaInternals::nonDominatedSort(pop);
+    bench("calcCrowdingDistances", params, [&]()
+    {
+        GaInternals::calcCrowdingDistances(pop, pfronts);
+    });
+
+    GaInternals ga(1, [](const vector<double>&) { return vector<double>{}; }, { { 0.0, 1.0 } });
+    detail::ObjectiveMatrix refs(detail::generateRefPoints(pop_size, dim, detail::RefPointMethod::das_dennis));
+    bench("associatePopToRefs", params, [&]()
+    {
+        ga.resetNsga3State(dim);
+        ga.associatePopToRefs(pop, refs);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1) bench_settings.filter = argv[1];
+    if (argc > 2) bench_settings.repetitions = max(size_t(atoi(argv[2])), size_t{ 1 });
+
+    printBenchHeader();
+
+    for (size_t chrom_len : { 10, 100, 1000 })
+    {
+        benchBinaryOperators(chrom_len);
+        benchRealOperators(chrom_len);
+        benchIntegerOperators(chrom_len);
+        benchPermutationOperators(chrom_len);
+    }
+
+    for (size_t pop_size : { 100, 1000 })
+    {
+        benchSelections(pop_size);
+    }
+
+    for (size_t pop_size : { 100, 1000 })
+    {
+        for (size_t dim : { 2, 3, 5 })
+        {
+            benchMoUtils(pop_size, dim);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+/* A minimal framework for the micro-benchmarks of the genetic operators and the utility functions. */
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+
+using namespace std;
+
+/* The number of heap allocations made so far. Counted by the replacement operator new in microbench.cpp. */
+inline atomic<size_t> alloc_count = 0;
+
+/* Used to make sure the results of the benchmarked functions aren't optimized away. */
+inline volatile size_t bench_sink = 0;
+
+/* The results of a single benchmark. */
+struct BenchResult
+{
+    string name;
+    string params;
+    vector<double> ns_per_op;   /* The time per operation in each repetition. */
+    double allocs_per_op = 0.0;
+
+    double median() const
+    {
+        vector<double> sorted = ns_per_op;
+        sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+
+        return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+    }
+
+    double mean() const
+    {
+        return accumulate(ns_per_op.begin(), ns_per_op.end(), 0.0) / ns_per_op.size();
+    }
+
+    double sd() const
+    {
+        if (ns_per_op.size() < 2) return 0.0;
+
+        double m = mean();
+        double var = 0.0;
+        for (double t : ns_per_op) var += (t - m) * (t - m);
+
+        return sqrt(var / (ns_per_op.size() - 1));
+    }
+};
+
+/* The settings of the benchmark runs. */
+struct BenchSettings
+{
+    size_t repetitions = 10;            /* The number of timed repetitions of each benchmark. */
+    double min_rep_time = 0.01;         /* The minimum duration of a repetition in seconds, the number of operations per repetition is chosen based on this. */
+    string filter;                      /* Only run the benchmarks whose name contains this string. */
+};
+
+inline BenchSettings bench_settings;
+inline vector<BenchResult> bench_results;
+
+/* Print the header of the results table. */
+void printBenchHeader()
+{
+    cout << left << setw(44) << "benchmark" << setw(22) << "params"
+         << right << setw(14) << "ns/op" << setw(10) << "+/- sd" << setw(12) << "allocs/op" << "\n";
+    cout << string(102, '-') << "\n";
+}
+
+void printBenchResult(const BenchResult& result)
+{
+    cout << left << setw(44) << result.name << setw(22) << result.params << right << fixed
+         << setprecision(1) << setw(14) << result.median() << setw(10) << result.sd()
+         << setprecision(2) << setw(12) << result.allocs_per_op << "\n";
+}
+
+/*
+* Measure the time it takes to call op(), and the number of heap allocations made by it. \n
+* The number of calls per repetition is increased until a repetition takes at least min_rep_time,
+* then the timed repetitions are run. The median time of the repetitions is reported.
+*/
+template<typename F>
+void bench(const string& name, const string& params, F&& op)
+{
+    if (!bench_settings.filter.empty() && name.find(bench_settings.filter) == string::npos) return;
+
+    using Clock = chrono::steady_clock;
+
+    auto timeOps = [&op](size_t n) -> double
+    {
+        auto tbegin = Clock::now();
+        for (size_t i = 0; i < n; i++) op();
+        auto tend = Clock::now();
+
+        return chrono::duration<double>(tend - tbegin).count();
+    };
+
+    /* Calibration, this also serves as the warmup. */
+    size_t ops_per_rep = 1;
+    while (timeOps(ops_per_rep) < bench_settings.min_rep_time && ops_per_rep < (size_t{ 1 } << 30))
+    {
+        ops_per_rep *= 2;
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.params = params;
+
+    result.ns_per_op.reserve(bench_settings.repetitions);
+
+    size_t allocs_before = alloc_count.load();
+    for (size_t rep = 0; rep < bench_settings.repetitions; rep++)
+    {
+        result.ns_per_op.push_back(1E+9 * timeOps(ops_per_rep) / ops_per_rep);
+    }
+    size_t allocs = alloc_count.load() - allocs_before;
+
+    result.allocs_per_op = double(allocs) / (ops_per_rep * bench_settings.repetitions);
+
+    printBenchResult(result);
+    bench_results.push_back(move(result));
+}
+
+#endif // !MICROBENCH_H
@@ -0,0 +1,279 @@
+/*
+* Quality indicators for the results of the multi-objective algorithms (IGD, GD, hypervolume),
+* and the optimal Pareto fronts of the multi-objective test problems in fitness_functions.h. \n
+* Everything is in the maximization form used by the fitness functions (the objectives are negated).
+*/
+
+#ifndef MO_METRICS_H
+#define MO_METRICS_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+
+#include "../src/reference_points.h"
+#include "../src/hypervolume.h"
+#include "../src/rng.h"
+#include "fitness_functions.h"
+
+using namespace std;
+using namespace genetic_algorithm;
+
+using Front = vector<vector<double>>;
+
+/* Returns true if lhs dominates rhs (assuming maximization). */
+bool dominates(const vector<double>& lhs, const vector<double>& rhs)
+{
+    bool better = false;
+    for (size_t i = 0; i < lhs.size(); i++)
+    {
+        if (lhs[i] < rhs[i]) return false;
+        if (lhs[i] > rhs[i]) better = true;
+    }
+
+    return better;
+}
+
+/* Returns the non-dominated points of the set. */
+Front nonDominatedPoints(const Front& points)
+{
+    Front front;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        bool is_dominated = any_of(points.begin(), points.end(), [&](const vector<double>& p) { return dominates(p, points[i]); });
+        if (!is_dominated) front.push_back(points[i]);
+    }
+
+    return front;
+}
+
+/* Returns the non-dominated points of a set of 2D points in O(nlogn) time. */
+Front nonDominatedPoints2D(Front points)
+{
+    sort(points.begin(), points.end(), [](const vector<double>& lhs, const vector<double>& rhs)
+    {
+        return lhs[0] > rhs[0] || (lhs[0] == rhs[0] && lhs[1] > rhs[1]);
+    });
+
+    Front front;
+    double best_f2 = -numeric_limits<double>::infinity();
+    for (const auto& p : points)
+    {
+        if (p[1] > best_f2)
+        {
+            front.push_back(p);
+            best_f2 = p[1];
+        }
+    }
+
+    return front;
+}
+
+double euclideanDistance(const vector<double>& lhs, const vector<double>& rhs)
+{
+    double d = 0.0;
+    for (size_t i = 0; i < lhs.size(); i++) d += (lhs[i] - rhs[i]) * (lhs[i] - rhs[i]);
+
+    return sqrt(d);
+}
+
+double minDistance(const vector<double>& point, const Front& set)
+{
+    double dmin = numeric_limits<double>::infinity();
+    for (const auto& p : set) dmin = min(dmin, euclideanDistance(point, p));
+
+    return dmin;
+}
+
+/* Inverted generational distance: the mean distance from the points of the optimal front to the closest point of the approximation. */
+double igd(const Front& approx, const Front& optimal_front)
+{
+    if (approx.empty()) return numeric_limits<double>::infinity();
+
+    double sum = 0.0;
+    for (const auto& p : optimal_front) sum += minDistance(p, approx);
+
+    return sum / optimal_front.size();
+}
+
+/* Generational distance: the mean distance from the points of the approximation to the closest point of the optimal front. */
+double gd(const Front& approx, const Front& optimal_front)
+{
+    if (approx.empty()) return numeric_limits<double>::infinity();
+
+    double sum = 0.0;
+    for (const auto& p : approx) sum += minDistance(p, optimal_front);
+
+    return sum / approx.size();
+}
+
+/*
+* The hypervolume of the region dominated by the points and bounded by the reference point (assuming maximization). \n
+* Exact for at most 8 objectives, estimated with Monte Carlo sampling for more objectives.
+* The points which don't dominate the reference point are ignored.
+*/
+double hypervolume(const Front& points, const vector<double>& ref)
+{
+    return detail::hypervolume(points, ref);
+}
+
+/* The optimal fronts of the test problems, sampled with n points (in the maximization form). */
+
+Front zdt2Front(size_t n = 1000)
+{
+    Front front;
+    for (size_t i = 0; i < n; i++)
+    {
+        double f1 = double(i) / (n - 1);
+        front.push_back({ -f1, -(1.0 - f1 * f1) });
+    }
+
+    return front;
+}
+
+Front zdt3Front(size_t n = 1000)
+{
+    /* The front is disconnected, so a denser sampling of the curve is filtered. */
+    Front curve;
+    for (size_t i = 0; i < 20 * n; i++)
+    {
+        double f1 = double(i) / (20 * n - 1);
+        curve.push_back({ -f1, -(1.0 - sqrt(f1) - f1 * sin(10.0 * PI * f1)) });
+    }
+    Front front = nonDominatedPoints2D(curve);
+
+    /* Keep about n points. */
+    Front sampled;
+    size_t step = max(front.size() / n, size_t{ 1 });
+    for (size_t i = 0; i < front.size(); i += step) sampled.push_back(front[i]);
+
+    return sampled;
+}
+
+Front zdt6Front(size_t n = 1000)
+{
+    const double f1_min = 0.2807753191;
+
+    Front front;
+    for (size_t i = 0; i < n; i++)
+    {
+        double f1 = f1_min + (1.0 - f1_min) * double(i) / (n - 1);
+        front.push_back({ -f1, -(1.0 - f1 * f1) });
+    }
+
+    return front;
+}
+
+/*
+* The front of the KUR problem has no closed form, it is approximated numerically: the function is evaluated on a grid,
+* then points are sampled repeatedly around the non-dominated points with a decreasing step size.
+*/
+Front kurFront()
+{
+    static Front front;
+    if (!front.empty()) return front;
+
+    KUR kur(3);
+
+    /* The decision vectors, with the fitness vectors appended to them. */
+    vector<vector<double>> points;
+    auto addPoint = [&](vector<double> x)
+    {
+        vector<double> f = kur(x);
+        x.insert(x.end(), f.begin(), f.end());
+        points.push_back(move(x));
+    };
+    auto filterPoints = [&]()
+    {
+        sort(points.begin(), points.end(), [](const vector<double>& lhs, const vector<double>& rhs)
+        {
+            return lhs[3] > rhs[3] || (lhs[3] == rhs[3] && lhs[4] > rhs[4]);
+        });
+        vector<vector<double>> nondominated;
+        double best_f2 = -numeric_limits<double>::infinity();
+        for (auto& p : points)
+        {
+            if (p[4] > best_f2)
+            {
+                best_f2 = p[4];
+                nondominated.push_back(move(p));
+            }
+        }
+        points = move(nondominated);
+    };
+
+    const size_t grid_size = 61;
+    double step = kur.intval() / (grid_size - 1);
+    for (size_t i = 0; i < grid_size * grid_size * grid_size; i++)
+    {
+        addPoint({ kur.lbound() + step * (i % grid_size),
+                   kur.lbound() + step * (i / grid_size % grid_size),
+                   kur.lbound() + step * (i / grid_size / grid_size) });
+    }
+    filterPoints();
+
+    for (size_t round = 0; round < 6; round++)
+    {
+        vector<vector<double>> centers = points;
+        size_t samples_per_center = max(size_t{ 200000 } / centers.size(), size_t{ 1 });
+        for (const auto& center : centers)
+        {
+            for (size_t n = 0; n < samples_per_center; n++)
+            {
+                vector<double> x(3);
+                for (size_t i = 0; i < 3; i++)
+                {
+                    x[i] = clamp(center[i] + rng::randomReal(-step, step), kur.lbound(), kur.ubound());
+                }
+                addPoint(move(x));
+            }
+        }
+        filterPoints();
+        step /= 2.0;
+    }
+
+    /* Keep about 1000 points. */
+    size_t stride = max(points.size() / 1000, size_t{ 1 });
+    for (size_t i = 0; i < points.size(); i += stride) front.push_back({ points[i][3], points[i][4] });
+
+    return front;
+}
+
+Front dtlz1Front(size_t num_obj = 3, size_t divisions = 40)
+{
+    Front front = detail::generateDasDennisRefPoints(divisions, num_obj);
+    for (auto& p : front)
+    {
+        for (auto& f : p) f *= -0.5;
+    }
+
+    return front;
+}
+
+Front dtlz2Front(size_t num_obj = 3, size_t divisions = 40)
+{
+    Front front = detail::generateDasDennisRefPoints(divisions, num_obj);
+    for (auto& p : front)
+    {
+        double norm = sqrt(inner_product(p.begin(), p.end(), p.begin(), 0.0));
+        for (auto& f : p) f *= -1.0 / norm;
+    }
+
+    return front;
+}
+
+/* Returns the fitness vectors of the candidates. */
+template<typename CandidateVec>
+Front fitnessVectors(const CandidateVec& sols)
+{
+    Front points;
+    points.reserve(sols.size());
+    for (const auto& sol : sols) points.push_back(vector<double>(sol.fitness.begin(), sol.fitness.end()));
+
+    return points;
+}
+
+#endif // !MO_METRICS_H
@@ -0,0 +1,141 @@
+/*
+* Benchmarks measuring the quality of the solutions of the multi-objective algorithms over time. \n
+* The IGD, GD and hypervolume of the non-dominated solutions of the population are recorded at regular intervals
+* during the runs, against both the wall time and the number of fitness evaluations, and written as time series to
+* test/mo_results/<algorithm>_<problem>_quality.csv for plotting.
+*/
+
+#ifndef MO_QUALITY_TESTS_H
+#define MO_QUALITY_TESTS_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+
+#include "../src/real_ga.h"
+#include "fitness_functions.h"
+#include "mo_metrics.h"
+
+using namespace std;
+using namespace genetic_algorithm;
+
+/* A single point of the quality time series. */
+struct QualitySample
+{
+    size_t generation;
+    size_t fitness_evals;
+    double time;        /* The time spent in the algorithm so far, without the time spent computing the metrics (in seconds). */
+    double igd;
+    double gd;
+    double hypervolume;
+};
+
+/* Run the GA, sampling the quality of the population in every interval-th generation. */
+vector<QualitySample> runQualityTest(RCGA& GA, const Front& optimal_front, const vector<double>& hv_ref, size_t interval)
+{
+    using Clock = chrono::steady_clock;
+
+    vector<QualitySample> samples;
+    Clock::time_point tbegin;
+    Clock::duration metric_time{};
+
+    auto sample = [&](const RCGA& ga, size_t generation)
+    {
+        auto tsample = Clock::now();
+        double time_spent = chrono::duration<double>(tsample - tbegin - metric_time).count();
+
+        Front front = nonDominatedPoints(fitnessVectors(ga.population()));
+        samples.push_back({ generation, ga.num_fitness_evals(), time_spent,
+                            igd(front, optimal_front), gd(front, optimal_front), hypervolume(front, hv_ref) });
+
+        metric_time += Clock::now() - tsample;
+    };
+
+    /* The callback is called before the generation counter is incremented. */
+    GA.endOfGenerationCallback = [&](const auto*)
+    {
+        if ((GA.generation_cntr() + 1) % interval == 0) sample(GA, GA.generation_cntr() + 1);
+    };
+
+    tbegin = Clock::now();
+    GA.run();
+    GA.endOfGenerationCallback = nullptr;
+
+    if (samples.empty() || samples.back().generation != GA.generation_cntr()) sample(GA, GA.generation_cntr());
+
+    return samples;
+}
+
+void writeQualitySamples(const vector<QualitySample>& samples, const string& fname)
+{
+    ofstream file(fname);
+    file << "generation,fitness_evals,time,igd,gd,hypervolume\n";
+    file << setprecision(8);
+    for (const auto& s : samples)
+    {
+        file << s.generation << "," << s.fitness_evals << "," << s.time << "," << s.igd << "," << s.gd << "," << s.hypervolume << "\n";
+    }
+}
+
+/* Settings of the 2 objective problems, the same as in the nsga2/nsga3 tests. */
+template<typename F>
+void moQualityTest2D(const string& problem, F fitness_f, RCGA::Mode mode, const Front& optimal_front, const vector<double>& hv_ref)
+{
+    RCGA GA(fitness_f.num_vars, fitness_f, RCGA::limits_t(fitness_f.num_vars, { fitness_f.lbound(), fitness_f.ubound() }));
+    GA.mode(mode);
+    GA.population_size(100);
+    GA.crossover_rate(0.8);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.mutation_method(RCGA::MutationMethod::gauss);
+    GA.max_gen(250);
+
+    string algorithm = (mode == RCGA::Mode::multi_objective_sorting) ? "nsga2" : "nsga3";
+    auto samples = runQualityTest(GA, optimal_front, hv_ref, 5);
+    writeQualitySamples(samples, "test/mo_results/" + algorithm + "_" + problem + "_quality.csv");
+
+    cout << setprecision(4) << algorithm << " " << problem << ": IGD = " << samples.back().igd << ", GD = " << samples.back().gd
+         << ", HV = " << samples.back().hypervolume << " after " << samples.back().time << " s\n";
+}
+
+/* Settings of the DTLZ problems, the same as in the nsga2/nsga3 tests. */
+template<typename F>
+void moQualityTestDtlz(const string& problem, F fitness_f, RCGA::Mode mode, const Front& optimal_front, const vector<double>& hv_ref)
+{
+    RCGA GA(fitness_f.num_vars, fitness_f, RCGA::limits_t(fitness_f.num_vars, { fitness_f.lbound(), fitness_f.ubound() }));
+    GA.mode(mode);
+    GA.population_size(100);
+    GA.crossover_rate(0.9);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.sim_binary_crossover_param(15.0);
+    GA.mutation_method(RCGA::MutationMethod::random);
+    GA.max_gen(1500);
+
+    string algorithm = (mode == RCGA::Mode::multi_objective_sorting) ? "nsga2" : "nsga3";
+    auto samples = runQualityTest(GA, optimal_front, hv_ref, 25);
+    writeQualitySamples(samples, "test/mo_results/" + algorithm + "_" + problem + "_quality.csv");
+
+    cout << setprecision(4) << algorithm << " " << problem << ": IGD = " << samples.back().igd << ", GD = " << samples.back().gd
+         << ", HV = " << samples.back().hypervolume << " after " << samples.back().time << " s\n";
+}
+
+void moQualityTests()
+{
+    cout << "\n\nMeasuring the quality of the multi-objective algorithms over time...\n";
+
+    for (auto mode : { RCGA::Mode::multi_objective_sorting, RCGA::Mode::multi_objective_decomp })
+    {
+        moQualityTest2D("kur", KUR(3), mode, kurFront(), { 14.0, -1.0 });
+        moQualityTest2D("zdt2", ZDT2(30), mode, zdt2Front(), { -1.1, -1.1 });
+        moQualityTest2D("zdt3", ZDT3(30), mode, zdt3Front(), { -1.1, -1.1 });
+        moQualityTest2D("zdt6", ZDT6(10), mode, zdt6Front(), { -1.1, -1.1 });
+
+        moQualityTestDtlz("dtlz1", DTLZ1(7, 3), mode, dtlz1Front(3), { -0.6, -0.6, -0.6 });
+        moQualityTestDtlz("dtlz2", DTLZ2(12, 3), mode, dtlz2Front(3), { -1.1, -1.1, -1.1 });
+    }
+}
+
+#endif // !MO_QUALITY_TESTS_H
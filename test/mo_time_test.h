@@ -0,0 +1,101 @@
+/* Functions for measuring the speed of the multi-objective utility functions. */
+
+#ifndef MO_TIME_TEST_H
+#define MO_TIME_TEST_H
+
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstddef>
+
+#include "../src/mo_detail.h"
+#include "../src/reference_points.h"
+#include "../src/rng.h"
+
+using namespace std;
+using namespace genetic_algorithm;
+
+/* Time the pairwise pareto comparisons and ref point associations using nested vectors and the flat matrix kernels. */
+template<size_t M>
+void timeMoKernels(size_t dim, size_t num_points = 1000, size_t num_runs = 20)
+{
+    vector<vector<double>> points(num_points, vector<double>(dim));
+    for (auto& point : points)
+    {
+        for (auto& f : point) f = rng::randomReal();
+    }
+    vector<vector<double>> refs = detail::generateRefPoints(100, dim, detail::RefPointMethod::das_dennis);
+
+    detail::ObjectiveMatrix fmat(points);
+    detail::ObjectiveMatrix rmat(refs);
+
+    auto time = [num_runs](auto&& f) -> double
+    {
+        auto tbegin = chrono::high_resolution_clock::now();
+        for (size_t run = 0; run < num_runs; run++) f();
+        auto tend = chrono::high_resolution_clock::now();
+
+        return chrono::duration<double, micro>(tend - tbegin).count() / num_runs;
+    };
+
+    /* The sink values make sure the work isn't optimized away. */
+    volatile size_t sink = 0;
+
+    double sort_vec = time([&]()
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                if (detail::paretoCompare(points[j], points[i])) count++;
+                else if (detail::paretoCompare(points[i], points[j])) count++;
+            }
+        }
+        sink = sink + count;
+    });
+    double sort_flat = time([&]()
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < fmat.nrows(); i++)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                count += (detail::paretoCompareThreeWay<M>(fmat[i], fmat[j], dim) != 0);
+            }
+        }
+        sink = sink + count;
+    });
+
+    double assoc_vec = time([&]()
+    {
+        size_t sum = 0;
+        for (const auto& point : points) sum += detail::findClosestRef(refs, point).first;
+        sink = sink + sum;
+    });
+    double assoc_flat = time([&]()
+    {
+        size_t sum = 0;
+        for (size_t i = 0; i < fmat.nrows(); i++) sum += detail::findClosestRef<M>(rmat, fmat[i]).first;
+        sink = sink + sum;
+    });
+
+    cout << fixed << setprecision(1);
+    cout << "M = " << dim << (M == detail::DYNAMIC_DIM ? " (dynamic)" : "") << "\n";
+    cout << "  pareto compare: " << sort_vec << " us (vector) vs " << sort_flat << " us (flat)\n";
+    cout << "  ref association: " << assoc_vec << " us (vector) vs " << assoc_flat << " us (flat)\n";
+}
+
+void timeMoKernels()
+{
+    cout << "\n\nTiming the multi-objective kernels...\n";
+
+    timeMoKernels<2>(2);
+    timeMoKernels<3>(3);
+    timeMoKernels<4>(4);
+    timeMoKernels<8>(8);
+    timeMoKernels<detail::DYNAMIC_DIM>(6);
+}
+
+#endif // !MO_TIME_TEST_H
@@ -14,6 +14,7 @@
 #include "../src/real_ga.h"
 #include "fitness_functions.h"
 #include "utils.h"
+#include "mo_metrics.h"
 
 using namespace std;
 using namespace genetic_algorithm;
@@ -44,6 +45,8 @@ void nsga3KurTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("KUR", "NSGA-III", GA, sols, time_spent, igd(fitnessVectors(sols), kurFront()));
+
     /* Print the results. */
     cout << "\n\nNumber of optimal solutions found for the KUR problem with the NSGA-III: " << sols.size() << "\n";
     cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
@@ -79,6 +82,8 @@ void nsga3Zdt2Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("ZDT2", "NSGA-III", GA, sols, time_spent, igd(fitnessVectors(sols), zdt2Front()));
+
     /* Print the results. */
     cout << "\n\nNumber of optimal solutions found for the ZDT2 problem with the NSGA-III: " << sols.size() << "\n";
     cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
@@ -114,6 +119,8 @@ void nsga3Zdt3Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("ZDT3", "NSGA-III", GA, sols, time_spent, igd(fitnessVectors(sols), zdt3Front()));
+
     /* Print the results. */
     cout << "\n\nNumber of optimal solutions found for the ZDT3 problem with the NSGA-III: " << sols.size() << "\n";
     cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
@@ -149,6 +156,8 @@ void nsga3Zdt6Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("ZDT6", "NSGA-III", GA, sols, time_spent, igd(fitnessVectors(sols), zdt6Front()));
+
     /* Print the results. */
     cout << "\n\nNumber of optimal solutions found for the ZDT6 problem with the NSGA-III: " << sols.size() << "\n";
     cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
@@ -185,6 +194,8 @@ void nsga3Dtlz1Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("DTLZ1", "NSGA-III", GA, sols, time_spent, igd(fitnessVectors(sols), dtlz1Front(3)));
+
     /* Print the results. */
     cout << "\n\nNumber of optimal solutions found for the DTLZ1 problem with the NSGA-III: " << sols.size() << "\n";
     cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
@@ -221,6 +232,8 @@ void nsga3Dtlz2Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("DTLZ2", "NSGA-III", GA, sols, time_spent, igd(fitnessVectors(sols), dtlz2Front(3)));
+
     /* Print the results. */
     cout << "\n\nNumber of optimal solutions found for the DTLZ2 problem with the NSGA-III: " << sols.size() << "\n";
     cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
@@ -231,4 +244,43 @@ void nsga3Dtlz2Test()
     writeResultsToFile(sols, "test/mo_results/nsga3_dtlz2_sols.txt");
 }
 
+void nsga3C1Dtlz1Test()
+{
+    /* Init GA. */
+    DTLZ1 dtlz1Function(7, 3);
+    pair<double, double> limit = { dtlz1Function.lbound(), dtlz1Function.ubound() };
+    vector<pair<double, double>> limits(dtlz1Function.num_vars, limit);
+
+    RCGA GA(dtlz1Function.num_vars, dtlz1Function, limits);
+    GA.mode(RCGA::Mode::multi_objective_decomp);
+    GA.constraintFunction = C1DTLZ1Constraint(dtlz1Function.num_vars, 3);
+
+    /* Set some optional parameters. */
+    GA.population_size(100);
+    GA.crossover_rate(0.9);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.sim_binary_crossover_param(15.0);
+    GA.mutation_method(RCGA::MutationMethod::random);
+    GA.max_gen(1500);
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    /* The optimal front of the C1-DTLZ1 problem is the same as the front of the DTLZ1 problem. */
+    recordResult("C1-DTLZ1", "NSGA-III", GA, sols, time_spent, igd(fitnessVectors(sols), dtlz1Front(3)));
+
+    /* Print the results. */
+    cout << "\n\nNumber of optimal solutions found for the C1-DTLZ1 problem with the NSGA-III: " << sols.size() << "\n";
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
+    cout << "Time taken: " << setprecision(4) << time_spent << " s\n\n";
+
+    /* Write solution fitness values to file for plotting. */
+    writeResultsToFile(sols, "test/mo_results/nsga3_c1dtlz1_sols.txt");
+}
+
 #endif // !NSGA3_TESTS_H
\ No newline at end of file
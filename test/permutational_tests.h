@@ -40,6 +40,8 @@ void perm52Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("TSP52", "PermutationGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << "\n\nThe number of optimal sols found for the TSP52: " << sols.size() << "\n";
     cout << "The length of the shortest route found: " << -sols[0].fitness[0] << " (best is " << -tsp52.optimal_value() << ").\n";
@@ -74,6 +76,8 @@ void perm124Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("TSP124", "PermutationGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << "\n\nThe number of optimal sols found for the TSP124: " << sols.size() << "\n";
     cout << "The length of the shortest route found: " << -sols[0].fitness[0] << " (best is " << -tsp124.optimal_value() << ").\n";
@@ -108,6 +112,8 @@ void perm226Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("TSP226", "PermutationGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << "\n\nThe number of optimal sols found for the TSP226: " << sols.size() << "\n";
     cout << "The length of the shortest route found: " << -sols[0].fitness[0] << " (best is " << -tsp226.optimal_value() << ").\n";
@@ -142,6 +148,8 @@ void perm439Test()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("TSP439", "PermutationGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << "\n\nThe number of optimal sols found for the TSP439: " << sols.size() << "\n";
     cout << "The length of the shortest route found: " << -sols[0].fitness[0] << " (best is " << -tsp439.optimal_value() << ").\n";
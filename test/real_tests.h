@@ -4,10 +4,12 @@
 #define REAL_TESTS_H
 
 #include <vector>
+#include <string>
 #include <utility>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <numeric>
 
 #include "../src/real_ga.h"
 #include "fitness_functions.h"
@@ -47,6 +49,8 @@ void realRastriginTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Rastrigin", "RCGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Rastrigin function is at (best is all " << rastriginFunction.optimal_x() << "): \n";
@@ -95,6 +99,8 @@ void realRosenbrockTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Rosenbrock", "RCGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Rosenbrock function is at (best is all " << rosenbrockFunction.optimal_x() << "): \n";
@@ -144,6 +150,8 @@ void realSchwefelTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Schwefel", "RCGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Schwefel function is at (best is all " << schwefelFunction.optimal_x() << "): \n";
@@ -190,6 +198,8 @@ void realGriewankTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Griewank", "RCGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Griewank function is at (best is all " << griewankFunction.optimal_x() << "): \n";
@@ -240,6 +250,8 @@ void realAckleyTest()
     auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
     double time_spent = double(duration) / 1E+6;
 
+    recordResult("Ackley", "RCGA", GA, sols, time_spent);
+
     /* Print the results. */
     cout << setprecision(4);
     cout << "\n\nThe optimum of the Ackley function is at (best is all " << ackleyFunction.optimal_x() << "): \n";
@@ -259,4 +271,313 @@ void realAckleyTest()
     //displayStats(GA.soga_history());
 }
 
+void realRastriginSurrogateTest()
+{
+    /* Init GA. */
+    Rastrigin rastriginFunction(10);
+
+    pair<double, double> limit = { rastriginFunction.lbound(), rastriginFunction.ubound() };
+    vector<pair<double, double>> limits(rastriginFunction.num_vars, limit);
+
+    RCGA GA(rastriginFunction.num_vars, rastriginFunction, limits);
+
+    /* Set some optional parameters. Only the most promising half of the children is evaluated, based on the surrogate model. */
+    GA.population_size(100);
+    GA.crossover_rate(0.6);
+    GA.mutation_rate(0.05);
+    GA.selection_method(RCGA::SogaSelection::roulette);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.sim_binary_crossover_param(4.0);
+    GA.mutation_method(RCGA::MutationMethod::gauss);
+    GA.surrogate_eval_fraction(0.5);
+    GA.surrogate_neighbours(5);
+
+    GA.max_gen(1000);
+    GA.stop_condition(RCGA::StopCondition::fitness_value);
+    GA.fitness_threshold({ -0.01 });
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    recordResult("Rastrigin", "RCGA (surrogate)", GA, sols, time_spent);
+
+    /* Print the results. */
+    const auto& stats = GA.surrogate_stats();
+    double mean_correlation = stats.rank_correlation.empty() ? 0.0 :
+        accumulate(stats.rank_correlation.begin(), stats.rank_correlation.end(), 0.0) / stats.rank_correlation.size();
+
+    cout << setprecision(4);
+    cout << "\n\nThe Rastrigin function with surrogate screening (best is " << rastriginFunction.optimal_value() << "):\n";
+    cout << "Fitness value: " << sols[0].fitness[0] << "\n";
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << " (skipped " << stats.num_skipped_evals << ")\n";
+    cout << "Mean rank correlation of the predictions: " << mean_correlation << "\n";
+    cout << "Time taken: " << time_spent << " s\n\n";
+}
+
+void realRastriginMultiFidelityTest()
+{
+    /* Init GA. */
+    Rastrigin rastriginFunction(10);
+
+    pair<double, double> limit = { rastriginFunction.lbound(), rastriginFunction.ubound() };
+    vector<pair<double, double>> limits(rastriginFunction.num_vars, limit);
+
+    RCGA GA(rastriginFunction.num_vars, rastriginFunction, limits);
+
+    /* The low-fidelity function only uses every second variable, and scales the result up to estimate the full sum. */
+    GA.lowFidelityFunctions.push_back([](const vector<double>& x)
+    {
+        double fx = 0.0;
+        for (size_t i = 0; i < x.size(); i += 2)
+        {
+            fx += 10.0 + pow(x[i], 2) - 10.0 * cos(2 * PI * x[i]);
+        }
+        return vector<double>{ -2.0 * fx };
+    });
+
+    /* Set some optional parameters. */
+    GA.population_size(100);
+    GA.crossover_rate(0.6);
+    GA.mutation_rate(0.05);
+    GA.selection_method(RCGA::SogaSelection::roulette);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.sim_binary_crossover_param(4.0);
+    GA.mutation_method(RCGA::MutationMethod::gauss);
+    GA.promotion_fraction(0.5);
+
+    GA.max_gen(1000);
+    GA.stop_condition(RCGA::StopCondition::fitness_value);
+    GA.fitness_threshold({ -0.01 });
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    recordResult("Rastrigin", "RCGA (multi-fidelity)", GA, sols, time_spent);
+
+    /* Print the results. */
+    cout << setprecision(4);
+    cout << "\n\nThe Rastrigin function with multi-fidelity evaluation (best is " << rastriginFunction.optimal_value() << "):\n";
+    cout << "Fitness value: " << sols[0].fitness[0] << "\n";
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << " (low-fidelity: " << GA.num_low_fidelity_evals()[0] << ")\n";
+    cout << "Time taken: " << time_spent << " s\n\n";
+}
+
+void realRosenbrockMemeticTest(bool lamarckian)
+{
+    /* Init GA. */
+    Rosenbrock rosenbrockFunction(10);
+
+    pair<double, double> limit = { rosenbrockFunction.lbound(), rosenbrockFunction.ubound() };
+    vector<pair<double, double>> limits(rosenbrockFunction.num_vars, limit);
+
+    RCGA GA(rosenbrockFunction.num_vars, rosenbrockFunction, limits);
+
+    /* Set some optional parameters. The 2 best candidates are refined by Nelder-Mead searches in every 10th generation. */
+    GA.population_size(100);
+    GA.crossover_rate(0.9);
+    GA.selection_method(RCGA::SogaSelection::tournament);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.mutation_method(RCGA::MutationMethod::polynomial);
+    GA.local_search_method(RCGA::LocalSearchMethod::nelder_mead);
+    GA.local_search_candidates(2);
+    GA.local_search_period(10);
+    GA.local_search_evals(1000);
+    GA.lamarckian_local_search = lamarckian;
+
+    GA.max_gen(2000);
+    GA.stop_condition(RCGA::StopCondition::fitness_evals);
+    GA.max_fitness_evals(100 * 1000);
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    const string algorithm = lamarckian ? "RCGA (Lamarckian)" : "RCGA (Baldwinian)";
+    recordResult("Rosenbrock", algorithm, GA, sols, time_spent);
+
+    /* Print the results. */
+    cout << setprecision(4);
+    cout << "\n\nThe Rosenbrock function with the " << algorithm << " (best is " << rosenbrockFunction.optimal_value() << "):\n";
+    cout << "Fitness value: " << sols[0].fitness[0] << "\n";
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
+    cout << "Time taken: " << time_spent << " s\n\n";
+}
+
+void realRastriginDeTest(RCGA::DeStrategy strategy)
+{
+    /* Init GA. */
+    Rastrigin rastriginFunction(30);
+
+    pair<double, double> limit = { rastriginFunction.lbound(), rastriginFunction.ubound() };
+    vector<pair<double, double>> limits(rastriginFunction.num_vars, limit);
+
+    RCGA GA(rastriginFunction.num_vars, rastriginFunction, limits);
+
+    /* Set some optional parameters. The genetic operators aren't used with differential evolution. */
+    GA.population_size(100);
+    GA.de_strategy(strategy);
+    GA.de_scale_factor(0.5);
+    GA.de_crossover_rate(0.9);
+
+    GA.max_gen(5000);
+    GA.stop_condition(RCGA::StopCondition::fitness_evals);
+    GA.max_fitness_evals(300 * 1000);
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    const string algorithm = (strategy == RCGA::DeStrategy::current_to_pbest) ? "DE (SHADE)" :
+                             (strategy == RCGA::DeStrategy::best_1_bin) ? "DE (best/1/bin)" : "DE (rand/1/bin)";
+    recordResult("Rastrigin", algorithm, GA, sols, time_spent);
+
+    /* Print the results. */
+    cout << setprecision(4);
+    cout << "\n\nThe Rastrigin function with " << algorithm << " (best is " << rastriginFunction.optimal_value() << "):\n";
+    cout << "Fitness value: " << sols[0].fitness[0] << "\n";
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
+    cout << "Time taken: " << time_spent << " s\n\n";
+}
+
+void realRastriginCmaEsTest(RCGA::CmaEsMode mode, RCGA::CmaEsRestart restarts)
+{
+    /* Init GA. */
+    Rastrigin rastriginFunction(10);
+
+    pair<double, double> limit = { rastriginFunction.lbound(), rastriginFunction.ubound() };
+    vector<pair<double, double>> limits(rastriginFunction.num_vars, limit);
+
+    RCGA GA(rastriginFunction.num_vars, rastriginFunction, limits);
+
+    /* Set some optional parameters. The population size is the number of children sampled in a generation (4 + 3 * ln(10)). */
+    GA.population_size(10);
+    GA.cma_es(mode);
+    GA.cma_es_restarts(restarts);
+    GA.cma_es_sigma(0.3);
+
+    GA.max_gen(100 * 1000);
+    GA.stop_condition(RCGA::StopCondition::fitness_evals);
+    GA.max_fitness_evals(200 * 1000);
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    const string algorithm = string(mode == RCGA::CmaEsMode::separable ? "sep-CMA-ES" : "CMA-ES") +
+                             (restarts == RCGA::CmaEsRestart::bipop ? " (BIPOP)" : restarts == RCGA::CmaEsRestart::ipop ? " (IPOP)" : "");
+    recordResult("Rastrigin", algorithm, GA, sols, time_spent);
+
+    /* Print the results. */
+    cout << setprecision(4);
+    cout << "\n\nThe Rastrigin function with " << algorithm << " (best is " << rastriginFunction.optimal_value() << "):\n";
+    cout << "Fitness value: " << sols[0].fitness[0] << "\n";
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << " (restarts: " << GA.cma_es_num_restarts() << ")\n";
+    cout << "Time taken: " << time_spent << " s\n\n";
+}
+
+void realSphereMutationTest(RCGA::MutationMethod method)
+{
+    /* Init GA. */
+    Sphere sphereFunction(10);
+
+    pair<double, double> limit = { sphereFunction.lbound(), sphereFunction.ubound() };
+    vector<pair<double, double>> limits(sphereFunction.num_vars, limit);
+
+    RCGA GA(sphereFunction.num_vars, sphereFunction, limits);
+
+    /* Set some optional parameters. The gauss mutation uses fixed step sizes, while the self-adaptive mutation adapts them. */
+    GA.population_size(100);
+    GA.crossover_rate(0.9);
+    GA.selection_method(RCGA::SogaSelection::tournament);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.mutation_method(method);
+    GA.gauss_mutation_param(6.0);
+
+    GA.max_gen(1000);
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    const string algorithm = (method == RCGA::MutationMethod::self_adaptive) ? "RCGA (self-adaptive mutation)" : "RCGA";
+    recordResult("Sphere", algorithm, GA, sols, time_spent);
+
+    /* Print the results. */
+    cout << setprecision(4);
+    cout << "\n\nThe sphere function with the " << algorithm << " (best is " << sphereFunction.optimal_value() << "):\n";
+    cout << "Fitness value: " << sols[0].fitness[0] << "\n";
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
+    cout << "Time taken: " << time_spent << " s\n\n";
+}
+
+void realRastriginCrossoverTest(RCGA::CrossoverMethod method)
+{
+    /* Init GA. */
+    Rastrigin rastriginFunction(10);
+
+    pair<double, double> limit = { rastriginFunction.lbound(), rastriginFunction.ubound() };
+    vector<pair<double, double>> limits(rastriginFunction.num_vars, limit);
+
+    RCGA GA(rastriginFunction.num_vars, rastriginFunction, limits);
+
+    /* Set some optional parameters. */
+    GA.population_size(100);
+    GA.crossover_rate(0.9);
+    GA.selection_method(RCGA::SogaSelection::tournament);
+    GA.crossover_method(method);
+    GA.mutation_method(RCGA::MutationMethod::polynomial);
+
+    GA.max_gen(500);
+
+    /* Run the GA with a timer. */
+    auto tbegin = chrono::high_resolution_clock::now();
+    auto sols = GA.run();
+    auto tend = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(tend - tbegin).count();
+    double time_spent = double(duration) / 1E+6;
+
+    const string algorithm = (method == RCGA::CrossoverMethod::adaptive) ? "RCGA (adaptive crossover)" : "RCGA";
+    recordResult("Rastrigin", algorithm, GA, sols, time_spent);
+
+    /* Print the results. */
+    cout << setprecision(4);
+    cout << "\n\nThe Rastrigin function with the " << algorithm << " (best is " << rastriginFunction.optimal_value() << "):\n";
+    cout << "Fitness value: " << sols[0].fitness[0] << "\n";
+    if (method == RCGA::CrossoverMethod::adaptive)
+    {
+        cout << "Final probabilities of the crossovers (arithmetic, BLX-alpha, SBX, Wright): ";
+        for (double prob : GA.crossover_probabilities()) cout << prob << "  ";
+        cout << "\n";
+    }
+    cout << "Number of fitness evals: " << GA.num_fitness_evals() << "\n";
+    cout << "Time taken: " << time_spent << " s\n\n";
+}
+
 #endif // !REAL_TESTS_H
\ No newline at end of file
@@ -0,0 +1,223 @@
+/*
+* Measures how the running time of the single- and multi-objective algorithms scales with the number of threads
+* and the population size, using cheap and expensive (SpinWork wrapped) fitness functions. \n
+* Usage: scaling [--max-pop n] [--mo-max-pop n] [--work us] [--budget evals] [--reps n] [--pipelined 0/1] \n
+*   --max-pop:    The largest population size used (default: 1000000).
+*   --mo-max-pop: The largest population size used for the NSGA-II and NSGA-III, whose sorting is quadratic in the population size (default: 10000).
+*   --work:       The extra time spent in each evaluation of the expensive fitness functions, in microseconds (default: 50).
+*   --budget:     The approximate number of fitness evaluations in each run of the expensive functions, 50 times this for the cheap ones (default: 10000).
+*                 Every run has at least 2 generations, so the budget of the cheap functions grows with the population size, while
+*                 the population sizes that don't fit in the budget of the expensive functions are skipped.
+*   --reps:       The number of repetitions of each run, the fastest one is reported (default: 1).
+*   --pipelined:  Create and evaluate the children in a single pass (GA::pipelined_breeding) if 1 (default: 0).
+*                 The eval column includes the whole pass in this case.
+* The number of threads can only be set if the standard library uses TBB for the parallel algorithms,
+* otherwise the benchmarks are only run with the default number of threads.
+*/
+
+#define GA_ENABLE_PROFILING
+
+#include "../src/real_ga.h"
+#include "fitness_functions.h"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <cstdlib>
+#include <cstddef>
+
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#define SCALING_HAS_TBB 1
+#else
+#define SCALING_HAS_TBB 0
+#endif
+
+using namespace std;
+using namespace genetic_algorithm;
+
+struct ScalingSettings
+{
+    size_t max_pop = 1000000;
+    size_t mo_max_pop = 10000;
+    double work_us = 50.0;
+    size_t budget = 10000;
+    size_t reps = 1;
+    bool pipelined = false;
+};
+
+/* The results of a single configuration. */
+struct ScalingResult
+{
+    double wall_time = 0.0;
+    size_t generations = 0;
+    RCGA::Profile profile;
+};
+
+/* The thread counts used: 1, 2, 4, ... up to the number of hardware threads (always including the number of hardware threads). */
+vector<size_t> threadCounts()
+{
+    size_t max_threads = max(thread::hardware_concurrency(), 1U);
+    if (!SCALING_HAS_TBB) return { max_threads };
+
+    vector<size_t> counts;
+    for (size_t n = 1; n < max_threads; n *= 2) counts.push_back(n);
+    counts.push_back(max_threads);
+
+    return counts;
+}
+
+template<typename F>
+ScalingResult runConfig(RCGA::Mode mode, size_t pop_size, size_t num_gens, size_t num_threads, F fitness_f, size_t num_vars, const ScalingSettings& settings)
+{
+#if SCALING_HAS_TBB
+    tbb::global_control thread_limit(tbb::global_control::max_allowed_parallelism, num_threads);
+#else
+    (void)num_threads;
+#endif
+
+    RCGA GA(num_vars, fitness_f, RCGA::limits_t(num_vars, { fitness_f.f.lbound(), fitness_f.f.ubound() }));
+    GA.mode(mode);
+    GA.population_size(pop_size);
+    GA.max_gen(num_gens);
+    GA.crossover_method(RCGA::CrossoverMethod::simulated_binary);
+    GA.mutation_method(RCGA::MutationMethod::polynomial);
+    GA.mutation_rate(1.0 / num_vars);
+    GA.pipelined_breeding = settings.pipelined;
+
+    ScalingResult best;
+    for (size_t rep = 0; rep < settings.reps; rep++)
+    {
+        GA.run();
+        if (rep == 0 || GA.profile().wall_time < best.wall_time)
+        {
+            best.wall_time = GA.profile().wall_time;
+            best.generations = GA.generation_cntr() + 1;
+            best.profile = GA.profile();
+        }
+    }
+
+    return best;
+}
+
+void printHeader()
+{
+    cout << left << setw(10) << "algorithm" << setw(14) << "fitness" << right << setw(9) << "pop" << setw(6) << "gens"
+         << setw(9) << "threads" << setw(11) << "time (s)" << setw(9) << "speedup" << setw(8) << "eff." << setw(8) << "serial"
+         << "  | phases (% of wall time): eval select cross mutate prep update other\n";
+    cout << string(160, '-') << "\n";
+}
+
+void printResult(const string& algorithm, const string& fitness, size_t pop_size, size_t threads, const ScalingResult& result, double base_time)
+{
+    using detail::Phase;
+
+    double speedup = base_time / result.wall_time;
+    double efficiency = speedup / threads;
+    /* Karp-Flatt metric, the experimentally determined serial fraction. */
+    double serial = threads > 1 ? (1.0 / speedup - 1.0 / threads) / (1.0 - 1.0 / threads) : 1.0;
+
+    const auto& profile = result.profile;
+    auto pct = [&](Phase phase) { return 100.0 * profile[phase].wall_time / profile.wall_time; };
+
+    double eval = pct(Phase::evaluate) + pct(Phase::pipelined_breeding);
+    double select = pct(Phase::selection);
+    double cross = pct(Phase::crossover);
+    double mutate = pct(Phase::mutation);
+    double prep = pct(Phase::prep_selections);
+    double update = pct(Phase::update_population);
+    double other = 100.0 - eval - select - cross - mutate - prep - update;
+
+    cout << left << setw(10) << algorithm << setw(14) << fitness << right << setw(9) << pop_size << setw(6) << result.generations
+         << setw(9) << threads << fixed << setprecision(3) << setw(11) << result.wall_time << setprecision(2) << setw(9) << speedup
+         << setw(8) << efficiency << setw(8) << (threads > 1 ? serial : 0.0) << "  | " << setprecision(1)
+         << setw(6) << eval << setw(7) << select << setw(6) << cross << setw(7) << mutate << setw(6) << prep << setw(7) << update << setw(6) << other << "\n";
+}
+
+/*
+* Runs the algorithm with the population sizes 100, 1000, ... up to max_pop, using about budget fitness evaluations, but at least 2 generations.
+* If the budget isn't scalable, the population sizes where 2 generations would be above the budget are skipped instead.
+*/
+template<typename F>
+void scaleAlgorithm(const string& algorithm, RCGA::Mode mode, const string& fitness_name, F fitness_f, size_t num_vars,
+                    size_t max_pop, size_t budget, bool scalable_budget, const ScalingSettings& settings)
+{
+    for (size_t pop_size = 100; pop_size <= max_pop; pop_size *= 10)
+    {
+        if (!scalable_budget && 2 * pop_size > budget)
+        {
+            cout << left << setw(10) << algorithm << setw(14) << fitness_name << right << setw(9) << pop_size
+                 << "  skipped, 2 generations are above the budget of " << budget << " evaluations (--budget)\n";
+            continue;
+        }
+
+        size_t num_gens = clamp(budget / pop_size, size_t{ 2 }, size_t{ 100 });
+
+        double base_time = 0.0;
+        for (size_t threads : threadCounts())
+        {
+            ScalingResult result = runConfig(mode, pop_size, num_gens, threads, fitness_f, num_vars, settings);
+            if (base_time == 0.0) base_time = result.wall_time * threads;    /* Assume linear scaling if the 1 thread run is missing. */
+
+            printResult(algorithm, fitness_name, pop_size, threads, result, base_time);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ScalingSettings settings;
+    const vector<string> options = { "--max-pop", "--mo-max-pop", "--work", "--budget", "--reps", "--pipelined" };
+    for (int i = 1; i < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (find(options.begin(), options.end(), arg) == options.end())
+        {
+            cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+        if (i + 1 == argc)
+        {
+            cerr << "Missing value for argument: " << arg << "\n";
+            return 1;
+        }
+        if (arg == "--max-pop") settings.max_pop = size_t(atoll(argv[i + 1]));
+        else if (arg == "--mo-max-pop") settings.mo_max_pop = size_t(atoll(argv[i + 1]));
+        else if (arg == "--work") settings.work_us = atof(argv[i + 1]);
+        else if (arg == "--budget") settings.budget = size_t(atoll(argv[i + 1]));
+        else if (arg == "--reps") settings.reps = max(size_t(atoll(argv[i + 1])), size_t{ 1 });
+        else if (arg == "--pipelined") settings.pipelined = atoi(argv[i + 1]) != 0;
+    }
+
+    if (!SCALING_HAS_TBB)
+    {
+        cout << "The number of threads can't be set without TBB, only the default number of threads is used.\n";
+    }
+
+    string expensive = "spin(" + to_string(size_t(settings.work_us)) + "us)";
+
+    SpinWork cheap_so(Rastrigin(10), 0.0);
+    SpinWork costly_so(Rastrigin(10), settings.work_us);
+    SpinWork cheap_mo(DTLZ2(12, 3), 0.0);
+    SpinWork costly_mo(DTLZ2(12, 3), settings.work_us);
+
+    size_t cheap_budget = 50 * settings.budget;
+    size_t mo_max_pop = min(settings.max_pop, settings.mo_max_pop);
+
+    printHeader();
+
+    scaleAlgorithm("SOGA", RCGA::Mode::single_objective, "Rastrigin", cheap_so, 10, settings.max_pop, cheap_budget, true, settings);
+    scaleAlgorithm("SOGA", RCGA::Mode::single_objective, expensive, costly_so, 10, settings.max_pop, settings.budget, false, settings);
+
+    scaleAlgorithm("NSGA-II", RCGA::Mode::multi_objective_sorting, "DTLZ2", cheap_mo, 12, mo_max_pop, cheap_budget, true, settings);
+    scaleAlgorithm("NSGA-II", RCGA::Mode::multi_objective_sorting, expensive, costly_mo, 12, mo_max_pop, settings.budget, false, settings);
+
+    scaleAlgorithm("NSGA-III", RCGA::Mode::multi_objective_decomp, "DTLZ2", cheap_mo, 12, mo_max_pop, cheap_budget, true, settings);
+    scaleAlgorithm("NSGA-III", RCGA::Mode::multi_objective_decomp, expensive, costly_mo, 12, mo_max_pop, settings.budget, false, settings);
+
+    return 0;
+}
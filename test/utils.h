@@ -9,6 +9,7 @@
 #include <iomanip>
 
 #include "../src/base_ga.h"
+#include "bench_record.h"
 
 using namespace genetic_algorithm;
 